@@ -10,26 +10,91 @@
 * Header files.
 ***************************************************************************************************/
 
+/* Log module of this file, defined before debug_logger.h is included */
+#define DBG_MODULE LOG_MODULE_HW_EEPROM
+
 #include <Arduino.h>
 #include "HW_eeprom.h"
 #include "EEPROM.h"
 #include "debug_logger.h"
+#include "debug_trace.h"
 
 /***************************************************************************************************
 * Macro definitions.
 ***************************************************************************************************/
 
-#define MAGIC_NUMBER_VAL ((uint16_t)0xdeadU)
-#define MAGIC_NUMBER_ADRS (0U)
-#define MAGIC_NUMBER_SIZE (2U)
-#define CHECKSUM_ADRS (MAGIC_NUMBER_ADRS + MAGIC_NUMBER_SIZE + 1U)
-#define CHECKSUM_SIZE (2U)
-#define DATA_START_ADRS (CHECKSUM_SIZE + CHECKSUM_ADRS + 1U)
+/* Single copy layout used before the A/B slots, only read to migrate old data */
+#define LEGACY_MAGIC_NUMBER_VAL ((uint16_t)0xdeadU)
+#define LEGACY_MAGIC_NUMBER_ADRS (0U)
+#define LEGACY_CHECKSUM_ADRS (3U)
+
+#define DATA_START_ADRS (EEPROM_DATA_START_ADRS)
+
+/* Both slot headers first, then the key-value area, then the data of slot A and slot B.
+   The key-value area and slot A do not move when the data size grows */
+#define SLOT_MAGIC_NUMBER_VAL ((uint16_t)0xab5cU)
+#define SLOT_COUNT (2U)
+#define NO_SLOT (0xFFU)
+#define SLOT_HEADER_SIZE (sizeof(slot_header_t))
+#define SLOT_HEADER_ADRS(slot) ((slot) * SLOT_HEADER_SIZE)
+#define SLOT_DATA_ADRS_OF_SIZE(slot, size) (KV_AREA_END_ADRS + ((slot) * (size)))
+#define SLOT_DATA_ADRS(slot) (SLOT_DATA_ADRS_OF_SIZE((slot), g_allocated_data_size))
+#define COPY_CHUNK_SIZE (32U)
+
+/* Background commit task */
+#define COMMIT_TASK_NAME "eeprom_commit"
+#define COMMIT_TASK_STACK_SIZE (3072U)
+#define COMMIT_TASK_PRIORITY (tskIDLE_PRIORITY + 1U)
+
+/* Key-value area, placed right after the slot headers */
+#define KV_MAGIC_NUMBER_VAL ((uint16_t)0x4b57U)
+#define KV_MAGIC_NUMBER_SIZE (2U)
+#define KV_AREA_ADRS (SLOT_COUNT * SLOT_HEADER_SIZE)
+#define KV_RECORDS_ADRS (KV_AREA_ADRS + KV_MAGIC_NUMBER_SIZE)
+#define KV_AREA_END_ADRS (KV_AREA_ADRS + EEPROM_KV_AREA_SIZE)
+#define KV_HEADER_SIZE (sizeof(kv_record_header_t))
+#define KV_KEY_END ((uint16_t)0xFFFFU)
+#define KV_KEY_DELETED ((uint16_t)0xFFFEU)
+#define KV_NO_RECORD (0U)
+#define KV_FLAG_RLE ((uint16_t)0x0001U)
+#define CRC16_INIT_VAL ((uint16_t)0xFFFFU)
+
+/* PackBits style run length coding: a control byte 0..127 is followed by 1..128 literal bytes,
+ * a control byte 129..255 is followed by one byte repeated 2..128 times */
+#define RLE_MAX_RUN (128U)
+#define RLE_MIN_REPEAT (3U)
 
 /***************************************************************************************************
 * Local type definitions.
 ***************************************************************************************************/
-uint16_t g_magic_number = 0x00U;
+
+typedef struct slot_header_t_struct
+{
+    uint16_t magic;
+    uint16_t header_crc;    /* CRC of the fields below, catches a torn header write */
+    uint32_t sequence;      /* Incremented on every write, the newest valid slot is active */
+    uint32_t data_size;
+    uint16_t data_crc;
+    uint16_t reserved;
+} slot_header_t;
+
+typedef struct kv_record_header_t_struct
+{
+    uint16_t key;
+    uint16_t capacity;
+    uint16_t length;        /* Stored bytes */
+    uint16_t crc;           /* CRC of the stored bytes */
+    uint16_t raw_length;    /* Bytes after decompression, equal to length if the record is not compressed */
+    uint16_t flags;
+} kv_record_header_t;
+
+typedef struct rle_writer_t_struct
+{
+    uint32_t adrs;          /* EEPROM address of the output, KV_NO_RECORD to only count the output size */
+    uint16_t size;
+    uint16_t crc;
+} rle_writer_t;
+
 uint32_t g_allocated_data_size = 0U;
 /***************************************************************************************************
  * Local data definitions.
@@ -37,61 +102,737 @@ uint32_t g_allocated_data_size = 0U;
 
 static bool is_eeprom_init = false;
 
+/* RAM image of the EEPROM kept by the EEPROM library, reads are served from it */
+static const uint8_t * s_ptr_shadow = NULL;
+static uint8_t s_active_slot = NO_SLOT;
+static uint32_t s_active_sequence = 0U;
+/* Slot holding the written but not yet committed data, NO_SLOT if there is none */
+static uint8_t s_pending_slot = NO_SLOT;
+static data_validity_t s_data_validity = DATA_INVALID;
+static bool s_is_data_dirty = true;
+static eeprom_stats_t s_stats = {0U, 0U, 0U, 0U, 0U, 0U};
+
+static SemaphoreHandle_t s_eeprom_mutex = NULL;
+static TaskHandle_t s_commit_task_hnd = NULL;
+static bool s_is_async_commit = false;
+static bool s_is_commit_pending = false;
+static TickType_t s_quiet_period_ticks = 0U;
+static volatile TickType_t s_last_write_tick = 0U;
+
+/* Offset of every record header in the EEPROM, indexed by key */
+static uint32_t s_kv_index[EEPROM_KV_MAX_KEYS];
+/* Offset of the first free byte after the last record */
+static uint32_t s_kv_free_adrs = 0U;
+/* Set once the CRC of a record has been checked, cleared when the record changes */
+static bool s_kv_is_validated[EEPROM_KV_MAX_KEYS];
+/* Number of stream writes in progress, the records must not move while it is not 0 */
+static uint8_t s_kv_open_streams = 0U;
+/* Bumped when the open streams are abandoned, a stream begun in an older generation is closed */
+static uint32_t s_kv_stream_generation = 0U;
+/* Tick of the last begin or chunk of any stream write */
+static TickType_t s_kv_stream_tick = 0U;
+/* Number of views handed out and not released yet, the records must not move while it is not 0 */
+static uint16_t s_kv_held_views = 0U;
+
+static const uint16_t s_crc16_table[16] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50a5U, 0x60c6U, 0x70e7U,
+    0x8108U, 0x9129U, 0xa14aU, 0xb16bU, 0xc18cU, 0xd1adU, 0xe1ceU, 0xf1efU
+};
+
 /***************************************************************************************************
 * Local function definitions.
 ***************************************************************************************************/
 
-static uint16_t calculate_checksum(const uint8_t * p_ptr_data_buffer, uint32_t p_data_size)
+static uint16_t fold_checksum(uint32_t p_sum)
 {
-    uint32_t sum = 0;
+    // Add the carry bits to the sum
+    while (p_sum >> 16)
+    {
+        p_sum = (p_sum & 0xFFFF) + (p_sum >> 16);
+    }
+
+    // Return the one's complement of the sum
+    return (uint16_t)(~p_sum);
+}
 
-    // Sum all the bytes
-    for (size_t i = 0; i < p_data_size; i++)
+/**
+ * @brief CRC-16/CCITT with a nibble table, can be chained over several buffers.
+ */
+static uint16_t calculate_crc16(uint16_t p_crc, const uint8_t * p_ptr_data_buffer, uint32_t p_data_size)
+{
+    for (uint32_t i = 0; i < p_data_size; i++)
     {
-        sum += p_ptr_data_buffer[i];
+        p_crc = (uint16_t)((p_crc << 4) ^ s_crc16_table[(p_crc >> 12) ^ (p_ptr_data_buffer[i] >> 4)]);
+        p_crc = (uint16_t)((p_crc << 4) ^ s_crc16_table[(p_crc >> 12) ^ (p_ptr_data_buffer[i] & 0x0FU)]);
     }
+    return p_crc;
+}
 
-    // Add the carry bits to the sum
-    while (sum >> 16)
+static void slot_read_header(uint8_t p_slot, slot_header_t * p_ptr_header)
+{
+    EEPROM.readBytes(SLOT_HEADER_ADRS(p_slot), p_ptr_header, SLOT_HEADER_SIZE);
+}
+
+static uint16_t slot_calculate_header_crc(const slot_header_t * p_ptr_header)
+{
+    return calculate_crc16(CRC16_INIT_VAL, (const uint8_t *)&p_ptr_header->sequence,
+                           SLOT_HEADER_SIZE - offsetof(slot_header_t, sequence));
+}
+
+static bool is_slot_header_intact(const slot_header_t * p_ptr_header)
+{
+    return (SLOT_MAGIC_NUMBER_VAL == p_ptr_header->magic &&
+            p_ptr_header->header_crc == slot_calculate_header_crc(p_ptr_header));
+}
+
+static bool is_slot_header_valid(const slot_header_t * p_ptr_header)
+{
+    return (true == is_slot_header_intact(p_ptr_header) && g_allocated_data_size == p_ptr_header->data_size);
+}
+
+/**
+ * @brief Picks the slot with the newest valid header, the data itself is not read here.
+ */
+static void select_active_slot(void)
+{
+    slot_header_t header;
+    s_active_slot = NO_SLOT;
+    for (uint8_t i = 0; i < SLOT_COUNT; i++)
     {
-        sum = (sum & 0xFFFF) + (sum >> 16);
+        slot_read_header(i, &header);
+        if (true == is_slot_header_valid(&header) &&
+            (NO_SLOT == s_active_slot || (int32_t)(header.sequence - s_active_sequence) > 0))
+        {
+            s_active_slot = i;
+            s_active_sequence = header.sequence;
+        }
     }
+    s_is_data_dirty = true;
+}
 
-    // Return the one's complement of the sum
-    return (uint16_t)(~sum);
+/**
+ * @brief Tells if the legacy checksum matches the data. The single copy layout only summed the
+ *        bytes of the last write, which was the data from the start up to an unknown size in
+ *        practice, so every size is tried.
+ */
+static bool is_legacy_checksum_valid(void)
+{
+    uint16_t checksum = EEPROM.readUShort(LEGACY_CHECKSUM_ADRS);
+    uint32_t sum = 0U;
+    bool ret_val = false;
+
+    for (uint32_t i = 0; i < g_allocated_data_size && false == ret_val; i++)
+    {
+        sum += s_ptr_shadow[DATA_START_ADRS + i];
+        ret_val = (checksum == fold_checksum(sum));
+    }
+    return ret_val;
 }
 
-static uint16_t read_magic_number(void)
+/**
+ * @brief Moves data written by the single copy layout into slot A.
+ *        Slot A starts after the old data start, so the data is copied from its end.
+ *        The data is migrated even if the legacy checksum does not match, as the checksum
+ *        may cover a write that did not start at the data start. The mismatch is logged.
+ */
+static bool migrate_single_copy_layout(void)
 {
-    if (g_magic_number == 0x00U)
+    bool ret_val = false;
+    uint8_t chunk[COPY_CHUNK_SIZE];
+    uint32_t remaining = g_allocated_data_size;
+    uint32_t chunk_size = 0U;
+    slot_header_t header = {0U, 0U, 0U, 0U, 0U, 0U};
+
+    if (LEGACY_MAGIC_NUMBER_VAL == EEPROM.readUShort(LEGACY_MAGIC_NUMBER_ADRS))
     {
-        g_magic_number = EEPROM.readUShort(MAGIC_NUMBER_ADRS);
+        if (true == is_legacy_checksum_valid())
+        {
+            logger_d("Migrating single copy data to slot A\n");
+        }
+        else
+        {
+            logger_w("Single copy data migrated to slot A without a matching checksum\n");
+        }
+        while (remaining > 0U)
+        {
+            chunk_size = (remaining < COPY_CHUNK_SIZE) ? remaining : COPY_CHUNK_SIZE;
+            remaining -= chunk_size;
+            memcpy(chunk, &s_ptr_shadow[DATA_START_ADRS + remaining], chunk_size);
+            EEPROM.writeBytes(SLOT_DATA_ADRS(0U) + remaining, chunk, chunk_size);
+        }
+        EEPROM.writeBytes(SLOT_HEADER_ADRS(1U), &header, SLOT_HEADER_SIZE);
+        header.magic = SLOT_MAGIC_NUMBER_VAL;
+        header.sequence = 1U;
+        header.data_size = g_allocated_data_size;
+        header.data_crc = calculate_crc16(CRC16_INIT_VAL, &s_ptr_shadow[SLOT_DATA_ADRS(0U)], g_allocated_data_size);
+        header.header_crc = slot_calculate_header_crc(&header);
+        EEPROM.writeBytes(SLOT_HEADER_ADRS(0U), &header, SLOT_HEADER_SIZE);
+        ret_val = EEPROM.commit();
     }
-    return g_magic_number;
+    return ret_val;
 }
 
-static bool write_magic_number(void)
+/**
+ * @brief Finds the newest slot saved with a smaller data size whose data matches its CRC.
+ * @return The slot, NO_SLOT if there is none
+ */
+static uint8_t find_smaller_slot(slot_header_t * p_ptr_header)
 {
-    EEPROM.writeUShort(MAGIC_NUMBER_ADRS, MAGIC_NUMBER_VAL);
-    return EEPROM.commit();
+    slot_header_t header;
+    uint8_t found_slot = NO_SLOT;
+
+    for (uint8_t i = 0; i < SLOT_COUNT; i++)
+    {
+        slot_read_header(i, &header);
+        if (true == is_slot_header_intact(&header) && header.data_size < g_allocated_data_size &&
+            (NO_SLOT == found_slot || (int32_t)(header.sequence - p_ptr_header->sequence) > 0) &&
+            header.data_crc == calculate_crc16(CRC16_INIT_VAL, &s_ptr_shadow[SLOT_DATA_ADRS_OF_SIZE(i, header.data_size)],
+                                               header.data_size))
+        {
+            found_slot = i;
+            *p_ptr_header = header;
+        }
+    }
+    return found_slot;
+}
+
+/**
+ * @brief Moves data saved by a firmware with a smaller data size, e.g. with fewer config sections,
+ *        into slot A of the current size. The bytes after the old data are zeroed, so the new sections
+ *        read as empty. Slot A does not move and slot B only moves up, so the data is copied from its start.
+ */
+static bool migrate_smaller_data_size(void)
+{
+    bool ret_val = false;
+    uint8_t chunk[COPY_CHUNK_SIZE];
+    uint32_t src_adrs = 0U;
+    uint32_t chunk_size = 0U;
+    slot_header_t header = {0U, 0U, 0U, 0U, 0U, 0U};
+    uint8_t slot = find_smaller_slot(&header);
+
+    if (NO_SLOT != slot)
+    {
+        logger_i("Data of %d bytes migrated to a data size of %d bytes\n", header.data_size, g_allocated_data_size);
+        src_adrs = SLOT_DATA_ADRS_OF_SIZE(slot, header.data_size);
+        for (uint32_t offset = 0U; offset < header.data_size; offset += chunk_size)
+        {
+            chunk_size = ((header.data_size - offset) < COPY_CHUNK_SIZE) ? (header.data_size - offset) : COPY_CHUNK_SIZE;
+            memcpy(chunk, &s_ptr_shadow[src_adrs + offset], chunk_size);
+            EEPROM.writeBytes(SLOT_DATA_ADRS(0U) + offset, chunk, chunk_size);
+        }
+        memset(chunk, 0, sizeof(chunk));
+        for (uint32_t offset = header.data_size; offset < g_allocated_data_size; offset += chunk_size)
+        {
+            chunk_size = ((g_allocated_data_size - offset) < COPY_CHUNK_SIZE) ? (g_allocated_data_size - offset) :
+                                                                                 COPY_CHUNK_SIZE;
+            EEPROM.writeBytes(SLOT_DATA_ADRS(0U) + offset, chunk, chunk_size);
+        }
+        header.sequence++;
+        header.data_size = g_allocated_data_size;
+        header.data_crc = calculate_crc16(CRC16_INIT_VAL, &s_ptr_shadow[SLOT_DATA_ADRS(0U)], g_allocated_data_size);
+        header.reserved = 0U;
+        header.header_crc = slot_calculate_header_crc(&header);
+        EEPROM.writeBytes(SLOT_HEADER_ADRS(0U), &header, SLOT_HEADER_SIZE);
+        memset(&header, 0, sizeof(header));
+        EEPROM.writeBytes(SLOT_HEADER_ADRS(1U), &header, SLOT_HEADER_SIZE);
+        ret_val = EEPROM.commit();
+    }
+    return ret_val;
+}
+
+static bool is_data_range_valid(uint32_t p_data_size, uint32_t p_starting_address)
+{
+    return (0U != p_data_size && p_starting_address >= DATA_START_ADRS &&
+            (p_starting_address + p_data_size) <= (DATA_START_ADRS + g_allocated_data_size));
+}
+
+/**
+ * @brief Checks the data of the active slot against its CRC, only when it is dirty.
+ *        Falls back to the older slot if the newest one is corrupted.
+ *        The result is cached so later reads do not check again.
+ */
+static data_validity_t validate_data(void)
+{
+    slot_header_t header;
+    uint8_t other_slot = NO_SLOT;
+
+    if (true == s_is_data_dirty && NULL != s_ptr_shadow)
+    {
+        s_data_validity = DATA_INVALID;
+        for (uint8_t i = 0; i < SLOT_COUNT && NO_SLOT != s_active_slot && DATA_INVALID == s_data_validity; i++)
+        {
+            slot_read_header(s_active_slot, &header);
+            s_stats.bytes_checksummed += g_allocated_data_size;
+            if (header.data_crc == calculate_crc16(CRC16_INIT_VAL, &s_ptr_shadow[SLOT_DATA_ADRS(s_active_slot)],
+                                                   g_allocated_data_size))
+            {
+                s_data_validity = DATA_VALID;
+            }
+            else
+            {
+                logger_d("Data of slot %d is corrupted\n", s_active_slot);
+                other_slot = (uint8_t)(SLOT_COUNT - 1U - s_active_slot);
+                slot_read_header(other_slot, &header);
+                s_active_slot = (true == is_slot_header_valid(&header)) ? other_slot : NO_SLOT;
+                s_active_sequence = header.sequence;
+            }
+        }
+        s_is_data_dirty = false;
+    }
+    return s_data_validity;
+}
+
+static void eeprom_lock(void)
+{
+    if (NULL != s_eeprom_mutex)
+    {
+        xSemaphoreTakeRecursive(s_eeprom_mutex, portMAX_DELAY);
+    }
+}
+
+static void eeprom_unlock(void)
+{
+    if (NULL != s_eeprom_mutex)
+    {
+        xSemaphoreGiveRecursive(s_eeprom_mutex);
+    }
+}
+
+/**
+ * @brief Returns the slot the reads are served from, the pending slot holds the newest data.
+ */
+static uint8_t current_data_slot(void)
+{
+    uint8_t slot = s_pending_slot;
+    if (NO_SLOT == slot && DATA_VALID == validate_data())
+    {
+        slot = s_active_slot;
+    }
+    return slot;
+}
+
+/**
+ * @brief Returns the slot the writes go to, the active slot is copied into it on the first write.
+ */
+static uint8_t begin_slot_update(void)
+{
+    if (NO_SLOT == s_pending_slot)
+    {
+        s_pending_slot = 0U;
+        if (DATA_VALID == validate_data())
+        {
+            s_pending_slot = (uint8_t)(SLOT_COUNT - 1U - s_active_slot);
+            EEPROM.writeBytes(SLOT_DATA_ADRS(s_pending_slot), &s_ptr_shadow[SLOT_DATA_ADRS(s_active_slot)],
+                              g_allocated_data_size);
+        }
+    }
+    return s_pending_slot;
+}
+
+/**
+ * @brief Commits everything written since the last commit.
+ *        The pending slot data and its header go to the flash in one commit. The NVS blob commit
+ *        is atomic, and if the data is torn anyway its CRC fails and the previous slot stays active.
+ *        On failure the changes stay pending for a retry.
+ */
+static bool commit_pending(void)
+{
+    bool ret_val = false;
+    slot_header_t header;
+    TRACE_SCOPE("eeprom_commit");
+
+    if (NO_SLOT != s_pending_slot)
+    {
+        header.magic = SLOT_MAGIC_NUMBER_VAL;
+        header.sequence = s_active_sequence + 1U;
+        header.data_size = g_allocated_data_size;
+        header.data_crc = calculate_crc16(CRC16_INIT_VAL, &s_ptr_shadow[SLOT_DATA_ADRS(s_pending_slot)],
+                                          g_allocated_data_size);
+        header.reserved = 0U;
+        header.header_crc = slot_calculate_header_crc(&header);
+        s_stats.bytes_checksummed += g_allocated_data_size;
+
+        EEPROM.writeBytes(SLOT_HEADER_ADRS(s_pending_slot), &header, SLOT_HEADER_SIZE);
+        ret_val = EEPROM.commit();
+        if (true == ret_val)
+        {
+            s_active_slot = s_pending_slot;
+            s_active_sequence = header.sequence;
+            s_pending_slot = NO_SLOT;
+            s_data_validity = DATA_VALID;
+            s_is_data_dirty = false;
+        }
+    }
+    else
+    {
+        /* Only key-value records changed */
+        ret_val = EEPROM.commit();
+    }
+
+    s_stats.commit_count++;
+    if (true == ret_val)
+    {
+        s_is_commit_pending = false;
+    }
+    else
+    {
+        logger_d("Commit failed\n");
+    }
+    return ret_val;
+}
+
+/**
+ * @brief Commits right away, or hands the commit to the background task in async mode.
+ */
+static bool request_commit(void)
+{
+    bool ret_val = true;
+
+    s_stats.write_count++;
+    /* In sync mode a commit still pending has failed, the write retries it rather than joining it */
+    if (true == s_is_async_commit && true == s_is_commit_pending)
+    {
+        s_stats.coalesced_write_count++;
+    }
+    s_is_commit_pending = true;
+    if (true == s_is_async_commit)
+    {
+        s_last_write_tick = xTaskGetTickCount();
+        xTaskNotifyGive(s_commit_task_hnd);
+    }
+    else
+    {
+        ret_val = commit_pending();
+    }
+    return ret_val;
+}
+
+/**
+ * @brief Waits until no write happened for the quiet period, then commits all of them at once.
+ */
+static void commit_task(void * p_ptr_param)
+{
+    TickType_t idle_ticks = 0U;
+    (void)p_ptr_param;
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        do
+        {
+            idle_ticks = xTaskGetTickCount() - s_last_write_tick;
+            if (idle_ticks < s_quiet_period_ticks)
+            {
+                vTaskDelay(s_quiet_period_ticks - idle_ticks);
+            }
+        } while (idle_ticks < s_quiet_period_ticks);
+
+        eeprom_lock();
+        if (true == s_is_commit_pending && false == commit_pending())
+        {
+            /* Try again after another quiet period */
+            s_last_write_tick = xTaskGetTickCount();
+            xTaskNotifyGive(s_commit_task_hnd);
+        }
+        eeprom_unlock();
+    }
+}
+
+static void kv_write_header(uint32_t p_adrs, const kv_record_header_t * p_ptr_header)
+{
+    EEPROM.writeBytes(p_adrs, p_ptr_header, KV_HEADER_SIZE);
+}
+
+static void kv_read_header(uint32_t p_adrs, kv_record_header_t * p_ptr_header)
+{
+    EEPROM.readBytes(p_adrs, p_ptr_header, KV_HEADER_SIZE);
+}
+
+/**
+ * @brief Terminates the record list at the given address if a header still fits in the area.
+ */
+static void kv_write_end_marker(uint32_t p_adrs)
+{
+    kv_record_header_t header = {KV_KEY_END, 0U, 0U, 0U, 0U, 0U};
+    if ((p_adrs + KV_HEADER_SIZE) <= KV_AREA_END_ADRS)
+    {
+        kv_write_header(p_adrs, &header);
+    }
+}
+
+/**
+ * @brief Moves the live records down over the deleted ones, in the RAM image only.
+ */
+static void kv_compact(void)
+{
+    kv_record_header_t header;
+    uint8_t chunk[COPY_CHUNK_SIZE];
+    uint32_t read_adrs = KV_RECORDS_ADRS;
+    uint32_t write_adrs = KV_RECORDS_ADRS;
+    uint32_t record_size = 0U;
+    uint32_t chunk_size = 0U;
+
+    while (read_adrs < s_kv_free_adrs)
+    {
+        kv_read_header(read_adrs, &header);
+        record_size = KV_HEADER_SIZE + header.capacity;
+        if (header.key < EEPROM_KV_MAX_KEYS && s_kv_index[header.key] == read_adrs)
+        {
+            /* The destination is below the source, so copying from the start is safe */
+            for (uint32_t copied = 0U; copied < record_size && write_adrs != read_adrs; copied += chunk_size)
+            {
+                chunk_size = ((record_size - copied) < COPY_CHUNK_SIZE) ? (record_size - copied) : COPY_CHUNK_SIZE;
+                memcpy(chunk, &s_ptr_shadow[read_adrs + copied], chunk_size);
+                EEPROM.writeBytes(write_adrs + copied, chunk, chunk_size);
+            }
+            s_kv_index[header.key] = write_adrs;
+            write_adrs += record_size;
+        }
+        read_adrs += record_size;
+    }
+    logger_d("KV area compacted, %d bytes freed\n", s_kv_free_adrs - write_adrs);
+    s_kv_free_adrs = write_adrs;
+    kv_write_end_marker(s_kv_free_adrs);
+}
+
+/**
+ * @brief Abandons the open stream writes. Their reserved records stay marked as deleted, so the next
+ *        compaction reclaims them, and their owners fail on the next chunk or end.
+ */
+static void kv_abandon_streams(void)
+{
+    if (0U != s_kv_open_streams)
+    {
+        logger_w("%d stream writes abandoned\n", s_kv_open_streams);
+        s_kv_open_streams = 0U;
+    }
+    s_kv_stream_generation++;
+}
+
+static bool kv_is_stream_open(const eeprom_stream_t * p_ptr_stream)
+{
+    return (KV_NO_RECORD != p_ptr_stream->record_adrs && s_kv_stream_generation == p_ptr_stream->generation);
+}
+
+/**
+ * @brief Claims space for a new record at the end of the area, compacting the area if needed.
+ *        The open streams block the compaction unless none of them wrote for EEPROM_STREAM_TIMEOUT_MS.
+ *        The held views always block it, they point into the records.
+ *        The claimed record is marked as deleted until its owner writes the real header.
+ */
+static uint32_t kv_reserve(uint16_t p_capacity)
+{
+    uint32_t adrs = KV_NO_RECORD;
+    kv_record_header_t header = {KV_KEY_DELETED, p_capacity, 0U, 0U, 0U, 0U};
+
+    if ((s_kv_free_adrs + KV_HEADER_SIZE + p_capacity) > KV_AREA_END_ADRS && 0U != s_kv_open_streams &&
+        (xTaskGetTickCount() - s_kv_stream_tick) >= pdMS_TO_TICKS(EEPROM_STREAM_TIMEOUT_MS))
+    {
+        kv_abandon_streams();
+    }
+    if ((s_kv_free_adrs + KV_HEADER_SIZE + p_capacity) > KV_AREA_END_ADRS && 0U == s_kv_open_streams &&
+        0U == s_kv_held_views)
+    {
+        kv_compact();
+    }
+    if ((s_kv_free_adrs + KV_HEADER_SIZE + p_capacity) <= KV_AREA_END_ADRS)
+    {
+        adrs = s_kv_free_adrs;
+        kv_write_header(adrs, &header);
+        s_kv_free_adrs += KV_HEADER_SIZE + p_capacity;
+        kv_write_end_marker(s_kv_free_adrs);
+    }
+    return adrs;
+}
+
+/**
+ * @brief Publishes a record written at p_adrs under its key, and retires the previous record of the key.
+ */
+static bool kv_publish(uint32_t p_adrs, const kv_record_header_t * p_ptr_header)
+{
+    uint32_t old_adrs = s_kv_index[p_ptr_header->key];
+
+    kv_write_header(p_adrs, p_ptr_header);
+    if (KV_NO_RECORD != old_adrs && old_adrs != p_adrs)
+    {
+        EEPROM.writeUShort(old_adrs, KV_KEY_DELETED);
+    }
+    s_kv_index[p_ptr_header->key] = p_adrs;
+    s_kv_is_validated[p_ptr_header->key] = true;
+    return request_commit();
+}
+
+static void rle_emit(rle_writer_t * p_ptr_writer, const uint8_t * p_ptr_data, uint16_t p_data_size)
+{
+    if (KV_NO_RECORD != p_ptr_writer->adrs)
+    {
+        EEPROM.writeBytes(p_ptr_writer->adrs + p_ptr_writer->size, p_ptr_data, p_data_size);
+        p_ptr_writer->crc = calculate_crc16(p_ptr_writer->crc, p_ptr_data, p_data_size);
+    }
+    p_ptr_writer->size += p_data_size;
+}
+
+static void rle_emit_literals(rle_writer_t * p_ptr_writer, const uint8_t * p_ptr_data, uint32_t p_data_size)
+{
+    uint8_t control = 0U;
+    uint32_t chunk_size = 0U;
+    while (p_data_size > 0U)
+    {
+        chunk_size = (p_data_size < RLE_MAX_RUN) ? p_data_size : RLE_MAX_RUN;
+        control = (uint8_t)(chunk_size - 1U);
+        rle_emit(p_ptr_writer, &control, 1U);
+        rle_emit(p_ptr_writer, p_ptr_data, (uint16_t)chunk_size);
+        p_ptr_data += chunk_size;
+        p_data_size -= chunk_size;
+    }
+}
+
+/**
+ * @brief Compresses p_ptr_data into the writer, runs shorter than RLE_MIN_REPEAT stay literals.
+ */
+static void rle_encode(rle_writer_t * p_ptr_writer, const uint8_t * p_ptr_data, uint32_t p_data_size)
+{
+    uint32_t literal_start = 0U;
+    uint32_t i = 0U;
+    uint32_t run = 0U;
+    uint8_t token[2];
+
+    while (i < p_data_size)
+    {
+        run = 1U;
+        while ((i + run) < p_data_size && run < RLE_MAX_RUN && p_ptr_data[i + run] == p_ptr_data[i])
+        {
+            run++;
+        }
+        if (run >= RLE_MIN_REPEAT)
+        {
+            rle_emit_literals(p_ptr_writer, &p_ptr_data[literal_start], i - literal_start);
+            token[0] = (uint8_t)(257U - run);
+            token[1] = p_ptr_data[i];
+            rle_emit(p_ptr_writer, token, 2U);
+            i += run;
+            literal_start = i;
+        }
+        else
+        {
+            i += run;
+        }
+    }
+    rle_emit_literals(p_ptr_writer, &p_ptr_data[literal_start], p_data_size - literal_start);
+}
+
+/**
+ * @brief Decompresses p_ptr_src into p_ptr_dst.
+ * @retval The number of decompressed bytes, 0 if the input is malformed or does not fit
+ */
+static uint32_t rle_decode(const uint8_t * p_ptr_src, uint32_t p_src_size, uint8_t * p_ptr_dst, uint32_t p_dst_size)
+{
+    uint32_t in = 0U;
+    uint32_t out = 0U;
+    uint32_t count = 0U;
+    bool is_valid = true;
+
+    while (in < p_src_size && true == is_valid)
+    {
+        if (p_ptr_src[in] < RLE_MAX_RUN)
+        {
+            count = (uint32_t)p_ptr_src[in] + 1U;
+            is_valid = ((in + 1U + count) <= p_src_size && (out + count) <= p_dst_size);
+            if (true == is_valid)
+            {
+                memcpy(&p_ptr_dst[out], &p_ptr_src[in + 1U], count);
+            }
+            in += 1U + count;
+        }
+        else
+        {
+            count = 257U - (uint32_t)p_ptr_src[in];
+            is_valid = (p_ptr_src[in] != RLE_MAX_RUN && (in + 2U) <= p_src_size && (out + count) <= p_dst_size);
+            if (true == is_valid)
+            {
+                memset(&p_ptr_dst[out], p_ptr_src[in + 1U], count);
+            }
+            in += 2U;
+        }
+        out += count;
+    }
+    return (true == is_valid) ? out : 0U;
 }
 
-static bool is_magic_number_valid(void)
+/**
+ * @brief Returns the stored bytes of a record after checking its CRC once.
+ */
+static const uint8_t * kv_get_stored_data(uint16_t p_key, kv_record_header_t * p_ptr_header)
 {
-    return (MAGIC_NUMBER_VAL == read_magic_number());
+    const uint8_t * ret_ptr = NULL;
+
+    if (p_key < EEPROM_KV_MAX_KEYS && KV_NO_RECORD != s_kv_index[p_key] && NULL != s_ptr_shadow)
+    {
+        kv_read_header(s_kv_index[p_key], p_ptr_header);
+        ret_ptr = &s_ptr_shadow[s_kv_index[p_key] + KV_HEADER_SIZE];
+        if (false == s_kv_is_validated[p_key])
+        {
+            s_kv_is_validated[p_key] = (p_ptr_header->crc == calculate_crc16(CRC16_INIT_VAL, ret_ptr, p_ptr_header->length));
+            s_stats.bytes_checksummed += p_ptr_header->length;
+        }
+        if (false == s_kv_is_validated[p_key])
+        {
+            logger_d("CRC of key %d is invalid\n", p_key);
+            ret_ptr = NULL;
+        }
+    }
+    return ret_ptr;
 }
 
-static bool write_checksum(uint16_t p_checksum)
+static bool kv_format_area(void)
 {
-    EEPROM.writeUShort(CHECKSUM_ADRS, p_checksum);
+    EEPROM.writeUShort(KV_AREA_ADRS, KV_MAGIC_NUMBER_VAL);
+    kv_write_end_marker(KV_RECORDS_ADRS);
+    s_kv_free_adrs = KV_RECORDS_ADRS;
     return EEPROM.commit();
 }
 
-static uint16_t read_checksum(void)
+/**
+ * @brief Walks the record headers once and fills the RAM index, payloads are not touched.
+ */
+static bool kv_build_index(void)
 {
-    uint16_t checksum = 0U;
-    checksum = EEPROM.readUShort(CHECKSUM_ADRS);
-    return checksum;
+    bool ret_val = true;
+    kv_record_header_t header;
+    uint32_t adrs = KV_RECORDS_ADRS;
+
+    for (uint16_t i = 0; i < EEPROM_KV_MAX_KEYS; i++)
+    {
+        s_kv_index[i] = KV_NO_RECORD;
+        s_kv_is_validated[i] = false;
+    }
+
+    if (KV_MAGIC_NUMBER_VAL != EEPROM.readUShort(KV_AREA_ADRS))
+    {
+        logger_d("KV area is not formatted\n");
+        ret_val = kv_format_area();
+    }
+    else
+    {
+        while ((adrs + KV_HEADER_SIZE) <= KV_AREA_END_ADRS)
+        {
+            kv_read_header(adrs, &header);
+            if (KV_KEY_END == header.key ||
+                (adrs + KV_HEADER_SIZE + header.capacity) > KV_AREA_END_ADRS ||
+                header.length > header.capacity)
+            {
+                break;
+            }
+            if (header.key < EEPROM_KV_MAX_KEYS)
+            {
+                /* A later record of the same key is always the newer one */
+                s_kv_index[header.key] = adrs;
+            }
+            adrs += KV_HEADER_SIZE + header.capacity;
+        }
+        s_kv_free_adrs = adrs;
+    }
+    return ret_val;
 }
 
 /***************************************************************************************************
@@ -107,27 +848,51 @@ bool ardal_eeprom_init(uint32_t p_data_size)
     bool ret_val = false;
     if (false == is_eeprom_init)
     {
-        ret_val = EEPROM.begin(p_data_size + DATA_START_ADRS);
+        ret_val = EEPROM.begin((SLOT_COUNT * (SLOT_HEADER_SIZE + p_data_size)) + EEPROM_KV_AREA_SIZE);
         is_eeprom_init = ret_val;
     }
     else
     {
         ret_val = true;
     }
+    if (true == ret_val && NULL == s_eeprom_mutex)
+    {
+        s_eeprom_mutex = xSemaphoreCreateRecursiveMutex();
+    }
     if (true == ret_val)
     {
         g_allocated_data_size = p_data_size;
-        read_magic_number();
+        s_ptr_shadow = EEPROM.getDataPtr();
+        select_active_slot();
+        if (NO_SLOT == s_active_slot &&
+            (true == migrate_smaller_data_size() || true == migrate_single_copy_layout()))
+        {
+            select_active_slot();
+        }
+        if (EEPROM_KV_AREA_SIZE > (KV_MAGIC_NUMBER_SIZE + KV_HEADER_SIZE))
+        {
+            ret_val = kv_build_index();
+        }
     }
     return ret_val;
 }
 
 void ardal_eeprom_deinit(void)
 {
+    ardal_eeprom_flush();
+    eeprom_lock();
     EEPROM.end();
     is_eeprom_init = false;
-    g_magic_number = 0x00U;
+    s_active_slot = NO_SLOT;
     g_allocated_data_size = 0U;
+    s_kv_free_adrs = 0U;
+    kv_abandon_streams();
+    s_kv_held_views = 0U;
+    s_ptr_shadow = NULL;
+    s_pending_slot = NO_SLOT;
+    s_is_commit_pending = false;
+    s_is_data_dirty = true;
+    eeprom_unlock();
 }
 
 data_validity_t ardal_eeprom_read_data(uint8_t * p_ptr_data_buffer, 
@@ -135,34 +900,24 @@ data_validity_t ardal_eeprom_read_data(uint8_t * p_ptr_data_buffer,
                                  uint32_t p_starting_address)
 {
     data_validity_t data_vld = DATA_INVALID;
-    uint8_t buffer_ptr[p_data_size];
-    if(NULL != p_ptr_data_buffer &&
-        0U != p_data_size && p_data_size <= g_allocated_data_size &&
-        p_starting_address >= DATA_START_ADRS)
-    {
-        logger_d("EEPROM read data\n");
-        if(true == is_magic_number_valid())
-        {
-            logger_d("Magic number is valid\n");
-            EEPROM.readBytes(p_starting_address, buffer_ptr, p_data_size);
-            uint16_t checksum = calculate_checksum((const uint8_t*)buffer_ptr, p_data_size);
-            uint16_t r_checksum = read_checksum();
-            if(checksum == r_checksum)
-            {
-                logger_d("Checksum is valid\n");
-                memcpy(p_ptr_data_buffer, (const uint8_t*)buffer_ptr, p_data_size);
-                data_vld = DATA_VALID;
-            }
-            else
-            {
-                logger_d("Checksum is invalid\n");
-            }
+    uint8_t slot = NO_SLOT;
+    if(NULL != p_ptr_data_buffer && true == is_data_range_valid(p_data_size, p_starting_address))
+    {
+        eeprom_lock();
+        slot = current_data_slot();
+        if(NO_SLOT != slot)
+        {
+            memcpy(p_ptr_data_buffer, &s_ptr_shadow[SLOT_DATA_ADRS(slot) + (p_starting_address - DATA_START_ADRS)],
+                   p_data_size);
+            s_stats.read_count++;
+            s_stats.bytes_copied += p_data_size;
+            data_vld = DATA_VALID;
         }
         else
         {
-            
-            logger_d("Magic number is invalid\tNo data to read\n");
+            logger_d("No valid slot\tNo data to read\n");
         }
+        eeprom_unlock();
     }
     else
     {
@@ -171,57 +926,469 @@ data_validity_t ardal_eeprom_read_data(uint8_t * p_ptr_data_buffer,
     return data_vld;
 }
 
+const uint8_t * ardal_eeprom_get_data_view(uint32_t p_data_size, uint32_t p_starting_address)
+{
+    const uint8_t * ret_ptr = NULL;
+    uint8_t slot = NO_SLOT;
+    if(true == is_data_range_valid(p_data_size, p_starting_address))
+    {
+        eeprom_lock();
+        slot = current_data_slot();
+        if(NO_SLOT != slot)
+        {
+            ret_ptr = &s_ptr_shadow[SLOT_DATA_ADRS(slot) + (p_starting_address - DATA_START_ADRS)];
+            s_stats.read_count++;
+        }
+        eeprom_unlock();
+    }
+    return ret_ptr;
+}
+
 bool ardal_eeprom_write_data(uint8_t * p_ptr_data_buffer, 
                                   uint32_t p_data_size,
                                   uint32_t p_starting_address)
 {
     bool data_vld = false;
-    bool write_status = true;
-    uint16_t checksum = 0;
-    uint16_t r_checksum = 0;
-    if(NULL != p_ptr_data_buffer && 
-        0U != p_data_size && p_data_size <= g_allocated_data_size
-        && p_starting_address >= DATA_START_ADRS)
+    uint8_t target_slot = NO_SLOT;
+
+    if(NULL != p_ptr_data_buffer && NULL != s_ptr_shadow &&
+       true == is_data_range_valid(p_data_size, p_starting_address))
     {
-        if(false == is_magic_number_valid())
+        eeprom_lock();
+        /* The new image is built in the inactive slot, the active slot stays untouched */
+        target_slot = begin_slot_update();
+        EEPROM.writeBytes(SLOT_DATA_ADRS(target_slot) + (p_starting_address - DATA_START_ADRS),
+                          p_ptr_data_buffer, p_data_size);
+        data_vld = request_commit();
+        eeprom_unlock();
+    }
+    else
+    {
+        logger_d("Invalid input parameters\n");
+    }
+
+    return data_vld;
+}
+
+bool ardal_eeprom_set_async_commit(bool p_enable, uint32_t p_quiet_period_ms)
+{
+    bool ret_val = true;
+
+    eeprom_lock();
+    if (true == p_enable)
+    {
+        s_quiet_period_ticks = pdMS_TO_TICKS(p_quiet_period_ms);
+        if (NULL == s_commit_task_hnd)
         {
-            logger_d("No magic number\n");
-            write_status = write_magic_number();
+            ret_val = (pdPASS == xTaskCreate(commit_task, COMMIT_TASK_NAME, COMMIT_TASK_STACK_SIZE,
+                                             NULL, COMMIT_TASK_PRIORITY, &s_commit_task_hnd));
         }
-        else
+        s_is_async_commit = ret_val;
+    }
+    else
+    {
+        s_is_async_commit = false;
+        ret_val = ardal_eeprom_flush();
+    }
+    eeprom_unlock();
+    return ret_val;
+}
+
+bool ardal_eeprom_flush(void)
+{
+    bool ret_val = true;
+    eeprom_lock();
+    if (true == s_is_commit_pending)
+    {
+        ret_val = commit_pending();
+    }
+    eeprom_unlock();
+    return ret_val;
+}
+
+uint32_t ardal_eeprom_get_data_start_adrs(void)
+{
+    return DATA_START_ADRS;
+}
+
+/**
+ * @brief Writes a record, compressed if p_compress is set and the compressed data is smaller.
+ */
+static bool kv_write_record(uint16_t p_key, const uint8_t * p_ptr_data_buffer, uint16_t p_data_size, bool p_compress)
+{
+    bool ret_val = false;
+    kv_record_header_t header;
+    uint32_t new_adrs = KV_NO_RECORD;
+    uint16_t stored_size = p_data_size;
+    rle_writer_t writer = {KV_NO_RECORD, 0U, CRC16_INIT_VAL};
+
+    if (NULL != p_ptr_data_buffer && 0U != p_data_size &&
+        p_key < EEPROM_KV_MAX_KEYS && 0U != s_kv_free_adrs)
+    {
+        eeprom_lock();
+        if (true == p_compress)
         {
-            logger_d("Magic number is exist\n");
+            /* Dry run to size the record */
+            rle_encode(&writer, p_ptr_data_buffer, p_data_size);
+            p_compress = (writer.size < p_data_size);
+            stored_size = (true == p_compress) ? writer.size : p_data_size;
         }
-        if(true == write_status)
+        new_adrs = s_kv_index[p_key];
+        if (KV_NO_RECORD != new_adrs)
         {
-            logger_d("Magic number is written\n");
-            checksum = calculate_checksum(p_ptr_data_buffer, p_data_size);
-            write_status = write_checksum(checksum);
-            if(true == write_status)
+            kv_read_header(new_adrs, &header);
+            if (stored_size > header.capacity)
             {
-                r_checksum = read_checksum();
-                if(r_checksum == checksum)
-                {
-                    logger_d("Checksum is written\n");
-                    EEPROM.writeBytes(p_starting_address, p_ptr_data_buffer, p_data_size);
-                    data_vld = EEPROM.commit();
-                }
-                else
-                {
-                    logger_d_p2(__func__, "Checksum is invalid\tExpected: %d - Received: %d\n", checksum, r_checksum);
-                }
+                /* The record is moved to a bigger slot, the old one is retired on publish */
+                new_adrs = KV_NO_RECORD;
             }
         }
+        if (KV_NO_RECORD == new_adrs)
+        {
+            new_adrs = kv_reserve(stored_size);
+            header.capacity = stored_size;
+        }
+        if (KV_NO_RECORD != new_adrs)
+        {
+            /* Update in place or in the new slot, the other records keep their bytes and CRCs */
+            header.key = p_key;
+            header.length = stored_size;
+            header.raw_length = p_data_size;
+            if (true == p_compress)
+            {
+                writer.adrs = new_adrs + KV_HEADER_SIZE;
+                writer.size = 0U;
+                rle_encode(&writer, p_ptr_data_buffer, p_data_size);
+                header.crc = writer.crc;
+                header.flags = KV_FLAG_RLE;
+            }
+            else
+            {
+                header.crc = calculate_crc16(CRC16_INIT_VAL, p_ptr_data_buffer, p_data_size);
+                header.flags = 0U;
+                EEPROM.writeBytes(new_adrs + KV_HEADER_SIZE, p_ptr_data_buffer, p_data_size);
+            }
+            ret_val = kv_publish(new_adrs, &header);
+        }
+        else
+        {
+            logger_d("No space left for key %d\n", p_key);
+        }
+        eeprom_unlock();
     }
     else
     {
         logger_d("Invalid input parameters\n");
     }
+    return ret_val;
+}
+
+bool ardal_eeprom_kv_write(uint16_t p_key, const uint8_t * p_ptr_data_buffer, uint16_t p_data_size)
+{
+    return kv_write_record(p_key, p_ptr_data_buffer, p_data_size, false);
+}
+
+bool ardal_eeprom_kv_write_compressed(uint16_t p_key, const uint8_t * p_ptr_data_buffer, uint16_t p_data_size)
+{
+    return kv_write_record(p_key, p_ptr_data_buffer, p_data_size, true);
+}
 
+const uint8_t * ardal_eeprom_kv_get_view(uint16_t p_key, uint16_t * p_ptr_data_size)
+{
+    const uint8_t * ret_ptr = NULL;
+    kv_record_header_t header;
+
+    eeprom_lock();
+    ret_ptr = kv_get_stored_data(p_key, &header);
+    if (NULL != ret_ptr && 0U != (header.flags & KV_FLAG_RLE))
+    {
+        /* Compressed records have no plain view */
+        ret_ptr = NULL;
+    }
+    if (NULL != ret_ptr)
+    {
+        s_stats.read_count++;
+        s_kv_held_views++;
+        if (NULL != p_ptr_data_size)
+        {
+            *p_ptr_data_size = header.length;
+        }
+    }
+    eeprom_unlock();
+    return ret_ptr;
+}
+
+void ardal_eeprom_kv_release_view(const uint8_t * p_ptr_view)
+{
+    eeprom_lock();
+    if (NULL != p_ptr_view && 0U != s_kv_held_views)
+    {
+        s_kv_held_views--;
+    }
+    eeprom_unlock();
+}
+
+data_validity_t ardal_eeprom_kv_read(uint16_t p_key,
+                                     uint8_t * p_ptr_data_buffer,
+                                     uint16_t p_buffer_size,
+                                     uint16_t * p_ptr_data_size)
+{
+    data_validity_t data_vld = DATA_INVALID;
+    kv_record_header_t header;
+    const uint8_t * data_ptr = NULL;
+
+    eeprom_lock();
+    if (NULL != p_ptr_data_buffer)
+    {
+        data_ptr = kv_get_stored_data(p_key, &header);
+    }
+    if (NULL != data_ptr)
+    {
+        if (header.raw_length > p_buffer_size)
+        {
+            logger_d("Buffer is too small\tExpected: %d - Received: %d\n", header.raw_length, p_buffer_size);
+        }
+        else if (0U != (header.flags & KV_FLAG_RLE))
+        {
+            if (header.raw_length == rle_decode(data_ptr, header.length, p_ptr_data_buffer, header.raw_length))
+            {
+                data_vld = DATA_VALID;
+            }
+        }
+        else
+        {
+            memcpy(p_ptr_data_buffer, data_ptr, header.length);
+            data_vld = DATA_VALID;
+        }
+    }
+    if (DATA_VALID == data_vld)
+    {
+        s_stats.read_count++;
+        s_stats.bytes_copied += header.raw_length;
+        if (NULL != p_ptr_data_size)
+        {
+            *p_ptr_data_size = header.raw_length;
+        }
+    }
+    eeprom_unlock();
     return data_vld;
 }
 
-uint32_t eeprom_get_data_start_adrs(void)
+uint16_t ardal_eeprom_kv_get_size(uint16_t p_key)
 {
-    return DATA_START_ADRS;
+    eeprom_kv_info_t info = {0U, 0U, 0U, false};
+    ardal_eeprom_kv_get_info(p_key, &info);
+    return info.raw_size;
+}
+
+bool ardal_eeprom_kv_get_info(uint16_t p_key, eeprom_kv_info_t * p_ptr_info)
+{
+    bool ret_val = false;
+    kv_record_header_t header;
+
+    if (NULL != p_ptr_info && p_key < EEPROM_KV_MAX_KEYS)
+    {
+        eeprom_lock();
+        if (KV_NO_RECORD != s_kv_index[p_key])
+        {
+            kv_read_header(s_kv_index[p_key], &header);
+            p_ptr_info->raw_size = header.raw_length;
+            p_ptr_info->stored_size = header.length;
+            p_ptr_info->capacity = header.capacity;
+            p_ptr_info->is_compressed = (0U != (header.flags & KV_FLAG_RLE));
+            ret_val = true;
+        }
+        eeprom_unlock();
+    }
+    return ret_val;
+}
+
+bool ardal_eeprom_kv_erase(uint16_t p_key)
+{
+    bool ret_val = false;
+    eeprom_lock();
+    if (p_key < EEPROM_KV_MAX_KEYS && KV_NO_RECORD != s_kv_index[p_key])
+    {
+        EEPROM.writeUShort(s_kv_index[p_key], KV_KEY_DELETED);
+        s_kv_index[p_key] = KV_NO_RECORD;
+        ret_val = request_commit();
+    }
+    eeprom_unlock();
+    return ret_val;
+}
+
+bool ardal_eeprom_stream_write_begin(eeprom_stream_t * p_ptr_stream, uint16_t p_key, uint16_t p_blob_size)
+{
+    bool ret_val = false;
+    if (NULL != p_ptr_stream && p_blob_size > EEPROM_KV_MAX_RECORD_SIZE)
+    {
+        logger_w("Blob of %d bytes exceeds EEPROM_KV_MAX_RECORD_SIZE\n", p_blob_size);
+        p_ptr_stream->record_adrs = KV_NO_RECORD;
+    }
+    else if (NULL != p_ptr_stream && 0U != p_blob_size &&
+             p_key < EEPROM_KV_MAX_KEYS && 0U != s_kv_free_adrs)
+    {
+        eeprom_lock();
+        p_ptr_stream->record_adrs = kv_reserve(p_blob_size);
+        if (KV_NO_RECORD != p_ptr_stream->record_adrs)
+        {
+            p_ptr_stream->key = p_key;
+            p_ptr_stream->size = p_blob_size;
+            p_ptr_stream->position = 0U;
+            p_ptr_stream->crc = CRC16_INIT_VAL;
+            p_ptr_stream->generation = s_kv_stream_generation;
+            s_kv_open_streams++;
+            s_kv_stream_tick = xTaskGetTickCount();
+            ret_val = true;
+        }
+        else
+        {
+            logger_d("No space left for key %d\n", p_key);
+        }
+        eeprom_unlock();
+    }
+    return ret_val;
+}
+
+bool ardal_eeprom_stream_write(eeprom_stream_t * p_ptr_stream, const uint8_t * p_ptr_chunk, uint16_t p_chunk_size)
+{
+    bool ret_val = false;
+    if (NULL != p_ptr_stream && NULL != p_ptr_chunk && KV_NO_RECORD != p_ptr_stream->record_adrs &&
+        p_chunk_size <= (p_ptr_stream->size - p_ptr_stream->position))
+    {
+        eeprom_lock();
+        /* An abandoned stream must not write, its record may have been compacted away */
+        ret_val = kv_is_stream_open(p_ptr_stream);
+        if (true == ret_val)
+        {
+            EEPROM.writeBytes(p_ptr_stream->record_adrs + KV_HEADER_SIZE + p_ptr_stream->position, p_ptr_chunk, p_chunk_size);
+            s_kv_stream_tick = xTaskGetTickCount();
+        }
+        eeprom_unlock();
+        if (true == ret_val)
+        {
+            p_ptr_stream->crc = calculate_crc16(p_ptr_stream->crc, p_ptr_chunk, p_chunk_size);
+            p_ptr_stream->position += p_chunk_size;
+        }
+    }
+    return ret_val;
+}
+
+bool ardal_eeprom_stream_write_end(eeprom_stream_t * p_ptr_stream)
+{
+    bool ret_val = false;
+    kv_record_header_t header;
+
+    if (NULL != p_ptr_stream && KV_NO_RECORD != p_ptr_stream->record_adrs)
+    {
+        eeprom_lock();
+        if (true == kv_is_stream_open(p_ptr_stream))
+        {
+            s_kv_open_streams--;
+        }
+        if (false == kv_is_stream_open(p_ptr_stream))
+        {
+            logger_d("Stream of key %d was abandoned\n", p_ptr_stream->key);
+        }
+        else if (p_ptr_stream->position == p_ptr_stream->size)
+        {
+            header.key = p_ptr_stream->key;
+            header.capacity = p_ptr_stream->size;
+            header.length = p_ptr_stream->size;
+            header.crc = p_ptr_stream->crc;
+            header.raw_length = p_ptr_stream->size;
+            header.flags = 0U;
+            ret_val = kv_publish(p_ptr_stream->record_adrs, &header);
+        }
+        else
+        {
+            logger_d("Stream is incomplete\tExpected: %d - Received: %d\n", p_ptr_stream->size, p_ptr_stream->position);
+        }
+        eeprom_unlock();
+        p_ptr_stream->record_adrs = KV_NO_RECORD;
+    }
+    return ret_val;
+}
+
+data_validity_t ardal_eeprom_stream_read_begin(eeprom_stream_t * p_ptr_stream, uint16_t p_key)
+{
+    data_validity_t data_vld = DATA_INVALID;
+    kv_record_header_t header;
+
+    if (NULL != p_ptr_stream && p_key < EEPROM_KV_MAX_KEYS)
+    {
+        eeprom_lock();
+        p_ptr_stream->record_adrs = s_kv_index[p_key];
+        if (KV_NO_RECORD != p_ptr_stream->record_adrs)
+        {
+            kv_read_header(p_ptr_stream->record_adrs, &header);
+        }
+        if (KV_NO_RECORD != p_ptr_stream->record_adrs && 0U != (header.flags & KV_FLAG_RLE))
+        {
+            logger_d("Key %d is compressed and can not be streamed\n", p_key);
+            p_ptr_stream->record_adrs = KV_NO_RECORD;
+        }
+        if (KV_NO_RECORD != p_ptr_stream->record_adrs)
+        {
+            p_ptr_stream->key = p_key;
+            p_ptr_stream->size = header.length;
+            p_ptr_stream->position = 0U;
+            p_ptr_stream->crc = CRC16_INIT_VAL;
+            data_vld = DATA_VALID;
+        }
+        eeprom_unlock();
+    }
+    return data_vld;
+}
+
+uint16_t ardal_eeprom_stream_read(eeprom_stream_t * p_ptr_stream, uint8_t * p_ptr_chunk, uint16_t p_chunk_size)
+{
+    uint16_t read_size = 0U;
+    if (NULL != p_ptr_stream && NULL != p_ptr_chunk && KV_NO_RECORD != p_ptr_stream->record_adrs)
+    {
+        read_size = p_ptr_stream->size - p_ptr_stream->position;
+        if (p_chunk_size < read_size)
+        {
+            read_size = p_chunk_size;
+        }
+        eeprom_lock();
+        memcpy(p_ptr_chunk, &s_ptr_shadow[p_ptr_stream->record_adrs + KV_HEADER_SIZE + p_ptr_stream->position], read_size);
+        s_stats.bytes_copied += read_size;
+        eeprom_unlock();
+        p_ptr_stream->crc = calculate_crc16(p_ptr_stream->crc, p_ptr_chunk, read_size);
+        p_ptr_stream->position += read_size;
+    }
+    return read_size;
+}
+
+data_validity_t ardal_eeprom_stream_read_end(eeprom_stream_t * p_ptr_stream)
+{
+    data_validity_t data_vld = DATA_INVALID;
+    kv_record_header_t header;
+
+    if (NULL != p_ptr_stream && KV_NO_RECORD != p_ptr_stream->record_adrs)
+    {
+        eeprom_lock();
+        kv_read_header(p_ptr_stream->record_adrs, &header);
+        /* The record must not have been replaced or moved while it was streamed */
+        if (s_kv_index[p_ptr_stream->key] == p_ptr_stream->record_adrs &&
+            p_ptr_stream->position == p_ptr_stream->size && header.crc == p_ptr_stream->crc)
+        {
+            s_stats.read_count++;
+            data_vld = DATA_VALID;
+        }
+        eeprom_unlock();
+        p_ptr_stream->record_adrs = KV_NO_RECORD;
+    }
+    return data_vld;
+}
+
+void ardal_eeprom_get_stats(eeprom_stats_t * p_ptr_stats)
+{
+    if (NULL != p_ptr_stats)
+    {
+        eeprom_lock();
+        *p_ptr_stats = s_stats;
+        eeprom_unlock();
+    }
 }
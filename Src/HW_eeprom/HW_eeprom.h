@@ -19,6 +19,30 @@
 * Macro definitions.
 ***************************************************************************************************/
 
+/* Logical address of the first data byte, callers address the data relative to it */
+#define EEPROM_DATA_START_ADRS (6U)
+
+/* Size of the key-value record area in bytes, 0 disables the key-value store.
+ * The largest record is EEPROM_KV_MAX_RECORD_SIZE, and replacing a record needs room for the old and
+ * the new copy. The default fits small configs, not certificates: a PEM certificate or key takes 1 to 2 KB,
+ * so define the area as 4096 or more in the build flags to store them. The area is kept in RAM. */
+#ifndef EEPROM_KV_AREA_SIZE
+#define EEPROM_KV_AREA_SIZE (512U)
+#endif
+
+/* Largest record the key-value area can hold: the area minus its magic number and one record header */
+#define EEPROM_KV_MAX_RECORD_SIZE (EEPROM_KV_AREA_SIZE - 14U)
+
+/* A stream write left open for this long is abandoned, its space is reclaimed when the area is full */
+#ifndef EEPROM_STREAM_TIMEOUT_MS
+#define EEPROM_STREAM_TIMEOUT_MS (5000U)
+#endif
+
+/* Number of key ids the key-value store can index, valid keys are 0 .. EEPROM_KV_MAX_KEYS - 1 */
+#ifndef EEPROM_KV_MAX_KEYS
+#define EEPROM_KV_MAX_KEYS (32U)
+#endif
+
 /***************************************************************************************************
 * External type declarations.
 ***************************************************************************************************/
@@ -29,6 +53,34 @@ typedef enum data_validity_t_enum
     DATA_INVALID
 }data_validity_t;
 
+typedef struct eeprom_stats_t_struct
+{
+    uint32_t read_count;        /* Number of served reads and views */
+    uint32_t bytes_copied;      /* Bytes copied into caller buffers */
+    uint32_t bytes_checksummed; /* Bytes walked by checksum and CRC calculations */
+    uint32_t write_count;       /* Number of data and key-value writes */
+    uint32_t commit_count;      /* Number of commits to the flash */
+    uint32_t coalesced_write_count; /* Writes merged into a commit of an earlier write */
+} eeprom_stats_t;
+
+typedef struct eeprom_kv_info_t_struct
+{
+    uint16_t raw_size;      /* Size of the record data in bytes */
+    uint16_t stored_size;   /* Bytes used in the EEPROM, smaller than raw_size if compressed */
+    uint16_t capacity;      /* Bytes reserved for the record in the EEPROM */
+    bool is_compressed;
+} eeprom_kv_info_t;
+
+typedef struct eeprom_stream_t_struct
+{
+    uint16_t key;           /* Key id of the streamed record */
+    uint16_t size;          /* Total size of the blob in bytes */
+    uint16_t position;      /* Bytes streamed so far */
+    uint16_t crc;           /* CRC of the bytes streamed so far */
+    uint32_t record_adrs;   /* Address of the record in the EEPROM, 0 if the stream is closed */
+    uint32_t generation;    /* Stream generation at begin, the stream is abandoned once it changes */
+} eeprom_stream_t;
+
 /***************************************************************************************************
 * External data declarations.
 ***************************************************************************************************/
@@ -39,6 +91,12 @@ typedef enum data_validity_t_enum
 
 /**
  * @brief This function initializes the EEPROM module.
+ *        The data is kept in two A/B slots, the newest slot is selected from the slot headers only,
+ *        its data is checked on the first read.
+ *        The key-value area is reserved before the data slots, so it does not move when the data size
+ *        changes, and its index is built here.
+ *        Data saved with a smaller data size is moved to the new size, the added bytes read as 0.
+ *        A larger saved data size is not supported, the data size must only grow.
  * 
  * @param p_data_size input: The size of the data to be stored in the EEPROM in bytes
  * @retval true if the EEPROM is initialized successfully
@@ -47,14 +105,39 @@ typedef enum data_validity_t_enum
 extern bool ardal_eeprom_init(uint32_t p_data_size);
 
 /**
- * @brief This function deinitializes the EEPROM module.
+ * @brief This function commits the pending writes and deinitializes the EEPROM module.
+ */
+extern void ardal_eeprom_deinit(void);
+
+/**
+ * @brief This function reads data from the EEPROM RAM image with a single copy.
+ *        The data area is checked against the checksum once, after init or a failed commit,
+ *        later reads are served without checksumming again.
+ * 
+ * @param p_ptr_data_buffer output: Pointer to the data buffer
+ * @param p_data_size input: The size of the data to be read in bytes
+ * @param p_starting_address input: The starting address of the data in the EEPROM
+ * @retval DATA_VALID if the data area is valid
+ * @retval DATA_INVALID otherwise
  */
 extern data_validity_t ardal_eeprom_read_data(uint8_t * p_ptr_data_buffer, 
                                         uint32_t p_data_size,
                                         uint32_t p_starting_address);
 
 /**
- * @brief This function writes data to the EEPROM, and calculates the checksum.
+ * @brief This function gets a read-only view of the data in the EEPROM RAM image without copying.
+ *        The view stays valid until the next write to the same range or ardal_eeprom_deinit.
+ * 
+ * @param p_data_size input: The size of the viewed data in bytes
+ * @param p_starting_address input: The starting address of the data in the EEPROM
+ * @retval Pointer to the data, NULL if the range or the data area is invalid
+ */
+extern const uint8_t * ardal_eeprom_get_data_view(uint32_t p_data_size, uint32_t p_starting_address);
+
+/**
+ * @brief This function writes data to the inactive A/B slot, and makes it the active slot on commit.
+ *        The slot data and the slot header are committed at once, a reset during the write
+ *        keeps the previous data. In async mode the commit is done by the background task.
  * 
  * @param p_ptr_data_buffer input: Pointer to the data buffer
  * @param p_data_size input: The size of the data to be stored in the EEPROM in bytes
@@ -65,6 +148,197 @@ extern data_validity_t ardal_eeprom_read_data(uint8_t * p_ptr_data_buffer,
 extern bool ardal_eeprom_write_data(uint8_t * p_ptr_data_buffer, 
                               uint32_t p_data_size,
                               uint32_t p_starting_address);
+/**
+ * @brief This function switches between synchronous commits and the background commit task.
+ *        In async mode the writes only update the RAM image, the task commits all of them at once
+ *        after no write happened for the quiet period. Reads always return the newest data.
+ * 
+ * @param p_enable input: true to commit in the background task, false to commit in every write
+ * @param p_quiet_period_ms input: The time without writes before the task commits, in milliseconds
+ * @retval true if the mode is set successfully
+ * @retval false if the task could not be created, or the pending writes could not be committed
+ */
+extern bool ardal_eeprom_set_async_commit(bool p_enable, uint32_t p_quiet_period_ms);
+
+/**
+ * @brief This function commits the pending writes right away, it should be called before a shutdown.
+ * 
+ * @retval true if there is nothing pending or the commit succeeded
+ * @retval false if the commit failed, the writes stay pending
+ */
+extern bool ardal_eeprom_flush(void);
+
+/**
+ * @brief This function gets the logical address of the first data byte.
+ * 
+ * @retval EEPROM_DATA_START_ADRS
+ */
 extern uint32_t ardal_eeprom_get_data_start_adrs(void);
 
+/**
+ * @brief This function writes a record to the key-value store.
+ *        Only the record of this key is rewritten, the other records are not touched.
+ *        If the new size exceeds the record capacity, the record is moved to the end of the area,
+ *        the area is compacted when it runs out of space.
+ *        A record that fits is rewritten in place, so it relies on the commit being atomic, as the
+ *        NVS blob commit is. Data that must survive a torn write belongs in the A/B data slots.
+ * 
+ * @param p_key input: The key id of the record, 0 .. EEPROM_KV_MAX_KEYS - 1
+ * @param p_ptr_data_buffer input: Pointer to the data buffer
+ * @param p_data_size input: The size of the data in bytes
+ * @retval true if the record is written and committed successfully
+ * @retval false if the parameters are invalid or there is no space left
+ */
+extern bool ardal_eeprom_kv_write(uint16_t p_key, const uint8_t * p_ptr_data_buffer, uint16_t p_data_size);
+
+/**
+ * @brief This function writes a record to the key-value store run length compressed.
+ *        The record is stored uncompressed if compression does not make it smaller.
+ *        Compressed records are decompressed by ardal_eeprom_kv_read, they have no view and can not be streamed.
+ * 
+ * @param p_key input: The key id of the record, 0 .. EEPROM_KV_MAX_KEYS - 1
+ * @param p_ptr_data_buffer input: Pointer to the data buffer
+ * @param p_data_size input: The size of the data in bytes
+ * @retval true if the record is written and committed successfully
+ * @retval false if the parameters are invalid or there is no space left
+ */
+extern bool ardal_eeprom_kv_write_compressed(uint16_t p_key, const uint8_t * p_ptr_data_buffer, uint16_t p_data_size);
+
+/**
+ * @brief This function reads a record from the key-value store and checks its CRC.
+ *        Compressed records are decompressed into the data buffer.
+ * 
+ * @param p_key input: The key id of the record
+ * @param p_ptr_data_buffer output: Pointer to the data buffer
+ * @param p_buffer_size input: The size of the data buffer in bytes
+ * @param p_ptr_data_size output: The size of the read record in bytes, can be NULL
+ * @retval DATA_VALID if the record exists and its CRC is valid
+ * @retval DATA_INVALID otherwise
+ */
+extern data_validity_t ardal_eeprom_kv_read(uint16_t p_key,
+                                            uint8_t * p_ptr_data_buffer,
+                                            uint16_t p_buffer_size,
+                                            uint16_t * p_ptr_data_size);
+
+/**
+ * @brief This function gets a read-only view of a record in the EEPROM RAM image without copying.
+ *        The CRC of the record is checked on the first access only.
+ *        Each view must be released with ardal_eeprom_kv_release_view. Until then the key-value area
+ *        is not compacted, so the view stays in place; a write that needs the compaction fails instead.
+ *        The view keeps the data it had when it was taken, a later write or erase of the key is not seen.
+ *        ardal_eeprom_deinit invalidates every view.
+ * 
+ * @param p_key input: The key id of the record
+ * @param p_ptr_data_size output: The size of the record in bytes, can be NULL
+ * @retval Pointer to the record data, NULL if the record does not exist, is compressed or its CRC is invalid
+ */
+extern const uint8_t * ardal_eeprom_kv_get_view(uint16_t p_key, uint16_t * p_ptr_data_size);
+
+/**
+ * @brief This function releases a view got from ardal_eeprom_kv_get_view, the view must not be used after.
+ * 
+ * @param p_ptr_view input: The view, NULL is ignored
+ */
+extern void ardal_eeprom_kv_release_view(const uint8_t * p_ptr_view);
+
+/**
+ * @brief This function gets the size of a stored record.
+ * 
+ * @param p_key input: The key id of the record
+ * @retval The size of the record in bytes, 0 if the record does not exist
+ */
+extern uint16_t ardal_eeprom_kv_get_size(uint16_t p_key);
+
+/**
+ * @brief This function gets the sizes of a stored record, stored_size / raw_size is its compression ratio.
+ * 
+ * @param p_key input: The key id of the record
+ * @param p_ptr_info output: The record info
+ * @retval true if the record exists
+ * @retval false otherwise
+ */
+extern bool ardal_eeprom_kv_get_info(uint16_t p_key, eeprom_kv_info_t * p_ptr_info);
+
+/**
+ * @brief This function removes a record from the key-value store.
+ * 
+ * @param p_key input: The key id of the record
+ * @retval true if the record is removed successfully
+ * @retval false if the record does not exist or the commit failed
+ */
+extern bool ardal_eeprom_kv_erase(uint16_t p_key);
+
+/**
+ * @brief This function starts writing a blob to the key-value store in chunks.
+ *        The blob is written to a new record and replaces the old record of the key
+ *        in ardal_eeprom_stream_write_end, so an interrupted stream keeps the old data.
+ *        The stream must be ended even if writing a chunk failed. A stream without a chunk written for
+ *        EEPROM_STREAM_TIMEOUT_MS is abandoned when another record needs its space, and so is every open
+ *        stream on ardal_eeprom_deinit; writing to or ending an abandoned stream fails.
+ * 
+ * @param p_ptr_stream output: The stream to be started
+ * @param p_key input: The key id of the record
+ * @param p_blob_size input: The total size of the blob in bytes
+ * @retval true if space is reserved for the blob
+ * @retval false if the parameters are invalid, the blob exceeds EEPROM_KV_MAX_RECORD_SIZE or there is no space left
+ */
+extern bool ardal_eeprom_stream_write_begin(eeprom_stream_t * p_ptr_stream, uint16_t p_key, uint16_t p_blob_size);
+
+/**
+ * @brief This function writes the next chunk of the blob and updates the CRC.
+ * 
+ * @param p_ptr_stream input: The started stream
+ * @param p_ptr_chunk input: Pointer to the chunk
+ * @param p_chunk_size input: The size of the chunk in bytes
+ * @retval true if the chunk is written
+ * @retval false if the stream is closed or abandoned, or the chunk exceeds the blob size
+ */
+extern bool ardal_eeprom_stream_write(eeprom_stream_t * p_ptr_stream, const uint8_t * p_ptr_chunk, uint16_t p_chunk_size);
+
+/**
+ * @brief This function closes the stream, and publishes the record if the whole blob is written.
+ * 
+ * @param p_ptr_stream input: The started stream
+ * @retval true if the record is published and committed successfully
+ * @retval false if the blob is incomplete, the stream is abandoned or the commit failed
+ */
+extern bool ardal_eeprom_stream_write_end(eeprom_stream_t * p_ptr_stream);
+
+/**
+ * @brief This function starts reading a record of the key-value store in chunks.
+ * 
+ * @param p_ptr_stream output: The stream to be started, its size holds the record size
+ * @param p_key input: The key id of the record
+ * @retval DATA_VALID if the record exists
+ * @retval DATA_INVALID if the record does not exist or is compressed
+ */
+extern data_validity_t ardal_eeprom_stream_read_begin(eeprom_stream_t * p_ptr_stream, uint16_t p_key);
+
+/**
+ * @brief This function reads the next chunk of the record and updates the CRC.
+ * 
+ * @param p_ptr_stream input: The started stream
+ * @param p_ptr_chunk output: Pointer to the chunk buffer
+ * @param p_chunk_size input: The size of the chunk buffer in bytes
+ * @retval The number of bytes read, 0 at the end of the record
+ */
+extern uint16_t ardal_eeprom_stream_read(eeprom_stream_t * p_ptr_stream, uint8_t * p_ptr_chunk, uint16_t p_chunk_size);
+
+/**
+ * @brief This function closes the stream and checks the CRC of the streamed data.
+ *        The chunks must not be trusted before this function returns DATA_VALID.
+ * 
+ * @param p_ptr_stream input: The started stream
+ * @retval DATA_VALID if the whole record is read and its CRC is valid
+ * @retval DATA_INVALID otherwise
+ */
+extern data_validity_t ardal_eeprom_stream_read_end(eeprom_stream_t * p_ptr_stream);
+
+/**
+ * @brief This function gets the read and commit statistics of the EEPROM module.
+ * 
+ * @param p_ptr_stats output: Pointer to the statistics struct
+ */
+extern void ardal_eeprom_get_stats(eeprom_stats_t * p_ptr_stats);
+
 #endif /* HW_EEPROM_H */
\ No newline at end of file
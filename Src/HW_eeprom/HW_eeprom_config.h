@@ -0,0 +1,213 @@
+/***************************************************************************************************
+* File Name: HW_eeprom_config.h
+* Module: HW_eeprom
+* Abstract: Type-safe, schema-versioned config structs on top of "/lib/HW_eeprom/HW_eeprom.h".
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+#ifndef HW_EEPROM_CONFIG_H
+#define HW_EEPROM_CONFIG_H
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+#include "HW_eeprom.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define EEPROM_SECTION_HEADER_SIZE ((uint32_t)sizeof(eeprom_section_header_t))
+
+/* Number of EEPROM bytes reserved for a config struct, including its section header.
+   It only depends on the reserved capacity, so the struct can grow without moving the sections after it */
+#define EEPROM_SECTION_SIZE(T_CONFIG) (EEPROM_SECTION_HEADER_SIZE + (uint32_t)(T_CONFIG::EEPROM_CAPACITY))
+
+/***************************************************************************************************
+* External type declarations.
+***************************************************************************************************/
+
+typedef struct eeprom_section_header_t_struct
+{
+    uint16_t version;   /* SCHEMA_VERSION of the struct when it was saved */
+    uint16_t size;      /* sizeof() of the struct when it was saved */
+} eeprom_section_header_t;
+
+/**
+ * @brief Offset of a config struct from the start of the layout, resolved at compile time.
+ */
+template <typename T_TARGET, typename... T_SECTIONS>
+struct eeprom_section_offset;
+
+template <typename T_TARGET>
+struct eeprom_section_offset<T_TARGET>
+{
+    static_assert(sizeof(T_TARGET) == 0U, "The config struct is not part of the EEPROM layout");
+    static constexpr uint32_t value = 0U;
+};
+
+template <typename T_TARGET, typename... T_REST>
+struct eeprom_section_offset<T_TARGET, T_TARGET, T_REST...>
+{
+    static constexpr uint32_t value = 0U;
+};
+
+template <typename T_TARGET, typename T_FIRST, typename... T_REST>
+struct eeprom_section_offset<T_TARGET, T_FIRST, T_REST...>
+{
+    static constexpr uint32_t value = EEPROM_SECTION_SIZE(T_FIRST) + eeprom_section_offset<T_TARGET, T_REST...>::value;
+};
+
+template <typename... T_SECTIONS>
+struct eeprom_layout_size;
+
+template <>
+struct eeprom_layout_size<>
+{
+    static constexpr uint32_t value = 0U;
+};
+
+template <typename T_FIRST, typename... T_REST>
+struct eeprom_layout_size<T_FIRST, T_REST...>
+{
+    static constexpr uint32_t value = EEPROM_SECTION_SIZE(T_FIRST) + eeprom_layout_size<T_REST...>::value;
+};
+
+/**
+ * @brief Tells at compile time if T_TARGET is one of the types of T_SECTIONS.
+ */
+template <typename T_TARGET, typename... T_SECTIONS>
+struct eeprom_section_contains;
+
+template <typename T_TARGET>
+struct eeprom_section_contains<T_TARGET>
+{
+    static constexpr bool value = false;
+};
+
+template <typename T_TARGET, typename T_FIRST, typename... T_REST>
+struct eeprom_section_contains<T_TARGET, T_FIRST, T_REST...>
+{
+    static constexpr bool value = std::is_same<T_TARGET, T_FIRST>::value ||
+                                  eeprom_section_contains<T_TARGET, T_REST...>::value;
+};
+
+/**
+ * @brief Tells at compile time if every type of T_SECTIONS appears once and fits in its reserved capacity.
+ */
+template <typename... T_SECTIONS>
+struct eeprom_sections_are_valid;
+
+template <>
+struct eeprom_sections_are_valid<>
+{
+    static constexpr bool is_unique = true;
+    static constexpr bool fits = true;
+};
+
+template <typename T_FIRST, typename... T_REST>
+struct eeprom_sections_are_valid<T_FIRST, T_REST...>
+{
+    static constexpr bool is_unique = !eeprom_section_contains<T_FIRST, T_REST...>::value &&
+                                      eeprom_sections_are_valid<T_REST...>::is_unique;
+    static constexpr bool fits = (sizeof(T_FIRST) <= T_FIRST::EEPROM_CAPACITY) &&
+                                 eeprom_sections_are_valid<T_REST...>::fits;
+};
+
+/**
+ * @brief Compile-time layout of the config structs stored in the EEPROM data area.
+ *        Every struct is stored behind a section header, in the order of the template arguments.
+ *        Each struct must be trivially copyable and declare:
+ *          static const uint16_t SCHEMA_VERSION;   non zero, bumped on every layout change
+ *          static const uint16_t EEPROM_CAPACITY;  bytes reserved for the struct, never changed once released
+ *          static bool migrate(uint16_t p_stored_version, const uint8_t * p_ptr_stored,
+ *                              uint16_t p_stored_size, T_CONFIG & p_config);
+ *        The sections are placed by their capacity, so a struct can grow up to its capacity without
+ *        moving the sections after it. New sections are added at the end: ardal_eeprom_init moves the
+ *        data of the smaller layout, the new sections read as empty and load returns DATA_INVALID for them.
+ * 
+ * @example struct wifi_config_t { static const uint16_t SCHEMA_VERSION = 1; static const uint16_t EEPROM_CAPACITY = 128; ... };
+ *          typedef eeprom_layout<wifi_config_t, motor_config_t> app_layout_t;
+ *          ardal_eeprom_init(app_layout_t::DATA_SIZE);
+ *          app_layout_t::load(s_wifi_config);
+ */
+template <typename... T_SECTIONS>
+class eeprom_layout
+{
+    static_assert(eeprom_sections_are_valid<T_SECTIONS...>::is_unique, "A config struct appears twice in the EEPROM layout");
+    static_assert(eeprom_sections_are_valid<T_SECTIONS...>::fits, "A config struct is bigger than its EEPROM_CAPACITY");
+
+public:
+    static constexpr uint32_t DATA_SIZE = eeprom_layout_size<T_SECTIONS...>::value;
+
+    template <typename T_CONFIG>
+    static constexpr uint32_t address_of()
+    {
+        return EEPROM_DATA_START_ADRS + eeprom_section_offset<T_CONFIG, T_SECTIONS...>::value;
+    }
+
+    /**
+     * @brief This function loads a config struct, and migrates it if it was saved with another schema version.
+     * 
+     * @param p_config output: The config struct, untouched if no valid data is stored
+     * @retval DATA_VALID if the struct is loaded or migrated successfully
+     * @retval DATA_INVALID otherwise
+     */
+    template <typename T_CONFIG>
+    static data_validity_t load(T_CONFIG & p_config)
+    {
+        static_assert(std::is_trivially_copyable<T_CONFIG>::value, "Config structs must be trivially copyable");
+        static_assert(0U != T_CONFIG::SCHEMA_VERSION, "Schema version 0 is reserved for empty sections");
+
+        data_validity_t data_vld = DATA_INVALID;
+        eeprom_section_header_t header;
+        const uint8_t * section_ptr = ardal_eeprom_get_data_view(EEPROM_SECTION_SIZE(T_CONFIG),
+                                                                 address_of<T_CONFIG>());
+        if (NULL != section_ptr)
+        {
+            memcpy(&header, section_ptr, sizeof(header));
+            section_ptr += EEPROM_SECTION_HEADER_SIZE;
+            if (T_CONFIG::SCHEMA_VERSION == header.version && sizeof(T_CONFIG) == header.size)
+            {
+                memcpy(&p_config, section_ptr, sizeof(T_CONFIG));
+                data_vld = DATA_VALID;
+            }
+            else if (0U != header.version && header.size <= T_CONFIG::EEPROM_CAPACITY &&
+                     true == T_CONFIG::migrate(header.version, section_ptr, header.size, p_config) &&
+                     true == save(p_config))
+            {
+                data_vld = DATA_VALID;
+            }
+        }
+        return data_vld;
+    }
+
+    /**
+     * @brief This function saves a config struct with its current schema version.
+     * 
+     * @param p_config input: The config struct
+     * @retval true if the struct is written successfully
+     * @retval false otherwise
+     */
+    template <typename T_CONFIG>
+    static bool save(const T_CONFIG & p_config)
+    {
+        static_assert(std::is_trivially_copyable<T_CONFIG>::value, "Config structs must be trivially copyable");
+
+        uint8_t section[EEPROM_SECTION_HEADER_SIZE + sizeof(T_CONFIG)];
+        eeprom_section_header_t header = {T_CONFIG::SCHEMA_VERSION, (uint16_t)sizeof(T_CONFIG)};
+        memcpy(section, &header, sizeof(header));
+        memcpy(&section[EEPROM_SECTION_HEADER_SIZE], &p_config, sizeof(T_CONFIG));
+        return ardal_eeprom_write_data(section, sizeof(section), address_of<T_CONFIG>());
+    }
+};
+
+template <typename... T_SECTIONS>
+constexpr uint32_t eeprom_layout<T_SECTIONS...>::DATA_SIZE;
+
+#endif /* HW_EEPROM_CONFIG_H */
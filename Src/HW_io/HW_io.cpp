@@ -10,9 +10,13 @@
  * Header files.
  ***************************************************************************************************/
 
+/* Log module of this file, defined before debug_logger.h is included */
+#define DBG_MODULE LOG_MODULE_HW_IO
+
 #include "Arduino.h"
 #include "HW_io.h"
 #include "debug_logger.h"
+#include "debug_trace.h"
 #include "esp32-hal-gpio.h"
 #include "pin_def.h"
 
@@ -46,6 +50,7 @@ volatile input_pins_hndlr_t g_input_pins_hndlrs[GPIO_NUM_MAX];
 
 static IRAM_ATTR void isr_gpio_cb(void *arg)
 {
+  TRACE_SCOPE("gpio_isr");
   volatile input_pins_hndlr_t * pin_hndlr_ptr = &g_input_pins_hndlrs[(uint32_t)arg];
   uint8_t state = digitalRead((uint32_t)arg);
   pin_hndlr_ptr->signal = SIGNAL_INVALID;
@@ -10,9 +10,13 @@
 * Header files.
 ***************************************************************************************************/
 
+/* Log module of this file, defined before debug_logger.h is included */
+#define DBG_MODULE LOG_MODULE_HW_TIMER
+
 #include "Arduino.h"
 #include "HW_timer.h"
 #include "debug_logger.h"
+#include "debug_trace.h"
 #include "esp32-hal-timer.h"
 
 /***************************************************************************************************
@@ -79,6 +83,7 @@ void ardal_timer_main()
     /* Check if the semaphore is taken */
     if(xSemaphoreTake(s_timer_semaphore, 10) == pdTRUE)
     {
+        TRACE_SCOPE("ardal_timer_main");
         /* Iterate over the user timers */
         for(uint8_t i = 0; i < TIMERS_COUNT; i++)
         {
@@ -91,7 +96,7 @@ void ardal_timer_main()
                     s_user_timers[i].timer_counter
                 )
                 {
-                    logger_d_p1("User timer %d is fired\n", i);
+                    logger_d("User timer %d is fired\n", i);
                     /* If the timer is one shot, deactivate it */
                     if(s_user_timers[i].one_shot == true)
                     {
@@ -166,7 +171,7 @@ timer_handler_t * ardal_timer_allocate(uint32_t p_time_period,
             s_user_timers[i].one_shot = p_one_shot;
             s_user_timers[i].user_timer_hnd.timer_id = i;
             user_timer = &(s_user_timers[i].user_timer_hnd);
-            logger_d_p1("User timer %d is allocated\n", i);
+            logger_d("User timer %d is allocated\n", i);
             break;
         }
     }
@@ -12,7 +12,14 @@
 
 #include "debug_logger.h"
 #include "string_util.h"
+#include <atomic>
+#include <math.h>
+#if defined(__linux__)
+#include "debug_logger_host.h"
+#else
 #include <Arduino.h>
+#include <esp_timer.h>
+#endif
 
 /***************************************************************************************************
  * Macro definitions.
@@ -27,75 +34,1114 @@
 #define DBG_LOG_FUNC "\033[1m[FUNC: "
 #define DBG_LOG_RESET "]\033[0m ->"
 
+#define DBG_LOG_PLAIN_FUNC "[FUNC: "
+#define DBG_LOG_PLAIN_RESET "] ->"
+
+#define LOG_QUEUE_MASK (LOG_QUEUE_DEPTH - 1U)
+#define LOG_DRAIN_TASK_NAME "log_drain"
+#define LOG_DRAIN_TASK_STACK_SIZE (3072U)
+#define LOG_DRAIN_TASK_PRIORITY (tskIDLE_PRIORITY + 1U)
+/* The drain task also wakes up periodically in case a notification was missed */
+#define LOG_DRAIN_PERIOD_MS (100U)
+
+/* Binary record: sync, length, level, argument count, core id, sequence number, format address,
+   function address, timestamp in us, then one type byte and 4 or 8 value bytes per argument.
+   All little endian, the addresses have the native pointer width (4 bytes on the ESP32) */
+#define LOG_BIN_SYNC (0xA5U)
+#define LOG_DROPPED_FMT "%d log records dropped\n"
+/* Float arguments of integer conversions are clamped to the int64_t range, 2^63 is not an int64_t */
+#define LOG_FLOAT_INT64_LIMIT (9223372036854775808.0F)
+
+#define LOG_RATE_TABLE_MASK (LOG_RATE_TABLE_SIZE - 1U)
+/* Time that refills an empty bucket, a longer time refills no more */
+#define LOG_RATE_FULL_REFILL_MS (((LOG_RATE_BURST * 1000U) + LOG_RATE_PER_SEC - 1U) / LOG_RATE_PER_SEC)
+#define LOG_SUPPRESSED_FMT "%d messages suppressed\n"
+#define LOG_REPEATED_FMT "Last message repeated %d times\n"
+
+/* Call site stamp. The timestamp is read from the free running 64-bit system timer, it is shared by
+   both cores and does not change with the CPU frequency, unlike the per core cycle counter.
+   It is kept in 64 bits, 32 bits of microseconds would wrap after 71.6 minutes */
+#define LOG_GET_TIME_US() ((uint64_t)esp_timer_get_time())
+#define LOG_GET_CORE_ID() ((uint8_t)xPortGetCoreID())
+
 #if BLT_DEBUG
 #define BLT_SERIAL_NAME "BLT_DBG"
 #define BLT_SERIAL Serial_BT
 #endif
 #if UART_DEBUG
 #define UART_SERIAL Serial
+#define UART_SINK_FORMAT ((LOG_BINARY_EN) ? LOG_FORMAT_BINARY : LOG_FORMAT_TEXT)
 #endif
 
+#if defined(__linux__)
+/* Host stand-in of the Bluetooth sink */
+#ifndef LOG_HOST_FILE_PATH
+#define LOG_HOST_FILE_PATH "debug_bt.log"
+#endif
+/* When set, the host UART sink takes the bytes and discards them instead of writing them to stdout,
+   so a benchmark times the logger and not the terminal */
+#ifndef LOG_HOST_UART_STUB
+#define LOG_HOST_UART_STUB (0)
+#endif
+#endif /* __linux__ */
+
+#define LOG_CRASH_MAGIC_NUMBER_VAL (0x4c4f4753U)
+
 /***************************************************************************************************
  * Local type definitions.
  ***************************************************************************************************/
 
+/* Where and when a message was logged. Time and core are taken before the message is filtered,
+   the sequence number when it enters the queue */
+typedef struct log_stamp_t_struct
+{
+    uint64_t timestamp_us;
+    uint32_t sequence;
+    uint8_t core_id;
+} log_stamp_t;
+
+/* Token bucket of one call site, the call site is identified by its format string */
+typedef struct log_rate_entry_t_struct
+{
+    const char * msg_ptr;
+    const char * func_name_ptr;
+    uint32_t refill_ms;
+    uint32_t suppressed;
+    uint8_t tokens;
+    uint8_t lvl;
+} log_rate_entry_t;
+
+/* Last message, to collapse consecutive duplicates */
+typedef struct log_last_msg_t_struct
+{
+    const char * msg_ptr;
+    uint32_t args_hash;
+    uint32_t repeats;
+    debug_level_t lvl;
+    const char * func_name_ptr;
+} log_last_msg_t;
+
+/* Decoded binary record */
+typedef struct log_record_t_struct
+{
+    debug_level_t lvl;
+    const char * func_name_ptr;
+    const char * msg_ptr;
+    log_stamp_t stamp;
+    uint8_t arg_count;
+    log_arg_t args[LOG_MAX_ARGS];
+} log_record_t;
+
+#if LOG_CRASH_BUFFER_SIZE > 0
+/* Ring of rendered text in no-init RTC memory, the check word tells a kept ring from power-on garbage */
+typedef struct log_crash_ring_t_struct
+{
+    uint32_t magic;
+    uint32_t head;
+    uint32_t count;
+    uint32_t check;
+    uint8_t data[LOG_CRASH_BUFFER_SIZE];
+} log_crash_ring_t;
+#endif /* LOG_CRASH_BUFFER_SIZE */
+
+/* Cell of the bounded multi-producer queue, the sequence tells whether the cell is free or filled.
+   The sequence is stored minus the cell index, so the zero-initialized queue starts with all cells free */
+typedef struct log_cell_t_struct
+{
+    std::atomic<uint32_t> sequence;
+    uint16_t length;
+    /* Segment table of the call site, NULL for the records of the logger itself */
+    const log_fmt_segment_t * segments_ptr;
+    uint8_t record[LOG_RECORD_MAX_LEN];
+} log_cell_t;
+
 /***************************************************************************************************
  * Local data definitions.
  ***************************************************************************************************/
 
-#if BLT_DEBUG
+#if BLT_DEBUG && !defined(__linux__)
 #include "BluetoothSerial.h"
 BluetoothSerial Serial_BT;
 #endif
 
-static char g_debug_msg[MAX_DBG_MSG_LEN] = {'\0'};
-static debug_level_t g_debug_thld = DBG_LVL_DEBUG;
+
+static log_cell_t s_log_queue[LOG_QUEUE_DEPTH];
+static std::atomic<uint32_t> s_enqueue_pos(0U);
+/* Every record that tries to enter the queue takes a number, a dropped one leaves a gap */
+static std::atomic<uint32_t> s_log_sequence(0U);
+/* Written by the single consumer, read by debug_agents_flush() on other tasks */
+static std::atomic<uint32_t> s_dequeue_pos(0U);
+static TaskHandle_t s_drain_task_hnd = NULL;
+
+static std::atomic<uint32_t> s_enqueued_count(0U);
+static std::atomic<uint32_t> s_dropped_count(0U);
+static std::atomic<uint32_t> s_truncated_count(0U);
+static std::atomic<uint32_t> s_suppressed_count(0U);
+static std::atomic<uint32_t> s_repeated_count(0U);
+
+/* Filter state is shared by both cores and the drain task */
+static portMUX_TYPE s_filter_mux = portMUX_INITIALIZER_UNLOCKED;
+static log_rate_entry_t s_rate_table[LOG_RATE_TABLE_SIZE];
+static log_last_msg_t s_last_msg;
+static uint32_t s_reported_drops = 0U;
+
+/* Sinks are only used by the single consumer, the table is guarded for registration */
+static portMUX_TYPE s_sink_mux = portMUX_INITIALIZER_UNLOCKED;
+static log_sink_t * s_sinks[LOG_MAX_SINKS];
+static std::atomic_flag s_is_draining = ATOMIC_FLAG_INIT;
+static log_record_t s_drain_record;
+static char s_render_buf[LOG_TEXT_MAX_LEN];
+
+#if LOG_CRASH_BUFFER_SIZE > 0
+RTC_NOINIT_ATTR static log_crash_ring_t s_crash_ring;
+static uint32_t s_crash_prev_count = 0U;
+static uint32_t s_crash_prev_end = 0U;
+static uint32_t s_crash_written = 0U;
+/* The ring is written by the producers of ERR and WARN records on both cores and by the drain task */
+static portMUX_TYPE s_crash_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool s_is_crash_ring_ready = false;
+#endif /* LOG_CRASH_BUFFER_SIZE */
 
 /***************************************************************************************************
  * Local function definitions.
  ***************************************************************************************************/
 
-static uint16_t check_param_qualifier(const char * p_ptr_msg)
+static void add_function_name(string_builder_t * p_ptr_text, const char * p_ptr_func_name, bool p_is_colored)
 {
-    const char qualifiers[] = "fdx";
-    uint16_t msg_len = 0;
-    if(p_ptr_msg[0] == '%')
+    if (true == p_is_colored)
     {
-        for(uint8_t i = 1; ((p_ptr_msg[i] != '\0' && msg_len == 0) && p_ptr_msg[i] != ' '); i++)
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_text, DBG_LOG_FUNC);
+        string_builder_append_str(p_ptr_text, p_ptr_func_name);
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_text, DBG_LOG_RESET);
+    }
+    else
+    {
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_text, DBG_LOG_PLAIN_FUNC);
+        string_builder_append_str(p_ptr_text, p_ptr_func_name);
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_text, DBG_LOG_PLAIN_RESET);
+    }
+}
+
+/**
+ * @brief Renders the stamp as "[seconds.micros core#sequence] ".
+ */
+static void log_format_stamp(string_builder_t * p_ptr_text, const log_stamp_t * p_ptr_stamp)
+{
+    /* One 64-bit division, the seconds fit in 32 bits for 136 years */
+    uint32_t seconds = (uint32_t)(p_ptr_stamp->timestamp_us / 1000000U);
+
+    string_builder_append_char(p_ptr_text, '[');
+    string_builder_append_u32(p_ptr_text, seconds);
+    string_builder_append_char(p_ptr_text, '.');
+    string_builder_append_padded_u32(p_ptr_text, (uint32_t)(p_ptr_stamp->timestamp_us - ((uint64_t)seconds * 1000000U)), 6U);
+    string_builder_append_char(p_ptr_text, ' ');
+    string_builder_append_u32(p_ptr_text, p_ptr_stamp->core_id);
+    string_builder_append_char(p_ptr_text, '#');
+    string_builder_append_u32(p_ptr_text, p_ptr_stamp->sequence);
+    STRING_BUILDER_APPEND_LITERAL(p_ptr_text, "] ");
+}
+
+/**
+ * @brief Appends one argument for the conversion character, hexadecimal prints the raw bits.
+ *        A float is truncated for the integer conversions, nan and inf are printed as text.
+ */
+static void log_format_value(string_builder_t * p_ptr_text,
+                             const log_arg_t * p_ptr_arg,
+                             char p_conversion,
+                             uint32_t p_decimals)
+{
+    bool is_negative = false;
+    uint64_t magnitude = 0U;
+
+    if ((p_conversion != 'f') && (LOG_ARG_FLOAT == p_ptr_arg->type) && !isfinite(p_ptr_arg->value.f32))
+    {
+        string_builder_append_float(p_ptr_text, p_ptr_arg->value.f32, 0);
+    }
+    else if (p_conversion == 'f')
+    {
+        switch (p_ptr_arg->type)
+        {
+        case LOG_ARG_FLOAT:
+            string_builder_append_float(p_ptr_text, p_ptr_arg->value.f32, p_decimals);
+            break;
+        /* Integers go through double, it holds 32-bit values exactly */
+        case LOG_ARG_INT32:
+            string_builder_append_double(p_ptr_text, (double)p_ptr_arg->value.i32, p_decimals);
+            break;
+        case LOG_ARG_UINT32:
+            string_builder_append_double(p_ptr_text, (double)p_ptr_arg->value.u32, p_decimals);
+            break;
+        case LOG_ARG_INT64:
+            string_builder_append_double(p_ptr_text, (double)p_ptr_arg->value.i64, p_decimals);
+            break;
+        default:
+            string_builder_append_double(p_ptr_text, (double)p_ptr_arg->value.u64, p_decimals);
+            break;
+        }
+    }
+    else
+    {
+        switch (p_ptr_arg->type)
+        {
+        case LOG_ARG_FLOAT:
+            is_negative = (p_ptr_arg->value.f32 < 0.0F);
+            if (p_ptr_arg->value.f32 >= LOG_FLOAT_INT64_LIMIT)
+            {
+                magnitude = (uint64_t)INT64_MAX;
+            }
+            else if (p_ptr_arg->value.f32 <= -LOG_FLOAT_INT64_LIMIT)
+            {
+                magnitude = (uint64_t)INT64_MIN;
+            }
+            else
+            {
+                magnitude = (uint64_t)(int64_t)p_ptr_arg->value.f32;
+            }
+            break;
+        case LOG_ARG_INT32:
+            is_negative = (p_ptr_arg->value.i32 < 0);
+            magnitude = (uint64_t)(int64_t)p_ptr_arg->value.i32;
+            break;
+        case LOG_ARG_UINT32:
+            magnitude = p_ptr_arg->value.u32;
+            break;
+        case LOG_ARG_INT64:
+            is_negative = (p_ptr_arg->value.i64 < 0);
+            magnitude = (uint64_t)p_ptr_arg->value.i64;
+            break;
+        default:
+            magnitude = p_ptr_arg->value.u64;
+            break;
+        }
+
+        if (p_conversion == 'x')
         {
-            for(uint8_t j = 0; (qualifiers[j] != '\0' && msg_len == 0); j++)
+            /* Negative 32-bit values are printed as their 32-bit two's complement */
+            if ((true == is_negative) && (p_ptr_arg->type != LOG_ARG_INT64))
             {
-                if(p_ptr_msg[i] == qualifiers[j])
+                magnitude &= UINT32_MAX;
+            }
+            string_builder_append_hex64(p_ptr_text, magnitude);
+        }
+        else if (true == is_negative)
+        {
+            string_builder_append_i64(p_ptr_text, (int64_t)magnitude);
+        }
+        else
+        {
+            /* Values that fit in 32 bits take the 32-bit path, without 64-bit divisions */
+            string_builder_append_u64(p_ptr_text, magnitude);
+        }
+    }
+}
+
+static void log_append_repeated(string_builder_t * p_ptr_text, char p_char, uint32_t p_count)
+{
+    for (uint32_t i = 0; i < p_count; i++)
+    {
+        string_builder_append_char(p_ptr_text, p_char);
+    }
+}
+
+/**
+ * @brief Appends one argument for its specifier. Without flags and width it is rendered straight
+ *        into the text, else on the stack first and then padded the way Tools/log_decoder does it.
+ */
+static void log_format_arg(string_builder_t * p_ptr_text, const log_arg_t * p_ptr_arg, const log_fmt_segment_t * p_ptr_spec)
+{
+    char value_buf[STRING_FTOA_MAX_LEN];
+    string_builder_t value;
+    const char * digits_ptr = value_buf;
+    uint32_t digits_len = 0U;
+    uint32_t width = (p_ptr_spec->width > LOG_FMT_MAX_WIDTH) ? LOG_FMT_MAX_WIDTH : p_ptr_spec->width;
+    uint32_t decimals = (p_ptr_spec->precision == LOG_FMT_NO_PRECISION) ? 3U : p_ptr_spec->precision;
+    uint32_t len = 0U;
+    uint32_t pad = 0U;
+    uint8_t flags = p_ptr_spec->flags;
+    char sign = '\0';
+    bool is_prefixed = ((0U != (flags & LOG_FMT_FLAG_ALT)) && (p_ptr_spec->conversion == 'x'));
+
+    if (decimals > STRING_FTOA_MAX_DECIMALS)
+    {
+        decimals = STRING_FTOA_MAX_DECIMALS;
+    }
+
+    if ((0U == flags) && (0U == width))
+    {
+        log_format_value(p_ptr_text, p_ptr_arg, p_ptr_spec->conversion, decimals);
+    }
+    else
+    {
+        string_builder_init(&value, value_buf, sizeof(value_buf));
+        log_format_value(&value, p_ptr_arg, p_ptr_spec->conversion, decimals);
+        digits_len = value.length;
+        if ((digits_len > 0U) && (value_buf[0] == '-'))
+        {
+            sign = '-';
+            digits_ptr++;
+            digits_len--;
+        }
+        else if (0U != (flags & LOG_FMT_FLAG_PLUS))
+        {
+            sign = '+';
+        }
+        else if (0U != (flags & LOG_FMT_FLAG_SPACE))
+        {
+            sign = ' ';
+        }
+        /* Left justification wins over zero padding */
+        if (0U != (flags & LOG_FMT_FLAG_LEFT))
+        {
+            flags &= (uint8_t)~LOG_FMT_FLAG_ZERO;
+        }
+
+        len = digits_len + ((sign != '\0') ? 1U : 0U) + ((true == is_prefixed) ? 2U : 0U);
+        pad = (width > len) ? (width - len) : 0U;
+        if (0U == (flags & (LOG_FMT_FLAG_LEFT | LOG_FMT_FLAG_ZERO)))
+        {
+            log_append_repeated(p_ptr_text, ' ', pad);
+        }
+        if (sign != '\0')
+        {
+            string_builder_append_char(p_ptr_text, sign);
+        }
+        if (true == is_prefixed)
+        {
+            STRING_BUILDER_APPEND_LITERAL(p_ptr_text, "0x");
+        }
+        if (0U != (flags & LOG_FMT_FLAG_ZERO))
+        {
+            log_append_repeated(p_ptr_text, '0', pad);
+        }
+        string_builder_append(p_ptr_text, digits_ptr, digits_len);
+        if (0U != (flags & LOG_FMT_FLAG_LEFT))
+        {
+            log_append_repeated(p_ptr_text, ' ', pad);
+        }
+    }
+}
+
+/**
+ * @brief Renders the log message as text, only the produced bytes are written.
+ *        Everything lives in the builder and on the stack, so it can run on both cores at once.
+ *        The stamp is optional.
+ */
+static void log_format_text(string_builder_t * p_ptr_text,
+                            const log_stamp_t * p_ptr_stamp,
+                            debug_level_t p_lvl,
+                            const char * p_ptr_func_name,
+                            const log_fmt_segment_t * p_ptr_segments,
+                            const char * p_ptr_msg,
+                            const log_arg_t * p_ptr_args,
+                            uint8_t p_arg_count,
+                            bool p_is_colored)
+{
+    uint8_t arg_idx = 0U;
+    uint16_t qualifier_idx = 0;
+    uint16_t literal_start = 0U;
+    uint16_t segment_pos = 0U;
+    uint16_t i = 0U;
+    log_fmt_segment_t spec;
+    static const char * const log_strings[] = {
+        "",
+        DBG_LOG_COLOR_E,
+        DBG_LOG_COLOR_W,
+        DBG_LOG_COLOR_I,
+        DBG_LOG_COLOR_P,
+        DBG_LOG_COLOR_D
+    };
+    static const char * const log_plain_strings[] = {
+        "",
+        "[ERROR] ",
+        "[ WARN] ",
+        "[ INFO] ",
+        "[PRDIC] ",
+        "[DEBUG] "
+    };
+    const char * const * prefix_strings = (true == p_is_colored) ? log_strings : log_plain_strings;
+
+    if(p_ptr_msg[0] == '\n')
+    {
+        string_builder_append_char(p_ptr_text, '\n');
+        i = 1U;
+    }
+    if(p_ptr_msg[i] != '\0')
+    {
+#if LOG_TEXT_STAMP_EN
+        if (p_ptr_stamp != NULL)
+        {
+            log_format_stamp(p_ptr_text, p_ptr_stamp);
+        }
+#else
+        (void)p_ptr_stamp;
+#endif
+        string_builder_append_str(p_ptr_text, prefix_strings[p_lvl]);
+
+        if(p_ptr_func_name != NULL)
+        {
+            add_function_name(p_ptr_text, p_ptr_func_name, p_is_colored);
+        }
+
+        /* Literal runs are copied in one go, only the specifiers are expanded */
+        literal_start = i;
+        if (NULL != p_ptr_segments)
+        {
+            /* The table of the call site has the runs and specifiers, the format is not scanned */
+            for (; (p_ptr_segments[arg_idx].conversion != '\0') && (arg_idx < p_arg_count); arg_idx++)
+            {
+                segment_pos += p_ptr_segments[arg_idx].literal_len;
+                string_builder_append(p_ptr_text, &p_ptr_msg[literal_start], segment_pos - literal_start);
+                log_format_arg(p_ptr_text, &p_ptr_args[arg_idx], &p_ptr_segments[arg_idx]);
+                segment_pos += p_ptr_segments[arg_idx].spec_len;
+                literal_start = segment_pos;
+            }
+            if (p_ptr_segments[arg_idx].conversion == '\0')
+            {
+                string_builder_append(p_ptr_text, &p_ptr_msg[literal_start],
+                                      (segment_pos + p_ptr_segments[arg_idx].literal_len) - literal_start);
+            }
+            else
+            {
+                string_builder_append_str(p_ptr_text, &p_ptr_msg[literal_start]);
+            }
+        }
+        else
+        {
+            for (; (i < MAX_DBG_MSG_LEN) && (p_ptr_msg[i] != '\0'); i++)
+            {
+                /* Same scanner as the compile time check of the logger_x macros */
+                qualifier_idx = log_fmt_spec_len(&p_ptr_msg[i]);
+                if ((qualifier_idx > 0) && (arg_idx < p_arg_count))
                 {
-                    msg_len = i;
+                    string_builder_append(p_ptr_text, &p_ptr_msg[literal_start], i - literal_start);
+                    spec = log_fmt_make_segment(&p_ptr_msg[i], 0U, 0U);
+                    log_format_arg(p_ptr_text, &p_ptr_args[arg_idx++], &spec);
+                    i += qualifier_idx;
+                    literal_start = i + 1U;
                 }
             }
+            string_builder_append(p_ptr_text, &p_ptr_msg[literal_start], i - literal_start);
         }
     }
-    return msg_len;
+}
+static uint16_t log_put_u32(uint8_t * p_ptr_buf, uint32_t p_val)
+{
+    p_ptr_buf[0] = (uint8_t)(p_val);
+    p_ptr_buf[1] = (uint8_t)(p_val >> 8);
+    p_ptr_buf[2] = (uint8_t)(p_val >> 16);
+    p_ptr_buf[3] = (uint8_t)(p_val >> 24);
+    return 4U;
 }
 
-static uint16_t add_function_name(const char * p_ptr_func_name,
-                                  char * p_ptr_msg)
+static uint32_t log_get_u32(const uint8_t * p_ptr_buf)
 {
-    uint16_t bytes_written = 0;
-    uint16_t func_name_len = strlen(p_ptr_func_name);
-    memcpy(&p_ptr_msg[bytes_written], DBG_LOG_FUNC, sizeof(DBG_LOG_FUNC) - 1);
-    bytes_written = sizeof(DBG_LOG_FUNC) - 1;
+    return ((uint32_t)p_ptr_buf[0]) | ((uint32_t)p_ptr_buf[1] << 8) |
+           ((uint32_t)p_ptr_buf[2] << 16) | ((uint32_t)p_ptr_buf[3] << 24);
+}
 
-    for(uint16_t i = 0; i < func_name_len; i++)
+/**
+ * @brief Encodes a binary record, nothing is formatted by the caller.
+ *        The format and function name are referenced by address, so they must be string literals.
+ */
+static uint16_t log_encode_binary(uint8_t * p_ptr_buf,
+                                  const log_stamp_t * p_ptr_stamp,
+                                  debug_level_t p_lvl,
+                                  const char * p_ptr_func_name,
+                                  const char * p_ptr_msg,
+                                  const log_arg_t * p_ptr_args,
+                                  uint8_t p_arg_count)
+{
+    uint16_t bytes_written = 0U;
+
+    p_ptr_buf[bytes_written++] = LOG_BIN_SYNC;
+    bytes_written++; /* Length is known once the arguments are written */
+    p_ptr_buf[bytes_written++] = (uint8_t)p_lvl;
+    p_ptr_buf[bytes_written++] = p_arg_count;
+    p_ptr_buf[bytes_written++] = p_ptr_stamp->core_id;
+    bytes_written += log_put_u32(&p_ptr_buf[bytes_written], p_ptr_stamp->sequence);
+    memcpy(&p_ptr_buf[bytes_written], &p_ptr_msg, sizeof(p_ptr_msg));
+    bytes_written += sizeof(p_ptr_msg);
+    memcpy(&p_ptr_buf[bytes_written], &p_ptr_func_name, sizeof(p_ptr_func_name));
+    bytes_written += sizeof(p_ptr_func_name);
+    bytes_written += log_put_u32(&p_ptr_buf[bytes_written], (uint32_t)p_ptr_stamp->timestamp_us);
+    bytes_written += log_put_u32(&p_ptr_buf[bytes_written], (uint32_t)(p_ptr_stamp->timestamp_us >> 32));
+    for (uint8_t i = 0; i < p_arg_count; i++)
     {
-        p_ptr_msg[bytes_written++] = p_ptr_func_name[i];
+        p_ptr_buf[bytes_written++] = p_ptr_args[i].type;
+        bytes_written += log_put_u32(&p_ptr_buf[bytes_written], (uint32_t)p_ptr_args[i].value.u64);
+        if ((p_ptr_args[i].type == LOG_ARG_INT64) || (p_ptr_args[i].type == LOG_ARG_UINT64))
+        {
+            bytes_written += log_put_u32(&p_ptr_buf[bytes_written], (uint32_t)(p_ptr_args[i].value.u64 >> 32));
+        }
     }
-    memcpy(&p_ptr_msg[bytes_written], DBG_LOG_RESET, sizeof(DBG_LOG_RESET) - 1);
-    bytes_written += sizeof(DBG_LOG_RESET) - 1;
+    p_ptr_buf[1] = (uint8_t)bytes_written;
     return bytes_written;
 }
 
+static void log_decode_binary(const uint8_t * p_ptr_buf, log_record_t * p_ptr_record)
+{
+    uint16_t bytes_read = 2U;
+
+    p_ptr_record->lvl = (debug_level_t)p_ptr_buf[bytes_read++];
+    p_ptr_record->arg_count = p_ptr_buf[bytes_read++];
+    p_ptr_record->stamp.core_id = p_ptr_buf[bytes_read++];
+    p_ptr_record->stamp.sequence = log_get_u32(&p_ptr_buf[bytes_read]);
+    bytes_read += 4U;
+    memcpy(&p_ptr_record->msg_ptr, &p_ptr_buf[bytes_read], sizeof(p_ptr_record->msg_ptr));
+    bytes_read += sizeof(p_ptr_record->msg_ptr);
+    memcpy(&p_ptr_record->func_name_ptr, &p_ptr_buf[bytes_read], sizeof(p_ptr_record->func_name_ptr));
+    bytes_read += sizeof(p_ptr_record->func_name_ptr);
+    p_ptr_record->stamp.timestamp_us = log_get_u32(&p_ptr_buf[bytes_read]);
+    p_ptr_record->stamp.timestamp_us |= (uint64_t)log_get_u32(&p_ptr_buf[bytes_read + 4U]) << 32;
+    bytes_read += 8U;
+    for (uint8_t i = 0; i < p_ptr_record->arg_count; i++)
+    {
+        p_ptr_record->args[i].type = p_ptr_buf[bytes_read++];
+        p_ptr_record->args[i].value.u64 = 0U;
+        p_ptr_record->args[i].value.u32 = log_get_u32(&p_ptr_buf[bytes_read]);
+        bytes_read += 4U;
+        if ((p_ptr_record->args[i].type == LOG_ARG_INT64) || (p_ptr_record->args[i].type == LOG_ARG_UINT64))
+        {
+            p_ptr_record->args[i].value.u64 |= (uint64_t)log_get_u32(&p_ptr_buf[bytes_read]) << 32;
+            bytes_read += 4U;
+        }
+    }
+}
+
+static inline uint32_t log_cell_load_sequence(uint32_t p_pos)
+{
+    return s_log_queue[p_pos & LOG_QUEUE_MASK].sequence.load(std::memory_order_acquire) + (p_pos & LOG_QUEUE_MASK);
+}
+
+static inline void log_cell_store_sequence(uint32_t p_pos, uint32_t p_sequence)
+{
+    s_log_queue[p_pos & LOG_QUEUE_MASK].sequence.store(p_sequence - (p_pos & LOG_QUEUE_MASK), std::memory_order_release);
+}
+
+/**
+ * @brief Claims a free cell, lock-free for any number of producers. The producer encodes
+ *        straight into the cell and then publishes it, so no intermediate buffer is needed.
+ * @retval The claimed cell, NULL if the queue is full and the record has to be dropped
+ */
+static log_cell_t * log_queue_reserve(uint32_t * p_ptr_pos)
+{
+    log_cell_t * cell_ptr = NULL;
+    uint32_t pos = s_enqueue_pos.load(std::memory_order_relaxed);
+    int32_t diff = 0;
+
+    for (;;)
+    {
+        diff = (int32_t)(log_cell_load_sequence(pos) - pos);
+        if (diff == 0)
+        {
+            if (s_enqueue_pos.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed))
+            {
+                cell_ptr = &s_log_queue[pos & LOG_QUEUE_MASK];
+                *p_ptr_pos = pos;
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* The consumer has not freed this cell yet, the queue is full */
+            s_dropped_count.fetch_add(1U, std::memory_order_relaxed);
+            break;
+        }
+        else
+        {
+            pos = s_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    return cell_ptr;
+}
+
+static void log_queue_publish(log_cell_t * p_ptr_cell, uint32_t p_pos, uint16_t p_length)
+{
+    p_ptr_cell->length = p_length;
+    log_cell_store_sequence(p_pos, p_pos + 1U);
+    s_enqueued_count.fetch_add(1U, std::memory_order_relaxed);
+}
+
+static bool log_queue_is_empty(void)
+{
+    uint32_t pos = s_dequeue_pos.load(std::memory_order_acquire);
+    return (log_cell_load_sequence(pos) != (pos + 1U));
+}
+
+static void log_take_stamp(log_stamp_t * p_ptr_stamp)
+{
+    p_ptr_stamp->timestamp_us = LOG_GET_TIME_US();
+    p_ptr_stamp->core_id = LOG_GET_CORE_ID();
+    p_ptr_stamp->sequence = 0U;
+}
+
+#if LOG_CRASH_BUFFER_SIZE > 0
+static uint32_t log_crash_check(void)
+{
+    return s_crash_ring.magic ^ s_crash_ring.head ^ s_crash_ring.count;
+}
+
+/**
+ * @brief Keeps the ring of the previous boot if it survived the reset, starts a new one otherwise.
+ */
+static void log_crash_init(void)
+{
+    portENTER_CRITICAL(&s_crash_mux);
+    if ((s_crash_ring.magic != LOG_CRASH_MAGIC_NUMBER_VAL) || (s_crash_ring.check != log_crash_check()) ||
+        (s_crash_ring.head >= LOG_CRASH_BUFFER_SIZE) || (s_crash_ring.count > LOG_CRASH_BUFFER_SIZE))
+    {
+        s_crash_ring.magic = LOG_CRASH_MAGIC_NUMBER_VAL;
+        s_crash_ring.head = 0U;
+        s_crash_ring.count = 0U;
+        s_crash_ring.check = log_crash_check();
+    }
+    s_crash_prev_count = s_crash_ring.count;
+    s_crash_prev_end = s_crash_ring.head;
+    s_crash_written = 0U;
+    s_is_crash_ring_ready = true;
+    portEXIT_CRITICAL(&s_crash_mux);
+}
+
+/**
+ * @brief Appends bytes to the ring, the caller holds s_crash_mux.
+ */
+static void log_crash_append(const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    uint32_t chunk_size = 0U;
+    uint16_t bytes_written = 0U;
+
+    while (bytes_written < p_len)
+    {
+        chunk_size = LOG_CRASH_BUFFER_SIZE - s_crash_ring.head;
+        if (chunk_size > (uint32_t)(p_len - bytes_written))
+        {
+            chunk_size = p_len - bytes_written;
+        }
+        memcpy(&s_crash_ring.data[s_crash_ring.head], &p_ptr_data[bytes_written], chunk_size);
+        s_crash_ring.head = (s_crash_ring.head + chunk_size) % LOG_CRASH_BUFFER_SIZE;
+        bytes_written += chunk_size;
+    }
+    s_crash_ring.count = ((s_crash_ring.count + p_len) > LOG_CRASH_BUFFER_SIZE) ?
+                         LOG_CRASH_BUFFER_SIZE : (s_crash_ring.count + p_len);
+    s_crash_ring.check = log_crash_check();
+    s_crash_written += p_len;
+}
+
+static uint16_t log_sink_crash_write(void * p_ptr_ctx, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    (void)p_ptr_ctx;
+    portENTER_CRITICAL(&s_crash_mux);
+    log_crash_append(p_ptr_data, p_len);
+    portEXIT_CRITICAL(&s_crash_mux);
+    return p_len;
+}
+
+static log_sink_t s_crash_sink = {"crash", log_sink_crash_write, NULL, DBG_LVL_DEBUG, LOG_FORMAT_PLAIN, 0U};
+
+/**
+ * @brief Copies an ERR or WARN record into the ring, so it survives a reset that comes before the
+ *        drain task runs. The crash sink skips these levels when the record is drained.
+ *        The line is rendered on the caller's stack, the lock is only held to append it.
+ */
+static void log_crash_copy(const log_stamp_t * p_ptr_stamp,
+                           debug_level_t p_lvl,
+                           const char * p_ptr_func_name,
+                           const log_fmt_segment_t * p_ptr_segments,
+                           const char * p_ptr_msg,
+                           const log_arg_t * p_ptr_args,
+                           uint8_t p_arg_count)
+{
+    char line[LOG_TEXT_MAX_LEN];
+    string_builder_t text;
+
+    if ((uint8_t)p_lvl <= (uint8_t)s_crash_sink.level)
+    {
+        string_builder_init(&text, line, sizeof(line));
+        log_format_text(&text, p_ptr_stamp, p_lvl, p_ptr_func_name, p_ptr_segments, p_ptr_msg, p_ptr_args,
+                        p_arg_count, (s_crash_sink.format == LOG_FORMAT_TEXT));
+        portENTER_CRITICAL(&s_crash_mux);
+        if (true == s_is_crash_ring_ready)
+        {
+            log_crash_append((const uint8_t *)line, (uint16_t)text.length);
+        }
+        portEXIT_CRITICAL(&s_crash_mux);
+    }
+}
+#endif /* LOG_CRASH_BUFFER_SIZE */
+
+/**
+ * @brief Numbers the record, claims a cell, encodes the record into it and hands it to the drain task.
+ */
+static void log_emit(log_stamp_t * p_ptr_stamp,
+                     debug_level_t p_lvl,
+                     const char * p_ptr_func_name,
+                     const log_fmt_segment_t * p_ptr_segments,
+                     const char * p_ptr_msg,
+                     const log_arg_t * p_ptr_args,
+                     uint8_t p_arg_count)
+{
+    log_cell_t * cell_ptr = NULL;
+    uint32_t pos = 0U;
+    uint16_t bytes_written = 0U;
+
+    p_ptr_stamp->sequence = s_log_sequence.fetch_add(1U, std::memory_order_relaxed);
+#if LOG_CRASH_BUFFER_SIZE > 0
+    /* Copied even if the queue is full, the last errors before a reset matter most */
+    if ((int)p_lvl <= LOG_CRASH_SYNC_LEVEL)
+    {
+        log_crash_copy(p_ptr_stamp, p_lvl, p_ptr_func_name, p_ptr_segments, p_ptr_msg, p_ptr_args, p_arg_count);
+    }
+#endif /* LOG_CRASH_BUFFER_SIZE */
+    cell_ptr = log_queue_reserve(&pos);
+    if (NULL != cell_ptr)
+    {
+        /* Only the raw record is stored, the drain task renders it for each sink */
+        bytes_written = log_encode_binary(cell_ptr->record, p_ptr_stamp, p_lvl, p_ptr_func_name, p_ptr_msg,
+                                          p_ptr_args, p_arg_count);
+        cell_ptr->segments_ptr = p_ptr_segments;
+
+        /* Hand the message to the drain task, the caller does not wait for the sinks */
+        log_queue_publish(cell_ptr, pos, bytes_written);
+        if (NULL != s_drain_task_hnd)
+        {
+            xTaskNotifyGive(s_drain_task_hnd);
+        }
+    }
+}
+
+static uint32_t log_hash_args(const log_arg_t * p_ptr_args, uint8_t p_arg_count)
+{
+    /* FNV-1a over the argument types and values */
+    uint32_t hash = 2166136261U;
+    uint64_t value = 0U;
+
+    for (uint8_t i = 0; i < p_arg_count; i++)
+    {
+        value = p_ptr_args[i].value.u64;
+        hash = (hash ^ p_ptr_args[i].type) * 16777619U;
+        hash = (hash ^ (uint32_t)value) * 16777619U;
+        hash = (hash ^ (uint32_t)(value >> 32)) * 16777619U;
+    }
+    return hash;
+}
+
+/**
+ * @brief Takes a token from the bucket of the call site.
+ *        A call site that takes over the entry of another one gets the entry in p_ptr_evicted
+ *        if messages of the other one were suppressed, its count would be lost otherwise.
+ * @retval true if the message may be logged, false if it is over the rate limit
+ */
+static bool log_rate_take_token(debug_level_t p_lvl,
+                                const char * p_ptr_func_name,
+                                const char * p_ptr_msg,
+                                uint32_t p_now_ms,
+                                uint32_t * p_ptr_suppressed,
+                                log_rate_entry_t * p_ptr_evicted)
+{
+    log_rate_entry_t * entry_ptr = &s_rate_table[((uintptr_t)p_ptr_msg >> 2) & LOG_RATE_TABLE_MASK];
+    uint32_t elapsed_ms = 0U;
+    uint32_t refill = 0U;
+    bool ret_val = false;
+
+    if (entry_ptr->msg_ptr != p_ptr_msg)
+    {
+        if (entry_ptr->suppressed > 0U)
+        {
+            *p_ptr_evicted = *entry_ptr;
+        }
+        /* Direct mapped, a new call site takes over the entry with a full bucket */
+        entry_ptr->msg_ptr = p_ptr_msg;
+        entry_ptr->func_name_ptr = p_ptr_func_name;
+        entry_ptr->refill_ms = p_now_ms;
+        entry_ptr->suppressed = 0U;
+        entry_ptr->tokens = LOG_RATE_BURST;
+        entry_ptr->lvl = (uint8_t)p_lvl;
+    }
+
+    /* Clamped first, so the product can not overflow after a long silence */
+    elapsed_ms = p_now_ms - entry_ptr->refill_ms;
+    if (elapsed_ms > LOG_RATE_FULL_REFILL_MS)
+    {
+        elapsed_ms = LOG_RATE_FULL_REFILL_MS;
+    }
+    refill = (elapsed_ms * LOG_RATE_PER_SEC) / 1000U;
+    if (refill > 0U)
+    {
+        entry_ptr->refill_ms += (refill * 1000U) / LOG_RATE_PER_SEC;
+        if (refill >= (uint32_t)(LOG_RATE_BURST - entry_ptr->tokens))
+        {
+            entry_ptr->tokens = LOG_RATE_BURST;
+            entry_ptr->refill_ms = p_now_ms;
+        }
+        else
+        {
+            entry_ptr->tokens += refill;
+        }
+    }
+
+    if (entry_ptr->tokens > 0U)
+    {
+        entry_ptr->tokens--;
+        *p_ptr_suppressed = entry_ptr->suppressed;
+        entry_ptr->suppressed = 0U;
+        ret_val = true;
+    }
+    else
+    {
+        entry_ptr->suppressed++;
+        s_suppressed_count.fetch_add(1U, std::memory_order_relaxed);
+    }
+    return ret_val;
+}
+
+/**
+ * @brief Gets and clears the number of collapsed repeats of the last message.
+ */
+static uint32_t log_take_repeats(debug_level_t * p_ptr_lvl, const char ** p_ptr_func_name)
+{
+    uint32_t repeats = 0U;
+
+    portENTER_CRITICAL(&s_filter_mux);
+    repeats = s_last_msg.repeats;
+    s_last_msg.repeats = 0U;
+    *p_ptr_lvl = s_last_msg.lvl;
+    *p_ptr_func_name = s_last_msg.func_name_ptr;
+    portEXIT_CRITICAL(&s_filter_mux);
+    return repeats;
+}
+
+static void log_emit_count(log_stamp_t * p_ptr_stamp,
+                           debug_level_t p_lvl,
+                           const char * p_ptr_func_name,
+                           const char * p_ptr_fmt,
+                           uint32_t p_count)
+{
+    log_arg_t count_arg = log_arg_make(p_count);
+    log_emit(p_ptr_stamp, p_lvl, p_ptr_func_name, NULL, p_ptr_fmt, &count_arg, 1U);
+}
+
+#if UART_DEBUG
+static uint16_t log_sink_uart_write(void * p_ptr_ctx, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    (void)p_ptr_ctx;
+#if defined(__linux__)
+#if LOG_HOST_UART_STUB
+    (void)p_ptr_data;
+    return p_len;
+#else
+    return (uint16_t)fwrite(p_ptr_data, 1U, p_len, stdout);
+#endif /* LOG_HOST_UART_STUB */
+#else
+    /* Only what fits in the TX FIFO is taken, the drain task retries the rest */
+    int free_space = UART_SERIAL.availableForWrite();
+    if (free_space <= 0)
+    {
+        p_len = 0U;
+    }
+    else if (p_len > (uint16_t)free_space)
+    {
+        p_len = (uint16_t)free_space;
+    }
+    return (p_len > 0U) ? (uint16_t)UART_SERIAL.write(p_ptr_data, p_len) : 0U;
+#endif /* __linux__ */
+}
+
+static log_sink_t s_uart_sink = {"uart", log_sink_uart_write, NULL, DBG_LVL_DEBUG, UART_SINK_FORMAT, 0U};
+#endif /* UART_DEBUG */
+
+#if BLT_DEBUG
+static uint16_t log_sink_bt_write(void * p_ptr_ctx, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+#if defined(__linux__)
+    FILE * file_ptr = (FILE *)p_ptr_ctx;
+    return (NULL != file_ptr) ? (uint16_t)fwrite(p_ptr_data, 1U, p_len, file_ptr) : p_len;
+#else
+    int free_space = 0;
+
+    (void)p_ptr_ctx;
+    /* Without a connected client the output is discarded instead of filling the stack's queue */
+    if (true == BLT_SERIAL.hasClient())
+    {
+        /* The write waits without a timeout when the queue is full, so only what fits is taken.
+           The drain task retries the rest until LOG_SINK_TIMEOUT_MS and counts it as dropped */
+        free_space = BLT_SERIAL.availableForWrite();
+        if (free_space <= 0)
+        {
+            p_len = 0U;
+        }
+        else if (p_len > (uint16_t)free_space)
+        {
+            p_len = (uint16_t)free_space;
+        }
+        p_len = (p_len > 0U) ? (uint16_t)BLT_SERIAL.write(p_ptr_data, p_len) : 0U;
+    }
+    return p_len;
+#endif /* __linux__ */
+}
+
+static log_sink_t s_bt_sink = {"bt", log_sink_bt_write, NULL, DBG_LVL_DEBUG, LOG_FORMAT_TEXT, 0U};
+#endif /* BLT_DEBUG */
+
+
+/**
+ * @brief Hands the data to a sink, retrying what it could not take until LOG_SINK_TIMEOUT_MS.
+ *        Only the drain task waits here, the producers never do.
+ */
+static void log_sink_output(log_sink_t * p_ptr_sink, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    uint32_t start_ms = (uint32_t)millis();
+    uint16_t bytes_written = 0U;
+
+    while (p_len > 0U)
+    {
+        bytes_written = p_ptr_sink->write(p_ptr_sink->ctx, p_ptr_data, p_len);
+        p_ptr_data += bytes_written;
+        p_len -= bytes_written;
+        if (p_len > 0U)
+        {
+            if (((uint32_t)millis() - start_ms) >= LOG_SINK_TIMEOUT_MS)
+            {
+                p_ptr_sink->drop_count++;
+                break;
+            }
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * @brief Renders one record in the format of every sink that takes its level.
+ */
+static void log_dispatch(const log_cell_t * p_ptr_cell, log_sink_t * const * p_ptr_sinks, uint8_t p_sink_count)
+{
+    const uint8_t * record_ptr = p_ptr_cell->record;
+    string_builder_t text;
+    log_format_t rendered_format = LOG_FORMAT_BINARY;
+    log_sink_t * sink_ptr = NULL;
+    bool is_decoded = false;
+
+    for (uint8_t i = 0; i < p_sink_count; i++)
+    {
+        sink_ptr = p_ptr_sinks[i];
+        if ((uint8_t)record_ptr[2] > (uint8_t)sink_ptr->level)
+        {
+            continue;
+        }
+#if LOG_CRASH_BUFFER_SIZE > 0
+        /* The producer already copied the record into the crash ring */
+        if ((sink_ptr == &s_crash_sink) && ((int)record_ptr[2] <= LOG_CRASH_SYNC_LEVEL))
+        {
+            continue;
+        }
+#endif /* LOG_CRASH_BUFFER_SIZE */
+
+        if (sink_ptr->format == LOG_FORMAT_BINARY)
+        {
+            log_sink_output(sink_ptr, record_ptr, record_ptr[1]);
+        }
+        else
+        {
+            /* The text is rendered once per format and reused by the following sinks */
+            if (false == is_decoded)
+            {
+                log_decode_binary(record_ptr, &s_drain_record);
+                is_decoded = true;
+            }
+            if (rendered_format != sink_ptr->format)
+            {
+                string_builder_init(&text, s_render_buf, LOG_TEXT_MAX_LEN);
+                log_format_text(&text, &s_drain_record.stamp, s_drain_record.lvl, s_drain_record.func_name_ptr,
+                                p_ptr_cell->segments_ptr, s_drain_record.msg_ptr, s_drain_record.args,
+                                s_drain_record.arg_count, (sink_ptr->format == LOG_FORMAT_TEXT));
+                if (true == text.is_truncated)
+                {
+                    s_truncated_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+                rendered_format = sink_ptr->format;
+            }
+            log_sink_output(sink_ptr, (const uint8_t *)s_render_buf, text.length);
+        }
+    }
+}
+
+/**
+ * @brief Writes every filled cell to the sinks. A second caller returns at once,
+ *        there is only one consumer at a time.
+ */
+static void log_drain(void)
+{
+    log_sink_t * sinks[LOG_MAX_SINKS];
+    uint8_t sink_count = 0U;
+    uint32_t drops = 0U;
+    uint32_t repeats = 0U;
+    debug_level_t repeat_lvl = DBG_LVL_DEBUG;
+    const char * repeat_func_name_ptr = NULL;
+    uint32_t pos = 0U;
+    log_stamp_t stamp;
+
+    if (false == s_is_draining.test_and_set(std::memory_order_acquire))
+    {
+        portENTER_CRITICAL(&s_sink_mux);
+        for (uint8_t i = 0; i < LOG_MAX_SINKS; i++)
+        {
+            if (NULL != s_sinks[i])
+            {
+                sinks[sink_count++] = s_sinks[i];
+            }
+        }
+        portEXIT_CRITICAL(&s_sink_mux);
+
+        /* A message repeating in a loop is summarized on every pass instead of being logged each time */
+        repeats = log_take_repeats(&repeat_lvl, &repeat_func_name_ptr);
+        if (repeats > 0U)
+        {
+            log_take_stamp(&stamp);
+            log_emit_count(&stamp, repeat_lvl, repeat_func_name_ptr, LOG_REPEATED_FMT, repeats);
+        }
+
+        do
+        {
+            while (false == log_queue_is_empty())
+            {
+                pos = s_dequeue_pos.load(std::memory_order_relaxed);
+                log_dispatch(&s_log_queue[pos & LOG_QUEUE_MASK], sinks, sink_count);
+                log_cell_store_sequence(pos, pos + LOG_QUEUE_DEPTH);
+                /* Released after the sinks took the record, so a flush that sees it is complete */
+                s_dequeue_pos.store(pos + 1U, std::memory_order_release);
+            }
+
+            /* The drop report goes through the queue, so every sink gets it in its own format */
+            drops = s_dropped_count.load(std::memory_order_relaxed);
+            if (drops != s_reported_drops)
+            {
+                log_take_stamp(&stamp);
+                log_emit_count(&stamp, DBG_LVL_WARN, NULL, LOG_DROPPED_FMT, drops - s_reported_drops);
+                s_reported_drops = drops;
+            }
+        } while (false == log_queue_is_empty());
+
+        s_is_draining.clear(std::memory_order_release);
+    }
+}
+
+static void log_drain_task(void * p_ptr_param)
+{
+    (void)p_ptr_param;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+        log_drain();
+    }
+}
+
 /***************************************************************************************************
  * External data definitions.
  ***************************************************************************************************/
 
+volatile uint8_t g_log_module_thld[LOG_MODULE_COUNT] = {
+    DBG_LVL_DEBUG, DBG_LVL_DEBUG, DBG_LVL_DEBUG, DBG_LVL_DEBUG, DBG_LVL_DEBUG
+};
+
 /***************************************************************************************************
  * External function definitions.
  ***************************************************************************************************/
@@ -103,106 +1149,266 @@ static uint16_t add_function_name(const char * p_ptr_func_name,
 void debug_agents_init()
 {
 #ifdef DEBUG_EN 
+#if LOG_CRASH_BUFFER_SIZE > 0
+    log_crash_init();
+    debug_agents_add_sink(&s_crash_sink);
+#endif /* LOG_CRASH_BUFFER_SIZE */
 #if UART_DEBUG
+#if !defined(__linux__)
     UART_SERIAL.begin(256000);
     delay(100);
+#endif /* __linux__ */
+    debug_agents_add_sink(&s_uart_sink);
     logger_d("UART is ready\n");
 #endif /* UART_DEBUG */
 #if BLT_DEBUG
+#if defined(__linux__)
+    s_bt_sink.ctx = fopen(LOG_HOST_FILE_PATH, "a");
+#else
     BLT_SERIAL.begin(BLT_SERIAL_NAME);
     delay(1000);
     BLT_SERIAL.println("Bluetooth is ready");
+#endif /* __linux__ */
+    debug_agents_add_sink(&s_bt_sink);
 #endif /* BLT_DEBUG */
-delay(100);
+#if !defined(__linux__)
+    delay(100);
+#endif /* __linux__ */
+    if (NULL == s_drain_task_hnd)
+    {
+        xTaskCreate(log_drain_task, LOG_DRAIN_TASK_NAME, LOG_DRAIN_TASK_STACK_SIZE,
+                    NULL, LOG_DRAIN_TASK_PRIORITY, &s_drain_task_hnd);
+    }
 #endif /* DEBUG_EN */
 }
 
-void debug_agents_set_threshold(debug_level_t p_lvl)
+void debug_agents_flush(void)
 {
-    if (p_lvl != DBG_LVL_EXT)
+    if (NULL == s_drain_task_hnd)
     {
-        g_debug_thld = p_lvl;
+        log_drain();
+    }
+    else
+    {
+        /* Let the drain task empty the queue, it is the only consumer */
+        while (false == log_queue_is_empty())
+        {
+            xTaskNotifyGive(s_drain_task_hnd);
+            delay(1);
+        }
     }
 }
 
-void logger(debug_level_t p_lvl,
-            const char * p_ptr_func_name, 
-            const char * p_ptr_msg,
-            float p_param_1, 
-            float p_param_2,
-            float p_param_3)
+bool debug_agents_add_sink(log_sink_t * p_ptr_sink)
 {
-    uint16_t bytes_written = 0U;
-    uint8_t param_count = 0U;
-    float current_param = 0.0;
-    float const p_params_list[] = {p_param_1, p_param_2, p_param_3};
-    uint16_t qualifier_idx = 0;
-    const char * log_strings[] = {
-        "",
-        DBG_LOG_COLOR_E,
-        DBG_LOG_COLOR_W,
-        DBG_LOG_COLOR_I,
-        DBG_LOG_COLOR_P,
-        DBG_LOG_COLOR_D
-    };
+    bool ret_val = false;
 
-    if(p_lvl <= g_debug_thld)
+    if ((NULL != p_ptr_sink) && (NULL != p_ptr_sink->write))
     {
-        memset(g_debug_msg, '\0', MAX_DBG_MSG_LEN);
-        if(p_ptr_msg[0] == '\n' && p_ptr_msg[1] == '\0')
-        {
-            g_debug_msg[bytes_written++] = '\n';
-        }
-        else
+        portENTER_CRITICAL(&s_sink_mux);
+        for (uint8_t i = 0; (i < LOG_MAX_SINKS) && (false == ret_val); i++)
         {
-            if (p_ptr_msg[0] == '\n')
+            if ((NULL == s_sinks[i]) || (s_sinks[i] == p_ptr_sink))
             {
-                g_debug_msg[bytes_written++] = '\n';
+                s_sinks[i] = p_ptr_sink;
+                ret_val = true;
             }
-            
-            strcpy(&g_debug_msg[bytes_written], log_strings[p_lvl]);
-            bytes_written = strlen(log_strings[p_lvl]);
+        }
+        portEXIT_CRITICAL(&s_sink_mux);
+    }
+    return ret_val;
+}
 
-            if(p_ptr_func_name != NULL)
-            {
-                bytes_written += add_function_name(p_ptr_func_name, &g_debug_msg[bytes_written]);
-            }
-            for (uint16_t i = 0; (i < MAX_DBG_MSG_LEN) && (p_ptr_msg[i] != '\0'); i++)
+void debug_agents_remove_sink(log_sink_t * p_ptr_sink)
+{
+    portENTER_CRITICAL(&s_sink_mux);
+    for (uint8_t i = 0; i < LOG_MAX_SINKS; i++)
+    {
+        if (s_sinks[i] == p_ptr_sink)
+        {
+            s_sinks[i] = NULL;
+        }
+    }
+    portEXIT_CRITICAL(&s_sink_mux);
+
+    /* The drain task may still hold the sink from its snapshot, wait for the current pass */
+    while (true == s_is_draining.test_and_set(std::memory_order_acquire))
+    {
+        vTaskDelay(1);
+    }
+    s_is_draining.clear(std::memory_order_release);
+}
+
+log_sink_t * debug_agents_get_sink(const char * p_ptr_name)
+{
+    log_sink_t * sink_ptr = NULL;
+
+    if (NULL != p_ptr_name)
+    {
+        portENTER_CRITICAL(&s_sink_mux);
+        for (uint8_t i = 0; (i < LOG_MAX_SINKS) && (NULL == sink_ptr); i++)
+        {
+            if ((NULL != s_sinks[i]) && (0 == strcmp(s_sinks[i]->name, p_ptr_name)))
             {
-                if (p_ptr_msg[i] == '%' && param_count < 3)
-                {
-                    current_param = p_params_list[param_count++];
-                    qualifier_idx = check_param_qualifier(&p_ptr_msg[i]);
-                    if (qualifier_idx > 0)
-                    {
-                        switch (p_ptr_msg[i + qualifier_idx])
-                        {
-                        case 'f':
-                            qualifier_idx = string_ftoa(current_param, &g_debug_msg[bytes_written], 3);
-                            break;
-                        case 'd':
-                            qualifier_idx = string_itoa(current_param, &g_debug_msg[bytes_written], 0, BASE_10);
-                            break;
-                        case 'x':
-                            qualifier_idx = string_itoa(current_param, &g_debug_msg[bytes_written], 0, BASE_16);
-                            break;
-                        }
-                        bytes_written += qualifier_idx;
-                        i++;
-                    }
-                }
-                else
-                {
-                    g_debug_msg[bytes_written++] = p_ptr_msg[i];
-                }
+                sink_ptr = s_sinks[i];
             }
         }
+        portEXIT_CRITICAL(&s_sink_mux);
+    }
+    return sink_ptr;
+}
 
-#if UART_DEBUG
-    UART_SERIAL.print(g_debug_msg);
-#endif /* UART_DEBUG */
-#if BLT_DEBUG
-    BLT_SERIAL.print(g_debug_msg);
-#endif /* BLT_DEBUG */
+void debug_agents_write_sink(log_sink_t * p_ptr_sink, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    if ((NULL != p_ptr_sink) && (NULL != p_ptr_data))
+    {
+        log_sink_output(p_ptr_sink, p_ptr_data, p_len);
+    }
+}
+
+uint16_t debug_agents_read_crash_log(char * p_ptr_buf, uint16_t p_buf_size)
+{
+    uint16_t bytes_read = 0U;
+#if LOG_CRASH_BUFFER_SIZE > 0
+    uint32_t available = 0U;
+    uint32_t read_adrs = 0U;
+
+    portENTER_CRITICAL(&s_crash_mux);
+    available = s_crash_prev_count;
+    /* The new boot's output overwrites the previous log from its oldest end */
+    if (s_crash_written > (LOG_CRASH_BUFFER_SIZE - s_crash_prev_count))
+    {
+        available = (s_crash_written < LOG_CRASH_BUFFER_SIZE) ? (LOG_CRASH_BUFFER_SIZE - s_crash_written) : 0U;
+    }
+    if (NULL != p_ptr_buf)
+    {
+        if (available > p_buf_size)
+        {
+            available = p_buf_size;
+        }
+        read_adrs = (s_crash_prev_end + LOG_CRASH_BUFFER_SIZE - available) % LOG_CRASH_BUFFER_SIZE;
+        for (; bytes_read < available; bytes_read++)
+        {
+            p_ptr_buf[bytes_read] = (char)s_crash_ring.data[read_adrs];
+            read_adrs = (read_adrs + 1U) % LOG_CRASH_BUFFER_SIZE;
+        }
+    }
+    portEXIT_CRITICAL(&s_crash_mux);
+#else
+    (void)p_ptr_buf;
+    (void)p_buf_size;
+#endif /* LOG_CRASH_BUFFER_SIZE */
+    return bytes_read;
+}
+
+void debug_agents_get_stats(logger_stats_t * p_ptr_stats)
+{
+    if (NULL != p_ptr_stats)
+    {
+        p_ptr_stats->enqueued_count = s_enqueued_count.load(std::memory_order_relaxed);
+        p_ptr_stats->dropped_count = s_dropped_count.load(std::memory_order_relaxed);
+        p_ptr_stats->truncated_count = s_truncated_count.load(std::memory_order_relaxed);
+        p_ptr_stats->suppressed_count = s_suppressed_count.load(std::memory_order_relaxed);
+        p_ptr_stats->repeated_count = s_repeated_count.load(std::memory_order_relaxed);
+    }
+}
+
+void debug_agents_set_threshold(debug_level_t p_lvl)
+{
+    if (p_lvl != DBG_LVL_EXT)
+    {
+        for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++)
+        {
+            g_log_module_thld[i] = p_lvl;
+        }
+    }
+}
+
+void debug_agents_set_module_threshold(log_module_t p_module, debug_level_t p_lvl)
+{
+    if ((p_lvl != DBG_LVL_EXT) && (p_module < LOG_MODULE_COUNT))
+    {
+        g_log_module_thld[p_module] = p_lvl;
+    }
+}
+
+uint16_t logger_format(char * p_ptr_buf,
+                       uint16_t p_buf_size,
+                       debug_level_t p_lvl,
+                       const char * p_ptr_func_name,
+                       const char * p_ptr_msg,
+                       const log_arg_t * p_ptr_args,
+                       uint8_t p_arg_count)
+{
+    string_builder_t text;
+
+    string_builder_init(&text, p_ptr_buf, p_buf_size);
+    if ((NULL != p_ptr_buf) && (NULL != p_ptr_msg) && (p_lvl <= DBG_LVL_DEBUG))
+    {
+        log_format_text(&text, NULL, p_lvl, p_ptr_func_name, NULL, p_ptr_msg, p_ptr_args, p_arg_count, true);
+    }
+    return (uint16_t)text.length;
+}
+
+void logger_write(debug_level_t p_lvl,
+                  const char * p_ptr_func_name,
+                  const log_fmt_segment_t * p_ptr_segments,
+                  const char * p_ptr_msg,
+                  const log_arg_t * p_ptr_args,
+                  uint8_t p_arg_count)
+{
+    uint32_t args_hash = log_hash_args(p_ptr_args, p_arg_count);
+    uint32_t repeats = 0U;
+    uint32_t suppressed = 0U;
+    debug_level_t repeat_lvl = DBG_LVL_DEBUG;
+    const char * repeat_func_name_ptr = NULL;
+    bool is_allowed = true;
+    log_rate_entry_t evicted;
+    log_stamp_t stamp;
+
+    /* Stamped on entry, so the time does not include waiting for the filter lock */
+    log_take_stamp(&stamp);
+    evicted.suppressed = 0U;
+    portENTER_CRITICAL(&s_filter_mux);
+    if ((s_last_msg.msg_ptr == p_ptr_msg) && (s_last_msg.args_hash == args_hash))
+    {
+        /* Same message and arguments as the last one logged, only count it */
+        s_last_msg.repeats++;
+        s_repeated_count.fetch_add(1U, std::memory_order_relaxed);
+        is_allowed = false;
+    }
+    else if ((int)p_lvl >= LOG_RATE_LIMIT_LEVEL)
+    {
+        is_allowed = log_rate_take_token(p_lvl, p_ptr_func_name, p_ptr_msg, (uint32_t)millis(), &suppressed, &evicted);
+    }
+
+    if (true == is_allowed)
+    {
+        repeats = s_last_msg.repeats;
+        repeat_lvl = s_last_msg.lvl;
+        repeat_func_name_ptr = s_last_msg.func_name_ptr;
+        s_last_msg.msg_ptr = p_ptr_msg;
+        s_last_msg.args_hash = args_hash;
+        s_last_msg.repeats = 0U;
+        s_last_msg.lvl = p_lvl;
+        s_last_msg.func_name_ptr = p_ptr_func_name;
+    }
+    portEXIT_CRITICAL(&s_filter_mux);
+
+    if (evicted.suppressed > 0U)
+    {
+        log_emit_count(&stamp, (debug_level_t)evicted.lvl, evicted.func_name_ptr, LOG_SUPPRESSED_FMT, evicted.suppressed);
     }
-}
\ No newline at end of file
+    if (true == is_allowed)
+    {
+        if (repeats > 0U)
+        {
+            log_emit_count(&stamp, repeat_lvl, repeat_func_name_ptr, LOG_REPEATED_FMT, repeats);
+        }
+        if (suppressed > 0U)
+        {
+            log_emit_count(&stamp, p_lvl, p_ptr_func_name, LOG_SUPPRESSED_FMT, suppressed);
+        }
+        log_emit(&stamp, p_lvl, p_ptr_func_name, p_ptr_segments, p_ptr_msg, p_ptr_args, p_arg_count);
+    }
+}
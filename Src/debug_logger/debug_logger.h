@@ -15,73 +15,155 @@
 
 #include "HW_comm.h"
 #include "stddef.h"
+#include <type_traits>
 
 /***************************************************************************************************
 * Macro definitions.
 ***************************************************************************************************/
 
+/* Maximum length of a format string */
 #define MAX_DBG_MSG_LEN 512
 
-#ifdef DEBUG_EN
-#define logger_i(p_msg) logger(DBG_LVL_INFO, NULL, (p_msg), 0, 0, 0)
-#define logger_w(p_msg) logger(DBG_LVL_WARN, NULL, (p_msg), 0, 0, 0)
-#define logger_e(p_msg) logger(DBG_LVL_ERR, NULL, (p_msg), 0, 0, 0)
-#define logger_d(p_msg) logger(DBG_LVL_DEBUG, __func__, (p_msg), 0, 0, 0)
-#define logger_p(p_msg) logger(DBG_LVL_PERIODIC, NULL, (p_msg), 0, 0, 0)
-#define logger_ext(p_msg) logger(DBG_LVL_EXT, NULL, (p_msg), 0, 0, 0)
-
-#define logger_i_p1(p_msg, p_param_1) logger(DBG_LVL_INFO, NULL, (p_msg), (p_param_1), 0U, 0U)
-#define logger_w_p1(p_msg, p_param_1) logger(DBG_LVL_WARN, NULL, (p_msg), (p_param_1), 0U, 0U)
-#define logger_e_p1(p_msg, p_param_1) logger(DBG_LVL_ERR, NULL, (p_msg), (p_param_1), 0U, 0U)
-#define logger_d_p1(p_msg, p_param_1) logger(DBG_LVL_DEBUG, __func__, (p_msg), (p_param_1), 0U, 0U)
-#define logger_p_p1(p_msg, p_param_1) logger(DBG_LVL_PERIODIC, NULL, (p_msg), (p_param_1), 0U, 0U)
-#define logger_ext_p1(p_msg, p_param_1) logger(DBG_LVL_EXT, NULL, (p_msg), (p_param_1), 0U, 0U)
-
-#define logger_i_p2(p_msg, p_param_1, p_param_2) logger(DBG_LVL_INFO, NULL, (p_msg), (p_param_1), (p_param_2), 0U)
-#define logger_w_p2(p_msg, p_param_1, p_param_2) logger(DBG_LVL_WARN, NULL, (p_msg), (p_param_1), (p_param_2), 0U)
-#define logger_e_p2(p_msg, p_param_1, p_param_2) logger(DBG_LVL_ERR, NULL, (p_msg), (p_param_1), (p_param_2), 0U)
-#define logger_d_p2(p_msg, p_param_1, p_param_2) logger(DBG_LVL_DEBUG, __func__, (p_msg), (p_param_1), (p_param_2), 0U)
-#define logger_p_p2(p_msg, p_param_1, p_param_2) logger(DBG_LVL_PERIODIC, NULL, (p_msg), (p_param_1), (p_param_2), 0U)
-#define logger_ext_p2(p_msg, p_param_1, p_param_2) logger(DBG_LVL_EXT, NULL, (p_msg), (p_param_1), (p_param_2), 0U)
-
-#define logger_i_p3(p_msg, p_param_1, p_param_2, p_param_3) logger(DBG_LVL_INFO, NULL, (p_msg), (p_param_1), (p_param_2), p_param_3)
-#define logger_w_p3(p_msg, p_param_1, p_param_2, p_param_3) logger(DBG_LVL_WARN, NULL, (p_msg), (p_param_1), (p_param_2), p_param_3)
-#define logger_e_p3(p_msg, p_param_1, p_param_2, p_param_3) logger(DBG_LVL_ERR, NULL, (p_msg), (p_param_1), (p_param_2), p_param_3)
-#define logger_d_p3(p_msg, p_param_1, p_param_2, p_param_3) logger(DBG_LVL_DEBUG, __func__, (p_msg), (p_param_1), (p_param_2), p_param_3)
-#define logger_p_p3(p_msg, p_param_1, p_param_2, p_param_3) logger(DBG_LVL_PERIODIC, NULL, (p_msg), (p_param_1), (p_param_2), p_param_3)
-#define logger_ext_p3(p_msg, p_param_1, p_param_2, p_param_3) logger(DBG_LVL_EXT, NULL, (p_msg), (p_param_1), (p_param_2), p_param_3)
+/* Number of records the log queue can hold, must be a power of 2 */
+#ifndef LOG_QUEUE_DEPTH
+#define LOG_QUEUE_DEPTH (32U)
+#endif
 
-#else
-#define logger_i(p_msg) ((void)0)
-#define logger_w(p_msg) ((void)0)
-#define logger_e(p_msg) ((void)0)
-#define logger_d(p_msg) ((void)0)
-#define logger_p(p_msg) ((void)0)
-#define logger_ext(p_msg) ((void)0)
-
-#define logger_i_p1(p_msg, p_param_1) ((void)0)
-#define logger_w_p1(p_msg, p_param_1) ((void)0)
-#define logger_e_p1(p_msg, p_param_1) ((void)0)
-#define logger_d_p1(p_msg, p_param_1) ((void)0)
-#define logger_p_p1(p_msg, p_param_1) ((void)0)
-#define logger_ext_p1(p_msg, p_param_1) ((void)0)
-
-#define logger_i_p2(p_msg, p_param_1, p_param_2) ((void)0)
-#define logger_w_p2(p_msg, p_param_1, p_param_2) ((void)0)
-#define logger_e_p2(p_msg, p_param_1, p_param_2) ((void)0)
-#define logger_d_p2(p_msg, p_param_1, p_param_2) ((void)0)
-#define logger_p_p2(p_msg, p_param_1, p_param_2) ((void)0)
-#define logger_ext_p2(p_msg, p_param_1, p_param_2) ((void)0)
-
-#define logger_i_p3(p_msg, p_param_1, p_param_2, p_param_3) ((void)0)
-#define logger_w_p3(p_msg, p_param_1, p_param_2, p_param_3) ((void)0)
-#define logger_e_p3(p_msg, p_param_1, p_param_2, p_param_3) ((void)0)
-#define logger_d_p3(p_msg, p_param_1, p_param_2, p_param_3) ((void)0)
-#define logger_p_p3(p_msg, p_param_1, p_param_2, p_param_3) ((void)0)
-#define logger_ext_p3(p_msg, p_param_1, p_param_2, p_param_3) ((void)0)
+/* Maximum length of a rendered text line, longer messages are truncated */
+#ifndef LOG_TEXT_MAX_LEN
+#define LOG_TEXT_MAX_LEN (256U)
+#endif
+
+/* When set, text lines start with "[seconds.micros core#sequence] ", a gap in the sequence numbers
+   shows where records were dropped */
+#ifndef LOG_TEXT_STAMP_EN
+#define LOG_TEXT_STAMP_EN (1)
+#endif
+
+/* When set, the UART sink sends the binary records instead of text.
+   The host rebuilds the messages with Tools/log_decoder/log_decoder.py and the firmware ELF */
+#ifndef LOG_BINARY_EN
+#define LOG_BINARY_EN (0)
+#endif
+
+/* Maximum number of registered sinks */
+#ifndef LOG_MAX_SINKS
+#define LOG_MAX_SINKS (4U)
+#endif
+
+/* Time a sink gets to take a record before the record is dropped for that sink */
+#ifndef LOG_SINK_TIMEOUT_MS
+#define LOG_SINK_TIMEOUT_MS (20U)
+#endif
+
+/* Size of the crash log kept in no-init RTC memory across resets, 0 disables it */
+#ifndef LOG_CRASH_BUFFER_SIZE
+#define LOG_CRASH_BUFFER_SIZE (2048U)
+#endif
+
+/* Messages at this level and below (ERR, WARN) are copied into the crash log by the caller,
+   so they are kept even if a reset comes before the drain task writes them.
+   The caller renders them on its stack, which takes LOG_TEXT_MAX_LEN bytes more */
+#ifndef LOG_CRASH_SYNC_LEVEL
+#define LOG_CRASH_SYNC_LEVEL (2)   /* DBG_LVL_WARN */
+#endif
+
+/* Messages at this level and above (PERIODIC, DEBUG) are rate limited per call site */
+#ifndef LOG_RATE_LIMIT_LEVEL
+#define LOG_RATE_LIMIT_LEVEL (4)   /* DBG_LVL_PERIODIC */
+#endif
+
+/* Token bucket of a call site: burst size and sustained messages per second */
+#ifndef LOG_RATE_BURST
+#define LOG_RATE_BURST (5U)
+#endif
+#ifndef LOG_RATE_PER_SEC
+#define LOG_RATE_PER_SEC (2U)
+#endif
+
+/* Number of call sites tracked at the same time, must be a power of 2.
+   A call site that loses its entry to another one logs its suppressed count first */
+#ifndef LOG_RATE_TABLE_SIZE
+#define LOG_RATE_TABLE_SIZE (16U)
+#endif
+
+/* Maximum number of arguments of one log message */
+#define LOG_MAX_ARGS (12U)
 
+/* Flags of a format specifier, the same set as printf: '-', '+', ' ', '0' and '#' */
+#define LOG_FMT_FLAG_LEFT (0x01U)
+#define LOG_FMT_FLAG_PLUS (0x02U)
+#define LOG_FMT_FLAG_SPACE (0x04U)
+#define LOG_FMT_FLAG_ZERO (0x08U)
+#define LOG_FMT_FLAG_ALT (0x10U)
+/* Precision of a specifier that has none, %f then shows 3 decimals */
+#define LOG_FMT_NO_PRECISION (0xFFU)
+/* Widths above this are cut, a padded argument is rendered on the stack */
+#define LOG_FMT_MAX_WIDTH (64U)
+
+/* Queue cells hold binary records: a header with two native pointers and a 64-bit timestamp,
+   and up to 9 bytes per argument */
+#define LOG_RECORD_HEADER_LEN (17U + (2U * sizeof(void *)))
+#define LOG_RECORD_MAX_LEN (LOG_RECORD_HEADER_LEN + (LOG_MAX_ARGS * 9U))
+
+/* Messages above this level are removed at compile time, the runtime threshold filters the rest */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL (5)   /* DBG_LVL_DEBUG */
+#endif
+
+/* Compile time level of each module, e.g. -DLOG_LEVEL_HW_TIMER=3 keeps only INFO and below */
+#ifndef LOG_LEVEL_HW_TIMER
+#define LOG_LEVEL_HW_TIMER LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_LEVEL_HW_IO
+#define LOG_LEVEL_HW_IO LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_LEVEL_HW_EEPROM
+#define LOG_LEVEL_HW_EEPROM LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_LEVEL_WEB
+#define LOG_LEVEL_WEB LOG_COMPILE_LEVEL
+#endif
+
+/* Module of the including file, define it before including this header to tag the file's logs */
+#ifndef DBG_MODULE
+#define DBG_MODULE LOG_MODULE_DEFAULT
+#endif
+
+/* First macro argument, the format string of a logger_x call */
+#define LOG_FMT_OF(...) LOG_FMT_OF_(__VA_ARGS__, 0)
+#define LOG_FMT_OF_(p_fmt, ...) p_fmt
+
+/* The format string is checked against the arguments at compile time, the arguments are not evaluated there.
+   Each call site also gets its segment table, so the drain task never scans the format again.
+   The level check is a constant and the threshold check runs before any argument is evaluated */
+#ifdef DEBUG_EN
+#define LOGGER_AT(p_lvl, p_func, ...) \
+    do \
+    { \
+        static_assert(decltype(log_fmt_arg_types(__VA_ARGS__))::count == log_fmt_count(LOG_FMT_OF(__VA_ARGS__)), \
+                      "The number of format specifiers and arguments differ"); \
+        static_assert(decltype(log_fmt_arg_types(__VA_ARGS__))::matches(LOG_FMT_OF(__VA_ARGS__), 0U), \
+                      "Floating point arguments need %f and pointers %x"); \
+        if (((int)(p_lvl) <= log_module_compile_level(DBG_MODULE)) && logger_is_enabled(DBG_MODULE, (p_lvl))) \
+        { \
+            static constexpr log_fmt_table<decltype(log_fmt_arg_types(__VA_ARGS__))::count + 1U> s_log_fmt_table( \
+                LOG_FMT_OF(__VA_ARGS__), log_fmt_make_indices<decltype(log_fmt_arg_types(__VA_ARGS__))::count + 1U>()); \
+            logger((p_lvl), (p_func), s_log_fmt_table.segments, __VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define LOGGER_AT(p_lvl, p_func, ...) ((void)0)
 #endif /* DEBUG_EN */
 
+/* The message is followed by one argument per %d, %x or %f, the argument types are kept */
+#define logger_i(...) LOGGER_AT(DBG_LVL_INFO, NULL, __VA_ARGS__)
+#define logger_w(...) LOGGER_AT(DBG_LVL_WARN, NULL, __VA_ARGS__)
+#define logger_e(...) LOGGER_AT(DBG_LVL_ERR, NULL, __VA_ARGS__)
+#define logger_d(...) LOGGER_AT(DBG_LVL_DEBUG, __func__, __VA_ARGS__)
+#define logger_p(...) LOGGER_AT(DBG_LVL_PERIODIC, NULL, __VA_ARGS__)
+#define logger_ext(...) LOGGER_AT(DBG_LVL_EXT, NULL, __VA_ARGS__)
+
 /***************************************************************************************************
 * External type declarations.
 ***************************************************************************************************/
@@ -96,10 +178,87 @@ typedef enum debug_level_t_enum
     DBG_LVL_DEBUG,
 } debug_level_t;
 
+typedef enum log_module_t_enum
+{
+    LOG_MODULE_DEFAULT = 0,
+    LOG_MODULE_HW_TIMER,
+    LOG_MODULE_HW_IO,
+    LOG_MODULE_HW_EEPROM,
+    LOG_MODULE_WEB,
+    LOG_MODULE_COUNT,
+} log_module_t;
+
+typedef struct logger_stats_t_struct
+{
+    uint32_t enqueued_count;    /* Records handed to the drain task */
+    uint32_t dropped_count;     /* Records lost because the queue was full */
+    uint32_t truncated_count;   /* Text lines cut to LOG_TEXT_MAX_LEN */
+    uint32_t suppressed_count;  /* Records over the rate limit of their call site */
+    uint32_t repeated_count;    /* Consecutive duplicates collapsed into a summary */
+} logger_stats_t;
+
+typedef enum log_format_t_enum
+{
+    LOG_FORMAT_TEXT = 0,    /* Colored text */
+    LOG_FORMAT_PLAIN,       /* Text without escape sequences */
+    LOG_FORMAT_BINARY,      /* Binary records for Tools/log_decoder */
+} log_format_t;
+
+/* Sink output function, it must not block and returns the number of bytes it took */
+typedef uint16_t (*log_sink_write_t)(void * p_ptr_ctx, const uint8_t * p_ptr_data, uint16_t p_len);
+
+typedef struct log_sink_t_struct
+{
+    const char * name;
+    log_sink_write_t write;
+    void * ctx;
+    volatile debug_level_t level;   /* Records above this level are not sent to the sink */
+    volatile log_format_t format;
+    uint32_t drop_count;            /* Records the sink could not take within LOG_SINK_TIMEOUT_MS */
+} log_sink_t;
+
+typedef enum log_arg_type_t_enum
+{
+    LOG_ARG_INT32 = 'i',
+    LOG_ARG_UINT32 = 'u',
+    LOG_ARG_INT64 = 'I',
+    LOG_ARG_UINT64 = 'U',
+    LOG_ARG_FLOAT = 'f',
+} log_arg_type_t;
+
+/* A log argument with its original type */
+typedef struct log_arg_t_struct
+{
+    union
+    {
+        int32_t i32;
+        uint32_t u32;
+        int64_t i64;
+        uint64_t u64;
+        float f32;
+    } value;
+    uint8_t type;
+} log_arg_t;
+
+/* A literal run of the format and the specifier after it, built at compile time for each call site.
+   The last segment of a format has no specifier, its conversion is '\0' */
+typedef struct log_fmt_segment_t_struct
+{
+    uint16_t literal_len;   /* Characters before the specifier */
+    uint8_t spec_len;       /* Characters of the specifier, '%' included */
+    char conversion;        /* d, f or x */
+    uint8_t flags;          /* LOG_FMT_FLAG_x */
+    uint8_t width;
+    uint8_t precision;      /* LOG_FMT_NO_PRECISION if there is none */
+} log_fmt_segment_t;
+
 /***************************************************************************************************
 * External data declarations.
 ***************************************************************************************************/
 
+/* Runtime threshold of each module, read by the inlined logger_is_enabled() */
+extern volatile uint8_t g_log_module_thld[LOG_MODULE_COUNT];
+
 /***************************************************************************************************
 * External function declarations.
 ***************************************************************************************************/
@@ -111,27 +270,485 @@ typedef enum debug_level_t_enum
 void debug_agents_init();
 
 /**
- * @brief This function sets the debug level threshold.
+ * @brief This function waits until all queued log records are written to the sinks.
+ *        It should be called before a reset so the last messages are not lost.
+ */
+void debug_agents_flush(void);
+
+/**
+ * @brief This function registers a sink, records are rendered in the sink's format by the drain task.
+ *        The built-in sinks are "uart", "bt" and "crash", on Linux "uart" prints to stdout
+ *        and "bt" appends to LOG_HOST_FILE_PATH.
+ * 
+ * @param p_ptr_sink input: The sink, it must stay valid while it is registered
+ * @retval true if the sink is registered
+ * @retval false if the sink table is full
+ */
+bool debug_agents_add_sink(log_sink_t * p_ptr_sink);
+
+/**
+ * @brief This function unregisters a sink.
+ * 
+ * @param p_ptr_sink input: The sink
+ */
+void debug_agents_remove_sink(log_sink_t * p_ptr_sink);
+
+/**
+ * @brief This function finds a registered sink by name, e.g. to change its level or format.
+ * 
+ * @param p_ptr_name input: Name of the sink
+ * @retval Pointer to the sink, NULL if there is no such sink
+ */
+log_sink_t * debug_agents_get_sink(const char * p_ptr_name);
+
+/**
+ * @brief This function writes data to a sink the way the drain task does, what the sink can not
+ *        take within LOG_SINK_TIMEOUT_MS is dropped and counted. It may block, do not call it from an ISR.
+ * 
+ * @param p_ptr_sink input: The sink
+ * @param p_ptr_data input: Data to write
+ * @param p_len      input: Number of bytes
+ */
+void debug_agents_write_sink(log_sink_t * p_ptr_sink, const uint8_t * p_ptr_data, uint16_t p_len);
+
+/**
+ * @brief This function reads the log of the previous boot kept in the crash buffer.
+ *        It should be called early, the new boot's logs overwrite the oldest part of it.
+ *        ERR and WARN lines are written when they are logged, so they can come before lower level
+ *        lines logged earlier, the sequence numbers of the stamps give the order.
+ * 
+ * @param p_ptr_buf  output: Buffer that receives the most recent part of the log
+ * @param p_buf_size input: Size of the buffer
+ * @return The number of bytes copied, 0 if there is no log from the previous boot
+ */
+uint16_t debug_agents_read_crash_log(char * p_ptr_buf, uint16_t p_buf_size);
+
+/**
+ * @brief This function gets the counters of the log queue.
+ * 
+ * @param p_ptr_stats output: Pointer to the statistics struct
+ */
+void debug_agents_get_stats(logger_stats_t * p_ptr_stats);
+
+/**
+ * @brief This function sets the debug level threshold of all modules.
  *        any message with a level less than the threshold will not be printed.
  * @param p_lvl input: The debug level threshold.
  */
 void debug_agents_set_threshold(debug_level_t p_lvl);
 
 /**
- * @brief This function prints the log message with the specified log level.
+ * @brief This function sets the debug level threshold of one module.
+ * 
+ * @param p_module input: The module
+ * @param p_lvl    input: The debug level threshold.
+ */
+void debug_agents_set_module_threshold(log_module_t p_module, debug_level_t p_lvl);
+
+/**
+ * @brief This function gets the compile time level of a module.
+ */
+constexpr int log_module_compile_level(log_module_t p_module)
+{
+    return (p_module == LOG_MODULE_HW_TIMER) ? (LOG_LEVEL_HW_TIMER) :
+           (p_module == LOG_MODULE_HW_IO) ? (LOG_LEVEL_HW_IO) :
+           (p_module == LOG_MODULE_HW_EEPROM) ? (LOG_LEVEL_HW_EEPROM) :
+           (p_module == LOG_MODULE_WEB) ? (LOG_LEVEL_WEB) : (LOG_COMPILE_LEVEL);
+}
+
+/**
+ * @brief This function checks the runtime threshold of a module, it is inlined at the call site.
+ */
+inline bool logger_is_enabled(log_module_t p_module, debug_level_t p_lvl)
+{
+    return ((uint8_t)p_lvl <= g_log_module_thld[p_module]);
+}
+
+/**
+ * @brief This function formats a log message into a caller supplied buffer, the same way
+ *        as the colored text sinks show it. It is reentrant and only writes the produced bytes, no terminator is added.
+ * 
+ * @param p_ptr_buf       output: Buffer that receives the text
+ * @param p_buf_size      input: Size of the buffer, longer messages are truncated
+ * @param p_lvl           input: Log level
+ * @param p_ptr_func_name input: Name of the calling function, NULL to omit it
+ * @param p_ptr_msg       input: Log message, may contain %d, %x and %f
+ * @param p_ptr_args      input: One argument per format specifier
+ * @param p_arg_count     input: Number of arguments
+ * @return The number of bytes written
+ */
+uint16_t logger_format(char * p_ptr_buf,
+                       uint16_t p_buf_size,
+                       debug_level_t p_lvl,
+                       const char * p_ptr_func_name,
+                       const char * p_ptr_msg,
+                       const log_arg_t * p_ptr_args,
+                       uint8_t p_arg_count);
+
+/**
+ * @brief This function formats the log message with the specified log level and queues it.
+ *        Consecutive duplicates are collapsed and PERIODIC/DEBUG call sites are rate limited.
+ *        The message is formatted straight into a queue cell, so it is safe to call from any task on
+ *        both cores. It is written to the sinks by a low priority task, the caller does not wait.
+ *        It does not check the thresholds, use the logger_x macros instead of calling it directly.
  * 
- * @param p_lvl 
- * @param p_ptr_func_name input: Log level
- * @param p_ptr_msg       input: Log message
- * @param p_param_1       input: if format contains %d, %f or %x the value of the first parameter. 0 otherwise
- * @param p_param_2       input: if format contains %d, %f or %x the value of the second parameter. 0 otherwise
- * @param p_param_3       input: if format contains %d, %f or %x the value of the third parameter. 0 otherwise
- */
-void logger(debug_level_t p_lvl,
-            const char * p_ptr_func_name, 
-            const char * p_ptr_msg,
-            float p_param_1, 
-            float p_param_2,
-            float p_param_3);
+ * @param p_lvl           input: Log level
+ * @param p_ptr_func_name input: Name of the calling function, NULL to omit it
+ * @param p_ptr_segments  input: Segment table of the message, it must live as long as the message.
+ *                               NULL to scan the message at run time
+ * @param p_ptr_msg       input: Log message, may contain %d, %x and %f
+ * @param p_ptr_args      input: One argument per format specifier
+ * @param p_arg_count     input: Number of arguments
+ */
+void logger_write(debug_level_t p_lvl,
+                  const char * p_ptr_func_name,
+                  const log_fmt_segment_t * p_ptr_segments,
+                  const char * p_ptr_msg,
+                  const log_arg_t * p_ptr_args,
+                  uint8_t p_arg_count);
+
+/***************************************************************************************************
+* Argument conversion, the overload is selected at compile time from the argument type.
+***************************************************************************************************/
+
+inline log_arg_t log_arg_make_typed(uint8_t p_type, uint64_t p_raw_val)
+{
+    log_arg_t arg;
+    arg.value.u64 = p_raw_val;
+    arg.type = p_type;
+    return arg;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && (sizeof(T) <= 4U), log_arg_t>::type
+log_arg_make(T p_val)
+{
+    log_arg_t arg = log_arg_make_typed(LOG_ARG_INT32, 0U);
+    arg.value.i32 = (int32_t)p_val;
+    return arg;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value && (sizeof(T) <= 4U), log_arg_t>::type
+log_arg_make(T p_val)
+{
+    return log_arg_make_typed(LOG_ARG_UINT32, (uint32_t)p_val);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && (sizeof(T) > 4U), log_arg_t>::type
+log_arg_make(T p_val)
+{
+    log_arg_t arg = log_arg_make_typed(LOG_ARG_INT64, 0U);
+    arg.value.i64 = (int64_t)p_val;
+    return arg;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value && (sizeof(T) > 4U), log_arg_t>::type
+log_arg_make(T p_val)
+{
+    return log_arg_make_typed(LOG_ARG_UINT64, (uint64_t)p_val);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, log_arg_t>::type
+log_arg_make(T p_val)
+{
+    log_arg_t arg = log_arg_make_typed(LOG_ARG_FLOAT, 0U);
+    arg.value.f32 = (float)p_val;
+    return arg;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value, log_arg_t>::type
+log_arg_make(T p_val)
+{
+    return log_arg_make((int32_t)p_val);
+}
+
+/* Pointers are printed as addresses */
+template <typename T>
+inline log_arg_t log_arg_make(T * p_ptr)
+{
+    return log_arg_make((uintptr_t)p_ptr);
+}
+
+/***************************************************************************************************
+* Format string checks. They are constexpr, the logger_x macros evaluate them at compile time
+* and the renderer uses the same scanner at run time.
+***************************************************************************************************/
+
+constexpr bool log_fmt_is_flag(char p_char)
+{
+    return (p_char == '-') || (p_char == '+') || (p_char == ' ') || (p_char == '0') || (p_char == '#');
+}
+
+constexpr bool log_fmt_is_digit(char p_char)
+{
+    return (p_char >= '0') && (p_char <= '9');
+}
+
+constexpr bool log_fmt_is_conversion(char p_char)
+{
+    return (p_char == 'd') || (p_char == 'f') || (p_char == 'x');
+}
+
+constexpr uint16_t log_fmt_skip_flags(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return log_fmt_is_flag(p_ptr_fmt[p_idx]) ? log_fmt_skip_flags(p_ptr_fmt, p_idx + 1U) : p_idx;
+}
+
+constexpr uint16_t log_fmt_skip_digits(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return log_fmt_is_digit(p_ptr_fmt[p_idx]) ? log_fmt_skip_digits(p_ptr_fmt, p_idx + 1U) : p_idx;
+}
+
+/* The precision is a '.' followed by at least one digit, like in Tools/log_decoder */
+constexpr uint16_t log_fmt_skip_precision(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return ((p_ptr_fmt[p_idx] == '.') && log_fmt_is_digit(p_ptr_fmt[p_idx + 1U])) ?
+           log_fmt_skip_digits(p_ptr_fmt, p_idx + 1U) : p_idx;
+}
+
+/* Offset of the character after the flags, width and precision of the '%' at the start of the string */
+constexpr uint16_t log_fmt_conversion_idx(const char * p_ptr_fmt)
+{
+    return log_fmt_skip_precision(p_ptr_fmt, log_fmt_skip_digits(p_ptr_fmt, log_fmt_skip_flags(p_ptr_fmt, 1U)));
+}
+
+constexpr uint16_t log_fmt_spec_len_at(const char * p_ptr_fmt, uint16_t p_conversion_idx)
+{
+    return log_fmt_is_conversion(p_ptr_fmt[p_conversion_idx]) ? p_conversion_idx : 0U;
+}
+
+/**
+ * @brief This function gets the length of the format specifier at the start of the string.
+ *        A specifier is '%', then any of the flags "-+ 0#", a width, a precision and d, f or x.
+ *        Anything else, "100%," or "%\t" among others, is literal text.
+ * @return The offset of the conversion character, 0 if there is no specifier
+ */
+constexpr uint16_t log_fmt_spec_len(const char * p_ptr_fmt)
+{
+    return (p_ptr_fmt[0] == '%') ? log_fmt_spec_len_at(p_ptr_fmt, log_fmt_conversion_idx(p_ptr_fmt)) : 0U;
+}
+
+constexpr bool log_fmt_is_stop(char p_char)
+{
+    return (p_char == '%') || (p_char == '\0');
+}
+
+/* Index of the next '%' or of the terminator. Eight characters per step keep the recursion depth
+   of long literal runs far below the constexpr limit of the compiler */
+constexpr uint16_t log_fmt_find_percent(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return log_fmt_is_stop(p_ptr_fmt[p_idx]) ? p_idx :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 1U]) ? (uint16_t)(p_idx + 1U) :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 2U]) ? (uint16_t)(p_idx + 2U) :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 3U]) ? (uint16_t)(p_idx + 3U) :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 4U]) ? (uint16_t)(p_idx + 4U) :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 5U]) ? (uint16_t)(p_idx + 5U) :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 6U]) ? (uint16_t)(p_idx + 6U) :
+           log_fmt_is_stop(p_ptr_fmt[p_idx + 7U]) ? (uint16_t)(p_idx + 7U) :
+           log_fmt_find_percent(p_ptr_fmt, p_idx + 8U);
+}
+
+/* Index of the first specifier at or after the '%' at p_idx, a '%' that starts none is skipped */
+constexpr uint16_t log_fmt_next_spec_at(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return ((p_ptr_fmt[p_idx] == '\0') || (log_fmt_spec_len(&p_ptr_fmt[p_idx]) > 0U)) ? p_idx :
+           log_fmt_next_spec_at(p_ptr_fmt, log_fmt_find_percent(p_ptr_fmt, p_idx + 1U));
+}
+
+/**
+ * @brief This function finds the next format specifier.
+ * @return The index of its '%', the index of the terminator if there is none
+ */
+constexpr uint16_t log_fmt_next_spec(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return log_fmt_next_spec_at(p_ptr_fmt, log_fmt_find_percent(p_ptr_fmt, p_idx));
+}
+
+/* Index right after the specifier at p_idx */
+constexpr uint16_t log_fmt_spec_end(const char * p_ptr_fmt, uint16_t p_idx)
+{
+    return p_idx + log_fmt_spec_len(&p_ptr_fmt[p_idx]) + 1U;
+}
+
+constexpr uint8_t log_fmt_count_from(const char * p_ptr_fmt, uint16_t p_spec_idx)
+{
+    return (p_ptr_fmt[p_spec_idx] == '\0') ? 0U :
+           (uint8_t)(1U + log_fmt_count_from(p_ptr_fmt, log_fmt_next_spec(p_ptr_fmt, log_fmt_spec_end(p_ptr_fmt, p_spec_idx))));
+}
+
+/**
+ * @brief This function counts the format specifiers of a format string.
+ */
+constexpr uint8_t log_fmt_count(const char * p_ptr_fmt)
+{
+    return log_fmt_count_from(p_ptr_fmt, log_fmt_next_spec(p_ptr_fmt, 0U));
+}
+
+constexpr uint8_t log_fmt_flag(char p_char)
+{
+    return (p_char == '-') ? LOG_FMT_FLAG_LEFT :
+           (p_char == '+') ? LOG_FMT_FLAG_PLUS :
+           (p_char == ' ') ? LOG_FMT_FLAG_SPACE :
+           (p_char == '0') ? LOG_FMT_FLAG_ZERO : LOG_FMT_FLAG_ALT;
+}
+
+constexpr uint8_t log_fmt_flags(const char * p_ptr_spec, uint16_t p_idx)
+{
+    return log_fmt_is_flag(p_ptr_spec[p_idx]) ?
+           (uint8_t)(log_fmt_flag(p_ptr_spec[p_idx]) | log_fmt_flags(p_ptr_spec, p_idx + 1U)) : 0U;
+}
+
+/* Decimal number at p_idx, held below LOG_FMT_NO_PRECISION */
+constexpr uint8_t log_fmt_number(const char * p_ptr_spec, uint16_t p_idx, uint32_t p_value)
+{
+    return !log_fmt_is_digit(p_ptr_spec[p_idx]) ? (uint8_t)p_value :
+           log_fmt_number(p_ptr_spec, p_idx + 1U,
+                          ((p_value * 10U) + (uint32_t)(p_ptr_spec[p_idx] - '0') >= LOG_FMT_NO_PRECISION) ?
+                          (LOG_FMT_NO_PRECISION - 1U) : ((p_value * 10U) + (uint32_t)(p_ptr_spec[p_idx] - '0')));
+}
+
+constexpr uint8_t log_fmt_precision(const char * p_ptr_spec, uint16_t p_idx)
+{
+    return (p_ptr_spec[p_idx] == '.') ? log_fmt_number(p_ptr_spec, p_idx + 1U, 0U) : LOG_FMT_NO_PRECISION;
+}
+
+/**
+ * @brief This function describes the literal run from p_start and the specifier at p_spec_idx.
+ *        A terminator at p_spec_idx gives the last segment of the format.
+ */
+constexpr log_fmt_segment_t log_fmt_make_segment(const char * p_ptr_fmt, uint16_t p_start, uint16_t p_spec_idx)
+{
+    return (p_ptr_fmt[p_spec_idx] == '\0') ?
+           log_fmt_segment_t{(uint16_t)(p_spec_idx - p_start), 0U, '\0', 0U, 0U, LOG_FMT_NO_PRECISION} :
+           log_fmt_segment_t{(uint16_t)(p_spec_idx - p_start),
+                             (uint8_t)(log_fmt_spec_len(&p_ptr_fmt[p_spec_idx]) + 1U),
+                             p_ptr_fmt[p_spec_idx + log_fmt_spec_len(&p_ptr_fmt[p_spec_idx])],
+                             log_fmt_flags(&p_ptr_fmt[p_spec_idx], 1U),
+                             log_fmt_number(&p_ptr_fmt[p_spec_idx], log_fmt_skip_flags(&p_ptr_fmt[p_spec_idx], 1U), 0U),
+                             log_fmt_precision(&p_ptr_fmt[p_spec_idx],
+                                               log_fmt_skip_digits(&p_ptr_fmt[p_spec_idx],
+                                                                   log_fmt_skip_flags(&p_ptr_fmt[p_spec_idx], 1U)))};
+}
+
+/* Index of the p_spec-th specifier from p_idx on */
+constexpr uint16_t log_fmt_spec_pos(const char * p_ptr_fmt, uint16_t p_idx, uint8_t p_spec)
+{
+    return (p_spec == 0U) ? log_fmt_next_spec(p_ptr_fmt, p_idx) :
+           log_fmt_spec_pos(p_ptr_fmt, log_fmt_spec_end(p_ptr_fmt, log_fmt_next_spec(p_ptr_fmt, p_idx)), p_spec - 1U);
+}
+
+constexpr uint16_t log_fmt_segment_start(const char * p_ptr_fmt, uint8_t p_segment)
+{
+    return (p_segment == 0U) ? 0U : log_fmt_spec_end(p_ptr_fmt, log_fmt_spec_pos(p_ptr_fmt, 0U, p_segment - 1U));
+}
+
+/**
+ * @brief This function builds segment p_segment of the format, the format must have at least
+ *        p_segment specifiers.
+ */
+constexpr log_fmt_segment_t log_fmt_segment(const char * p_ptr_fmt, uint8_t p_segment)
+{
+    return log_fmt_make_segment(p_ptr_fmt, log_fmt_segment_start(p_ptr_fmt, p_segment),
+                                log_fmt_next_spec(p_ptr_fmt, log_fmt_segment_start(p_ptr_fmt, p_segment)));
+}
+
+/* Segment numbers 0 to N - 1, C++11 has no std::index_sequence */
+template <uint8_t... Indices>
+struct log_fmt_indices
+{
+};
+
+template <uint8_t N, uint8_t... Indices>
+struct log_fmt_make_indices : log_fmt_make_indices<N - 1U, N - 1U, Indices...>
+{
+};
+
+template <uint8_t... Indices>
+struct log_fmt_make_indices<0U, Indices...> : log_fmt_indices<Indices...>
+{
+};
+
+/* Segments of one format: one per specifier and the literal tail */
+template <uint8_t N>
+struct log_fmt_table
+{
+    log_fmt_segment_t segments[N];
+
+    template <uint8_t... Indices>
+    constexpr log_fmt_table(const char * p_ptr_fmt, log_fmt_indices<Indices...>)
+        : segments{log_fmt_segment(p_ptr_fmt, Indices)...}
+    {
+    }
+};
+
+/* Floating point values are only shown by %f and addresses only by %x */
+template <typename T>
+constexpr bool log_fmt_accepts(char p_conversion)
+{
+    return (std::is_floating_point<T>::value ? (p_conversion == 'f') : true) &&
+           (std::is_pointer<T>::value ? (p_conversion == 'x') : true);
+}
+
+/* Argument types of a logger_x call, matched one by one against the specifiers */
+template <typename... Args>
+struct log_fmt_types;
+
+template <>
+struct log_fmt_types<>
+{
+    static constexpr uint8_t count = 0U;
+    static constexpr bool matches(const char * p_ptr_fmt, uint16_t p_idx)
+    {
+        return (p_ptr_fmt[log_fmt_next_spec(p_ptr_fmt, p_idx)] == '\0');
+    }
+};
+
+template <typename T, typename... Rest>
+struct log_fmt_types<T, Rest...>
+{
+    static constexpr uint8_t count = 1U + sizeof...(Rest);
+    static constexpr bool matches_at(const char * p_ptr_fmt, uint16_t p_spec_idx)
+    {
+        return (p_ptr_fmt[p_spec_idx] != '\0') &&
+               log_fmt_accepts<T>(p_ptr_fmt[p_spec_idx + log_fmt_spec_len(&p_ptr_fmt[p_spec_idx])]) &&
+               log_fmt_types<Rest...>::matches(p_ptr_fmt, log_fmt_spec_end(p_ptr_fmt, p_spec_idx));
+    }
+    static constexpr bool matches(const char * p_ptr_fmt, uint16_t p_idx)
+    {
+        return matches_at(p_ptr_fmt, log_fmt_next_spec(p_ptr_fmt, p_idx));
+    }
+};
+
+/* Only used in decltype, the arguments are never evaluated */
+template <typename... Args>
+log_fmt_types<typename std::decay<Args>::type...> log_fmt_arg_types(const char * p_ptr_fmt, const Args &... p_args);
+
+/**
+ * @brief This function formats the log message with the specified log level and queues it.
+ *        Each argument keeps its type, so integers are not rounded through float.
+ * 
+ * @param p_lvl           input: Log level
+ * @param p_ptr_func_name input: Name of the calling function, NULL to omit it
+ * @param p_ptr_segments  input: Segment table of the message, NULL to scan it at run time
+ * @param p_ptr_msg       input: Log message, may contain %d, %x and %f
+ * @param p_args          input: One argument per format specifier, at most LOG_MAX_ARGS
+ */
+template <typename... Args>
+inline void logger(debug_level_t p_lvl,
+                   const char * p_ptr_func_name,
+                   const log_fmt_segment_t * p_ptr_segments,
+                   const char * p_ptr_msg,
+                   Args... p_args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+    /* The trailing element keeps the array non-empty when there are no arguments */
+    const log_arg_t args_list[] = {log_arg_make(p_args)..., log_arg_make_typed(LOG_ARG_UINT32, 0U)};
+    logger_write(p_lvl, p_ptr_func_name, p_ptr_segments, p_ptr_msg, args_list, (uint8_t)sizeof...(Args));
+}
 
 #endif /* DEBUG_LOGGER_H */
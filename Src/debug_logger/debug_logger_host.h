@@ -0,0 +1,189 @@
+/***************************************************************************************************
+* File Name: debug_logger_host.h
+* Module: debug_logger
+* Abstract: Host (Linux) stand-ins of the Arduino and FreeRTOS calls used by the debug_logger and
+*           debug_trace modules, so they build and run natively, e.g. to measure the logger.
+*           Tasks are threads, task notifications are condition variables and the tick is 1 ms.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+#ifndef DEBUG_LOGGER_HOST_H
+#define DEBUG_LOGGER_HOST_H
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+#define pdFALSE (0)
+#define pdTRUE (1)
+#define pdFAIL (0)
+#define pdPASS (1)
+#define tskIDLE_PRIORITY (0U)
+#define portNUM_PROCESSORS (1)
+#define pdMS_TO_TICKS(p_ms) ((TickType_t)(p_ms))
+
+#define portMUX_INITIALIZER_UNLOCKED {ATOMIC_FLAG_INIT}
+#define portENTER_CRITICAL(p_ptr_mux) log_host_enter_critical(p_ptr_mux)
+#define portEXIT_CRITICAL(p_ptr_mux) log_host_exit_critical(p_ptr_mux)
+
+/***************************************************************************************************
+* External type declarations.
+***************************************************************************************************/
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+/* Spin lock, like the FreeRTOS critical sections of the ESP32 */
+typedef struct portMUX_TYPE_struct
+{
+    std::atomic_flag lock;
+} portMUX_TYPE;
+
+typedef struct log_host_task_t_struct
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t notify_count;
+} log_host_task_t;
+
+typedef log_host_task_t * TaskHandle_t;
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+inline std::chrono::steady_clock::time_point log_host_start_time(void)
+{
+    static const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+    return s_start;
+}
+
+inline int64_t esp_timer_get_time(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - log_host_start_time()).count();
+}
+
+inline unsigned long micros(void)
+{
+    return (unsigned long)esp_timer_get_time();
+}
+
+inline unsigned long millis(void)
+{
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+inline void delay(uint32_t p_ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(p_ms));
+}
+
+inline void vTaskDelay(TickType_t p_ticks)
+{
+    delay(p_ticks);
+}
+
+inline BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+inline void log_host_enter_critical(portMUX_TYPE * p_ptr_mux)
+{
+    while (p_ptr_mux->lock.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline void log_host_exit_critical(portMUX_TYPE * p_ptr_mux)
+{
+    p_ptr_mux->lock.clear(std::memory_order_release);
+}
+
+/* Task of the calling thread, NULL for threads not created by xTaskCreate */
+inline TaskHandle_t & log_host_current_task(void)
+{
+    static thread_local TaskHandle_t s_task = NULL;
+    return s_task;
+}
+
+/**
+ * @brief Runs the task on a detached thread, the stack size and priority are ignored.
+ */
+inline BaseType_t xTaskCreate(TaskFunction_t p_task_func,
+                              const char * p_ptr_name,
+                              uint32_t p_stack_size,
+                              void * p_ptr_param,
+                              UBaseType_t p_priority,
+                              TaskHandle_t * p_ptr_task_hnd)
+{
+    TaskHandle_t task_hnd = new log_host_task_t();
+
+    (void)p_ptr_name;
+    (void)p_stack_size;
+    (void)p_priority;
+    task_hnd->notify_count = 0U;
+    if (NULL != p_ptr_task_hnd)
+    {
+        *p_ptr_task_hnd = task_hnd;
+    }
+    std::thread([task_hnd, p_task_func, p_ptr_param]()
+                {
+                    log_host_current_task() = task_hnd;
+                    p_task_func(p_ptr_param);
+                }).detach();
+    return pdPASS;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t p_task_hnd)
+{
+    std::lock_guard<std::mutex> lock(p_task_hnd->mutex);
+    p_task_hnd->notify_count++;
+    p_task_hnd->cond.notify_one();
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t p_clear_on_exit, TickType_t p_ticks)
+{
+    TaskHandle_t task_hnd = log_host_current_task();
+    uint32_t notify_count = 0U;
+
+    if (NULL == task_hnd)
+    {
+        vTaskDelay(p_ticks);
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(task_hnd->mutex);
+        task_hnd->cond.wait_for(lock, std::chrono::milliseconds(p_ticks),
+                                [task_hnd]() { return (task_hnd->notify_count > 0U); });
+        notify_count = task_hnd->notify_count;
+        if (notify_count > 0U)
+        {
+            task_hnd->notify_count = (pdFALSE != p_clear_on_exit) ? 0U : (notify_count - 1U);
+        }
+    }
+    return notify_count;
+}
+
+#endif /* DEBUG_LOGGER_HOST_H */
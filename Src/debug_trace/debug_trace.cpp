@@ -0,0 +1,204 @@
+/***************************************************************************************************
+ * File Name: debug_trace.c
+ * Module: debug_trace
+ * Abstract: Implementation of "/lib/debug_trace/debug_trace.h" module.
+ * Author: Naim ALMASRI
+ * Date: 19.10.2026
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "debug_trace.h"
+
+#ifdef TRACE_EN
+
+#include "string_util.h"
+#include <atomic>
+#if defined(__linux__)
+#include "debug_logger_host.h"
+#else
+#include <Arduino.h>
+#include <esp_timer.h>
+#endif
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+#define TRACE_RING_MASK (TRACE_RING_DEPTH - 1U)
+
+/* Same clock as the log records, so spans and log lines line up */
+#define TRACE_CORE_COUNT ((uint8_t)portNUM_PROCESSORS)
+#define TRACE_GET_TIME_US() ((uint32_t)esp_timer_get_time())
+#define TRACE_GET_CORE_ID() ((uint8_t)xPortGetCoreID())
+
+/* Longer names are cut, so the JSON line of an event always fits */
+#define TRACE_NAME_MAX_LEN (64U)
+#define TRACE_JSON_LINE_MAX_LEN (192U)
+#define TRACE_JSON_HEAD "{\"traceEvents\":[\n"
+#define TRACE_JSON_TAIL "\n]}\n"
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+typedef struct trace_data_t_struct
+{
+    const char * name_ptr;
+    uint32_t start_us;
+    uint32_t value;
+    uint8_t type;
+} trace_data_t;
+
+/* Fixed size entry. The sequence is 0 while the entry is written and its ring position + 1 after,
+   so the dump skips entries that are being overwritten */
+typedef struct trace_entry_t_struct
+{
+    std::atomic<uint32_t> sequence;
+    trace_data_t data;
+} trace_entry_t;
+
+typedef struct trace_ring_t_struct
+{
+    std::atomic<uint32_t> head;
+    trace_entry_t entries[TRACE_RING_DEPTH];
+} trace_ring_t;
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/* One ring per core, tasks and ISRs of a core only contend on the head of their own ring */
+static trace_ring_t s_trace_rings[TRACE_CORE_COUNT];
+static volatile bool s_trace_is_enabled = true;
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+static void trace_put_name(string_builder_t * p_ptr_line, const char * p_ptr_name)
+{
+    for (uint16_t i = 0U; (i < TRACE_NAME_MAX_LEN) && (p_ptr_name[i] != '\0'); i++)
+    {
+        /* A quote or backslash would break the JSON string */
+        string_builder_append_char(p_ptr_line,
+            ((p_ptr_name[i] == '"') || (p_ptr_name[i] == '\\')) ? '\'' : p_ptr_name[i]);
+    }
+}
+
+/**
+ * @brief Renders one entry as a trace event, spans are complete ("X") events.
+ */
+static void trace_format_entry(string_builder_t * p_ptr_line, const trace_data_t * p_ptr_data, uint8_t p_core_id)
+{
+    STRING_BUILDER_APPEND_LITERAL(p_ptr_line, "{\"name\":\"");
+    trace_put_name(p_ptr_line, p_ptr_data->name_ptr);
+    if (p_ptr_data->type == TRACE_EVENT_SPAN)
+    {
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_line, "\",\"ph\":\"X\",\"ts\":");
+        string_builder_append_u32(p_ptr_line, p_ptr_data->start_us);
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_line, ",\"dur\":");
+        string_builder_append_u32(p_ptr_line, p_ptr_data->value);
+    }
+    else
+    {
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_line, "\",\"ph\":\"i\",\"s\":\"t\",\"ts\":");
+        string_builder_append_u32(p_ptr_line, p_ptr_data->start_us);
+        STRING_BUILDER_APPEND_LITERAL(p_ptr_line, ",\"args\":{\"value\":");
+        string_builder_append_u32(p_ptr_line, p_ptr_data->value);
+        string_builder_append_char(p_ptr_line, '}');
+    }
+    STRING_BUILDER_APPEND_LITERAL(p_ptr_line, ",\"pid\":0,\"tid\":");
+    string_builder_append_u32(p_ptr_line, p_core_id);
+    string_builder_append_char(p_ptr_line, '}');
+}
+
+/***************************************************************************************************
+ * External data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+IRAM_ATTR uint32_t debug_trace_now(void)
+{
+    return TRACE_GET_TIME_US();
+}
+
+IRAM_ATTR void debug_trace_record(trace_event_t p_type, const char * p_ptr_name, uint32_t p_start_us, uint32_t p_value)
+{
+    trace_ring_t * ring_ptr = &s_trace_rings[TRACE_GET_CORE_ID()];
+    trace_entry_t * entry_ptr = NULL;
+    uint32_t pos = 0U;
+
+    if (true == s_trace_is_enabled)
+    {
+        pos = ring_ptr->head.fetch_add(1U, std::memory_order_relaxed);
+        entry_ptr = &ring_ptr->entries[pos & TRACE_RING_MASK];
+        entry_ptr->sequence.store(0U, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry_ptr->data.name_ptr = p_ptr_name;
+        entry_ptr->data.start_us = p_start_us;
+        entry_ptr->data.value = p_value;
+        entry_ptr->data.type = (uint8_t)p_type;
+        entry_ptr->sequence.store(pos + 1U, std::memory_order_release);
+    }
+}
+
+void debug_trace_enable(bool p_is_enabled)
+{
+    s_trace_is_enabled = p_is_enabled;
+}
+
+uint32_t debug_trace_dump(log_sink_t * p_ptr_sink)
+{
+    char line_buf[TRACE_JSON_LINE_MAX_LEN];
+    string_builder_t line;
+    trace_entry_t * entry_ptr = NULL;
+    trace_data_t data;
+    uint32_t head = 0U;
+    uint32_t pos = 0U;
+    uint32_t event_count = 0U;
+
+    if (NULL != p_ptr_sink)
+    {
+        debug_agents_flush();
+        debug_agents_write_sink(p_ptr_sink, (const uint8_t *)TRACE_JSON_HEAD, sizeof(TRACE_JSON_HEAD) - 1U);
+        for (uint8_t core_id = 0U; core_id < TRACE_CORE_COUNT; core_id++)
+        {
+            head = s_trace_rings[core_id].head.load(std::memory_order_acquire);
+            pos = (head > TRACE_RING_DEPTH) ? (head - TRACE_RING_DEPTH) : 0U;
+            for (; pos != head; pos++)
+            {
+                /* Copy the entry, then check it was not rewritten in the meantime */
+                entry_ptr = &s_trace_rings[core_id].entries[pos & TRACE_RING_MASK];
+                if (entry_ptr->sequence.load(std::memory_order_acquire) != (pos + 1U))
+                {
+                    continue;
+                }
+                data = entry_ptr->data;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (entry_ptr->sequence.load(std::memory_order_relaxed) != (pos + 1U))
+                {
+                    continue;
+                }
+
+                string_builder_init(&line, line_buf, sizeof(line_buf));
+                if (event_count > 0U)
+                {
+                    STRING_BUILDER_APPEND_LITERAL(&line, ",\n");
+                }
+                trace_format_entry(&line, &data, core_id);
+                debug_agents_write_sink(p_ptr_sink, (const uint8_t *)line.buf, line.length);
+                event_count++;
+            }
+        }
+        debug_agents_write_sink(p_ptr_sink, (const uint8_t *)TRACE_JSON_TAIL, sizeof(TRACE_JSON_TAIL) - 1U);
+    }
+    return event_count;
+}
+
+#endif /* TRACE_EN */
@@ -0,0 +1,121 @@
+/***************************************************************************************************
+* File Name: debug_trace.h
+* Module: debug_trace
+* Abstract: Interface definition for "/lib/debug_trace/debug_trace.c" module.
+*           Scoped spans and instant events kept in a ring per core, dumped as Chrome trace JSON.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+#ifndef DEBUG_TRACE_H
+#define DEBUG_TRACE_H
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include "HW_comm.h"
+#include "debug_logger.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+/* Number of events kept per core, the oldest ones are overwritten. Must be a power of 2 */
+#ifndef TRACE_RING_DEPTH
+#define TRACE_RING_DEPTH (256U)
+#endif
+
+#define TRACE_NAME_(p_prefix, p_line) p_prefix##p_line
+#define TRACE_NAME(p_prefix, p_line) TRACE_NAME_(p_prefix, p_line)
+
+/* Names must be string literals, only their address is recorded.
+   Without TRACE_EN nothing is compiled in, neither the calls nor the rings */
+#ifdef TRACE_EN
+#define TRACE_SCOPE(p_name) trace_span_t TRACE_NAME(trace_span_, __LINE__)(p_name)
+#define TRACE_INSTANT(p_name, p_value) \
+    debug_trace_record(TRACE_EVENT_INSTANT, (p_name), debug_trace_now(), (uint32_t)(p_value))
+#else
+#define TRACE_SCOPE(p_name) ((void)0)
+#define TRACE_INSTANT(p_name, p_value) ((void)0)
+#endif /* TRACE_EN */
+
+/***************************************************************************************************
+* External type declarations.
+***************************************************************************************************/
+
+typedef enum trace_event_t_enum
+{
+    TRACE_EVENT_SPAN = 0,   /* Time spent in a scope */
+    TRACE_EVENT_INSTANT,    /* Point in time with a value */
+} trace_event_t;
+
+/***************************************************************************************************
+* External data declarations.
+***************************************************************************************************/
+
+/***************************************************************************************************
+* External function declarations.
+***************************************************************************************************/
+
+#ifdef TRACE_EN
+
+/**
+ * @brief This function gets the trace clock, in us. It is safe to call from an IRAM ISR.
+ */
+uint32_t debug_trace_now(void);
+
+/**
+ * @brief This function records an event in the ring of the calling core.
+ *        It does not block and is safe to call from an IRAM ISR.
+ *
+ * @param p_type     input: Type of the event
+ * @param p_ptr_name input: Name of the event, a string literal
+ * @param p_start_us input: Start time of a span or time of an instant event, from debug_trace_now()
+ * @param p_value    input: Duration of a span in us or the value of an instant event
+ */
+void debug_trace_record(trace_event_t p_type, const char * p_ptr_name, uint32_t p_start_us, uint32_t p_value);
+
+/**
+ * @brief This function pauses or resumes the recording of events, it is enabled at startup.
+ *
+ * @param p_is_enabled input: true to record events
+ */
+void debug_trace_enable(bool p_is_enabled);
+
+/**
+ * @brief This function writes the recorded events to a log sink as Chrome trace event JSON,
+ *        to be opened in about:tracing or Perfetto. The log queue is flushed first, log messages
+ *        written to the same sink while the dump runs end up inside the JSON.
+ *
+ * @param p_ptr_sink input: Sink that receives the JSON, e.g. debug_agents_get_sink("uart")
+ * @return The number of events written
+ */
+uint32_t debug_trace_dump(log_sink_t * p_ptr_sink);
+
+/* Records the time spent between its construction and the end of the scope.
+   It is always inlined, so a span in an IRAM ISR does not call into flash */
+class trace_span_t
+{
+public:
+    __attribute__((always_inline)) explicit trace_span_t(const char * p_ptr_name)
+        : m_name_ptr(p_ptr_name), m_start_us(debug_trace_now())
+    {
+    }
+
+    __attribute__((always_inline)) ~trace_span_t()
+    {
+        debug_trace_record(TRACE_EVENT_SPAN, m_name_ptr, m_start_us, debug_trace_now() - m_start_us);
+    }
+
+private:
+    trace_span_t(const trace_span_t &);
+    trace_span_t & operator=(const trace_span_t &);
+
+    const char * m_name_ptr;
+    uint32_t m_start_us;
+};
+
+#endif /* TRACE_EN */
+
+#endif /* DEBUG_TRACE_H */
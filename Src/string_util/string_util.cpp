@@ -10,8 +10,16 @@
 * Header files.
 ***************************************************************************************************/
 
+#if defined(__linux__)
+#include <string.h>
+#else
 #include "Arduino.h"
+#endif
 #include "string_util.h"
+#include <math.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /***************************************************************************************************
 * Macro definitions.
@@ -19,18 +27,711 @@
 
 #define MAX_STRING_LEN (1000U)
 
+/* Largest power of 10 that fits in 32 bits, 64-bit numbers are split in chunks of 9 digits */
+#define DECIMAL_CHUNK_VAL (1000000000U)
+#define DECIMAL_CHUNK_DIGITS (9U)
+
+/* Smallest magnitude whose integer part does not fit in 64 bits */
+#define FTOA_FIXED_LIMIT (18446744073709551616.0)
+
+/* Significant digits kept by the float parser, any 19 digits fit in 64 bits */
+#define PARSE_FLOAT_MAX_DIGITS (19U)
+/* Largest power of 10 that is exact as a double */
+#define PARSE_POW10_MAX_EXACT (22)
+/* Beyond these decimal exponents of the 19 digit mantissa, a float is always inf or 0 */
+#define PARSE_FLOAT_MAX_EXP10 (39)
+#define PARSE_FLOAT_MIN_EXP10 (-66)
+/* The exponent digits stop being accumulated past this, the value is out of range anyway */
+#define PARSE_EXP_DIGITS_LIMIT (10000)
+
+/* The byte in every lane of a 32-bit word, for the SWAR (SIMD within a register) code */
+#define SWAR_LANES(p_byte) (0x01010101U * (uint32_t)(p_byte))
+
+/* Marks the base64 characters that are not part of the alphabet */
+#define BASE64_INVALID_VAL (0xFFU)
+
+/* Float fields and the precision of the scaled powers of 5 of the shortest conversion */
+#define FLOAT_MANTISSA_BITS (23U)
+#define FLOAT_EXPONENT_MASK (0xFFU)
+#define FLOAT_EXPONENT_BIAS (127)
+#define FLOAT_POW5_INV_BITCOUNT (59)
+#define FLOAT_POW5_BITCOUNT (61)
+/* Length of the "e+XX" of the shortest scientific form, float exponents have two digits */
+#define SHORTEST_SCI_EXP_LEN (4U)
+
 /***************************************************************************************************
 * Local type definitions.
 ***************************************************************************************************/
 
+/* Shortest decimal form of a float, its value is digits * 10^exponent */
+typedef struct shortest_decimal_t_struct
+{
+    uint32_t digits;
+    int32_t exponent;
+} shortest_decimal_t;
+
 /***************************************************************************************************
  * Local data definitions.
 ***************************************************************************************************/
 
+/* "00" to "99", two decimal digits per lookup */
+static const char s_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char s_hex_digits[17] = "0123456789abcdef";
+
+static const char s_base64_chars[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Value of every base64 character, BASE64_INVALID_VAL for the others */
+static const uint8_t s_base64_values[256] = {
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x3EU, 0xFFU, 0xFFU, 0xFFU, 0x3FU,
+    0x34U, 0x35U, 0x36U, 0x37U, 0x38U, 0x39U, 0x3AU, 0x3BU, 0x3CU, 0x3DU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0x00U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U, 0x09U, 0x0AU, 0x0BU, 0x0CU, 0x0DU, 0x0EU,
+    0x0FU, 0x10U, 0x11U, 0x12U, 0x13U, 0x14U, 0x15U, 0x16U, 0x17U, 0x18U, 0x19U, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0x1AU, 0x1BU, 0x1CU, 0x1DU, 0x1EU, 0x1FU, 0x20U, 0x21U, 0x22U, 0x23U, 0x24U, 0x25U, 0x26U, 0x27U, 0x28U,
+    0x29U, 0x2AU, 0x2BU, 0x2CU, 0x2DU, 0x2EU, 0x2FU, 0x30U, 0x31U, 0x32U, 0x33U, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU
+};
+
+static const uint32_t s_pow10_u32[STRING_FTOA_MAX_DECIMALS + 1U] = {
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+};
+
+static const double s_pow10_f64[PARSE_POW10_MAX_EXACT + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* floor(2^(pow5_bits(q) - 1 + FLOAT_POW5_INV_BITCOUNT) / 5^q) + 1, for the floats of 2^0 and above */
+static const uint64_t s_float_pow5_inv[31] = {
+    0x0800000000000001U, 0x0666666666666667U, 0x051eb851eb851eb9U, 0x04189374bc6a7efaU,
+    0x068db8bac710cb2aU, 0x053e2d6238da3c22U, 0x0431bde82d7b634eU, 0x06b5fca6af2bd216U,
+    0x055e63b88c230e78U, 0x044b82fa09b5a52dU, 0x06df37f675ef6eaeU, 0x057f5ff85e592558U,
+    0x0465e6604b7a8447U, 0x0709709a125da071U, 0x05a126e1a84ae6c1U, 0x0480ebe7b9d58567U,
+    0x0734aca5f6226f0bU, 0x05c3bd5191b525a3U, 0x049c97747490eae9U, 0x0760f253edb4ab0eU,
+    0x05e72843249088d8U, 0x04b8ed0283a6d3e0U, 0x078e480405d7b966U, 0x060b6cd004ac9452U,
+    0x04d5f0a66a23a9dbU, 0x07bcb43d769f762bU, 0x063090312bb2c4efU, 0x04f3a68dbc8f03f3U,
+    0x07ec3daf94180651U, 0x065697bfa9acd1daU, 0x051212ffbaf0a7e2U,
+};
+
+/* 5^i scaled to FLOAT_POW5_BITCOUNT bits, for the floats below 2^0 */
+static const uint64_t s_float_pow5[48] = {
+    0x1000000000000000U, 0x1400000000000000U, 0x1900000000000000U, 0x1f40000000000000U,
+    0x1388000000000000U, 0x186a000000000000U, 0x1e84800000000000U, 0x1312d00000000000U,
+    0x17d7840000000000U, 0x1dcd650000000000U, 0x12a05f2000000000U, 0x174876e800000000U,
+    0x1d1a94a200000000U, 0x12309ce540000000U, 0x16bcc41e90000000U, 0x1c6bf52634000000U,
+    0x11c37937e0800000U, 0x16345785d8a00000U, 0x1bc16d674ec80000U, 0x1158e460913d0000U,
+    0x15af1d78b58c4000U, 0x1b1ae4d6e2ef5000U, 0x10f0cf064dd59200U, 0x152d02c7e14af680U,
+    0x1a784379d99db420U, 0x108b2a2c28029094U, 0x14adf4b7320334b9U, 0x19d971e4fe8401e7U,
+    0x1027e72f1f128130U, 0x1431e0fae6d7217cU, 0x193e5939a08ce9dbU, 0x1f8def8808b02452U,
+    0x13b8b5b5056e16b3U, 0x18a6e32246c99c60U, 0x1ed09bead87c0378U, 0x13426172c74d822bU,
+    0x1812f9cf7920e2b6U, 0x1e17b84357691b64U, 0x12ced32a16a1b11eU, 0x178287f49c4a1d66U,
+    0x1d6329f1c35ca4bfU, 0x125dfa371a19e6f7U, 0x16f578c4e0a060b5U, 0x1cb2d6f618c878e3U,
+    0x11efc659cf7d4b8dU, 0x166bb7f0435c9e71U, 0x1c06a5ec5433c60dU, 0x118427b3b4a05bc8U,
+};
+
 /***************************************************************************************************
 * Local function definitions.
 ***************************************************************************************************/
 
+static uint32_t count_digits_u32(uint32_t p_num)
+{
+    uint32_t digits = 1U;
+
+    if (p_num >= 100000U)
+    {
+        digits = (p_num >= 10000000U) ? ((p_num >= 1000000000U) ? 10U : ((p_num >= 100000000U) ? 9U : 8U)) :
+                                        ((p_num >= 1000000U) ? 7U : 6U);
+    }
+    else
+    {
+        digits = (p_num >= 1000U) ? ((p_num >= 10000U) ? 5U : 4U) :
+                                    ((p_num >= 100U) ? 3U : ((p_num >= 10U) ? 2U : 1U));
+    }
+    return digits;
+}
+
+/**
+ * @brief Writes exactly p_digits digits of the number, ending right before p_ptr_end.
+ */
+static void write_digits_u32(char * p_ptr_end, uint32_t p_num, uint32_t p_digits)
+{
+    uint32_t pair_idx = 0U;
+
+    while (p_digits >= 2U)
+    {
+        pair_idx = (p_num % 100U) * 2U;
+        p_num /= 100U;
+        *--p_ptr_end = s_digit_pairs[pair_idx + 1U];
+        *--p_ptr_end = s_digit_pairs[pair_idx];
+        p_digits -= 2U;
+    }
+    if (p_digits > 0U)
+    {
+        *--p_ptr_end = (char)('0' + (p_num % 10U));
+    }
+}
+
+static uint32_t count_nibbles_u32(uint32_t p_num)
+{
+    return (p_num == 0U) ? 1U : ((35U - (uint32_t)__builtin_clz(p_num)) / 4U);
+}
+
+static void write_nibbles_u32(char * p_ptr_end, uint32_t p_num, uint32_t p_nibbles)
+{
+    while (p_nibbles > 0U)
+    {
+        *--p_ptr_end = s_hex_digits[p_num & 0xFU];
+        p_num >>= 4;
+        p_nibbles--;
+    }
+}
+
+/**
+ * @brief Splits a magnitude below 2^64 in its integer part and its fraction scaled to the decimals,
+ *        rounded half to even on the scaled value. Only the fraction is scaled, so nothing overflows.
+ */
+static void split_fixed(double p_magnitude, uint32_t p_after_point, uint64_t * p_ptr_int_part, uint32_t * p_ptr_frac_part)
+{
+    uint64_t int_part = (uint64_t)p_magnitude;
+    double frac_scaled = (p_magnitude - (double)int_part) * (double)s_pow10_u32[p_after_point];
+    uint32_t frac_part = (uint32_t)frac_scaled;
+    double remainder = frac_scaled - (double)frac_part;
+    uint32_t last_digit = (p_after_point == 0U) ? (uint32_t)(int_part & 1U) : (frac_part & 1U);
+
+    if ((remainder > 0.5) || ((remainder == 0.5) && (last_digit != 0U)))
+    {
+        frac_part++;
+        if (frac_part == s_pow10_u32[p_after_point])
+        {
+            frac_part = 0U;
+            int_part++;
+        }
+    }
+    *p_ptr_int_part = int_part;
+    *p_ptr_frac_part = frac_part;
+}
+
+static uint32_t write_fixed(char * p_ptr_str, uint64_t p_int_part, uint32_t p_frac_part, uint32_t p_after_point)
+{
+    uint32_t len = string_u64toa(p_int_part, p_ptr_str);
+
+    if (p_after_point > 0U)
+    {
+        p_ptr_str[len++] = '.';
+        len += p_after_point;
+        write_digits_u32(&p_ptr_str[len], p_frac_part, p_after_point);
+    }
+    return len;
+}
+
+/**
+ * @brief Writes a positive finite magnitude as d.ddde+XX, the exponent has at least two digits.
+ */
+static uint32_t write_scientific(char * p_ptr_str, double p_magnitude, uint32_t p_after_point)
+{
+    int32_t exponent = 0;
+    double mantissa = 0.0;
+    uint64_t int_part = 0U;
+    uint32_t frac_part = 0U;
+    uint32_t len = 0U;
+
+    if (p_magnitude > 0.0)
+    {
+        exponent = (int32_t)floor(log10(p_magnitude));
+        mantissa = p_magnitude / pow(10.0, (double)exponent);
+        /* log10() may be off by one next to powers of 10 */
+        if (mantissa >= 10.0)
+        {
+            mantissa /= 10.0;
+            exponent++;
+        }
+        else if (mantissa < 1.0)
+        {
+            mantissa *= 10.0;
+            exponent--;
+        }
+    }
+    split_fixed(mantissa, p_after_point, &int_part, &frac_part);
+    if (int_part >= 10U)
+    {
+        /* 9.999 rounded up to 10.000 */
+        int_part = 1U;
+        exponent++;
+    }
+    len = write_fixed(p_ptr_str, int_part, frac_part, p_after_point);
+    p_ptr_str[len++] = 'e';
+    p_ptr_str[len++] = (exponent < 0) ? '-' : '+';
+    if (exponent < 0)
+    {
+        exponent = -exponent;
+    }
+    if (exponent < 10)
+    {
+        p_ptr_str[len++] = '0';
+    }
+    len += string_u32toa((uint32_t)exponent, &p_ptr_str[len]);
+    return len;
+}
+
+/* ceil(log2(5^p_exp)) for p_exp > 0 and 1 for 0, floor(log10(2^p_exp)) and floor(log10(5^p_exp)) */
+static inline int32_t pow5_bits(int32_t p_exp)
+{
+    return (int32_t)(((uint32_t)p_exp * 1217359U) >> 19) + 1;
+}
+
+static inline uint32_t log10_pow2(int32_t p_exp)
+{
+    return ((uint32_t)p_exp * 78913U) >> 18;
+}
+
+static inline uint32_t log10_pow5(int32_t p_exp)
+{
+    return ((uint32_t)p_exp * 732923U) >> 20;
+}
+
+static bool is_multiple_of_pow5(uint32_t p_num, uint32_t p_exp)
+{
+    uint32_t count = 0U;
+
+    while ((count < p_exp) && ((p_num % 5U) == 0U))
+    {
+        p_num /= 5U;
+        count++;
+    }
+    return (count >= p_exp);
+}
+
+static inline bool is_multiple_of_pow2(uint32_t p_num, uint32_t p_exp)
+{
+    return ((p_num & ((1U << p_exp) - 1U)) == 0U);
+}
+
+/**
+ * @brief (p_num * p_factor) >> p_shift with two 32x32 bit products, p_shift is above 32.
+ */
+static inline uint32_t mul_shift_u32(uint32_t p_num, uint64_t p_factor, int32_t p_shift)
+{
+    uint64_t low = (uint64_t)p_num * (uint32_t)p_factor;
+    uint64_t high = (uint64_t)p_num * (uint32_t)(p_factor >> 32);
+
+    return (uint32_t)(((low >> 32) + high) >> (p_shift - 32));
+}
+
+/**
+ * @brief Finds the fewest digits that read back as the float, the closest to it if there are several.
+ *        This is Ryu (Ulf Adams, PLDI 2018): the value and the bounds of its rounding interval are
+ *        scaled by a power of 10 with one multiplication each, then digits are dropped while the
+ *        bounds still differ. The float must be finite and not zero.
+ */
+static void float_to_shortest(uint32_t p_mantissa, uint32_t p_biased_exp, shortest_decimal_t * p_ptr_decimal)
+{
+    /* Value, upper and lower bound as 4 * m2 * 2^e2 and the half-way points next to it */
+    int32_t e2 = ((0U == p_biased_exp) ? 1 : (int32_t)p_biased_exp) - FLOAT_EXPONENT_BIAS - (int32_t)FLOAT_MANTISSA_BITS - 2;
+    uint32_t m2 = (0U == p_biased_exp) ? p_mantissa : ((1U << FLOAT_MANTISSA_BITS) | p_mantissa);
+    bool is_even = ((m2 & 1U) == 0U);
+    uint32_t mv = 4U * m2;
+    uint32_t mp = (4U * m2) + 2U;
+    /* The gap below a power of 2 is half the gap above it */
+    uint32_t mm_shift = ((0U != p_mantissa) || (p_biased_exp <= 1U)) ? 1U : 0U;
+    uint32_t mm = (4U * m2) - 1U - mm_shift;
+    uint32_t vr = 0U;
+    uint32_t vp = 0U;
+    uint32_t vm = 0U;
+    uint32_t q = 0U;
+    int32_t e10 = 0;
+    int32_t i = 0;
+    int32_t j = 0;
+    int32_t removed = 0;
+    bool is_vm_trailing_zeros = false;
+    bool is_vr_trailing_zeros = false;
+    uint32_t last_removed_digit = 0U;
+
+    if (e2 >= 0)
+    {
+        q = log10_pow2(e2);
+        e10 = (int32_t)q;
+        i = -e2 + (int32_t)q + FLOAT_POW5_INV_BITCOUNT + pow5_bits((int32_t)q) - 1;
+        vr = mul_shift_u32(mv, s_float_pow5_inv[q], i);
+        vp = mul_shift_u32(mp, s_float_pow5_inv[q], i);
+        vm = mul_shift_u32(mm, s_float_pow5_inv[q], i);
+        if ((q != 0U) && (((vp - 1U) / 10U) <= (vm / 10U)))
+        {
+            /* The loop below may not run, one removed digit is needed for the rounding */
+            j = -e2 + (int32_t)q - 1 + FLOAT_POW5_INV_BITCOUNT + pow5_bits((int32_t)q - 1) - 1;
+            last_removed_digit = mul_shift_u32(mv, s_float_pow5_inv[q - 1U], j) % 10U;
+        }
+        if (q <= 9U)
+        {
+            /* Only one of mp, mv and mm can be a multiple of 5, if any */
+            if ((mv % 5U) == 0U)
+            {
+                is_vr_trailing_zeros = is_multiple_of_pow5(mv, q);
+            }
+            else if (true == is_even)
+            {
+                is_vm_trailing_zeros = is_multiple_of_pow5(mm, q);
+            }
+            else
+            {
+                vp -= (true == is_multiple_of_pow5(mp, q)) ? 1U : 0U;
+            }
+        }
+    }
+    else
+    {
+        q = log10_pow5(-e2);
+        e10 = (int32_t)q + e2;
+        i = -e2 - (int32_t)q;
+        j = (int32_t)q - (pow5_bits(i) - FLOAT_POW5_BITCOUNT);
+        vr = mul_shift_u32(mv, s_float_pow5[i], j);
+        vp = mul_shift_u32(mp, s_float_pow5[i], j);
+        vm = mul_shift_u32(mm, s_float_pow5[i], j);
+        if ((q != 0U) && (((vp - 1U) / 10U) <= (vm / 10U)))
+        {
+            j = (int32_t)q - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            last_removed_digit = mul_shift_u32(mv, s_float_pow5[i + 1], j) % 10U;
+        }
+        if (q <= 1U)
+        {
+            /* mv has at least 2 trailing zero bits, mm has one if mm_shift is 1 */
+            is_vr_trailing_zeros = true;
+            if (true == is_even)
+            {
+                is_vm_trailing_zeros = (mm_shift == 1U);
+            }
+            else
+            {
+                vp--;
+            }
+        }
+        else if (q < 31U)
+        {
+            is_vr_trailing_zeros = is_multiple_of_pow2(mv, q - 1U);
+        }
+    }
+
+    if ((true == is_vm_trailing_zeros) || (true == is_vr_trailing_zeros))
+    {
+        /* Rare case, the bounds may be exact and the value may be a tie */
+        while ((vp / 10U) > (vm / 10U))
+        {
+            is_vm_trailing_zeros = is_vm_trailing_zeros && ((vm % 10U) == 0U);
+            is_vr_trailing_zeros = is_vr_trailing_zeros && (last_removed_digit == 0U);
+            last_removed_digit = vr % 10U;
+            vr /= 10U;
+            vp /= 10U;
+            vm /= 10U;
+            removed++;
+        }
+        if (true == is_vm_trailing_zeros)
+        {
+            while ((vm % 10U) == 0U)
+            {
+                is_vr_trailing_zeros = is_vr_trailing_zeros && (last_removed_digit == 0U);
+                last_removed_digit = vr % 10U;
+                vr /= 10U;
+                vp /= 10U;
+                vm /= 10U;
+                removed++;
+            }
+        }
+        if ((true == is_vr_trailing_zeros) && (last_removed_digit == 5U) && ((vr % 2U) == 0U))
+        {
+            /* Exactly half way, round to even */
+            last_removed_digit = 4U;
+        }
+        p_ptr_decimal->digits = vr + ((((vr == vm) && ((false == is_even) || (false == is_vm_trailing_zeros))) ||
+                                       (last_removed_digit >= 5U)) ? 1U : 0U);
+    }
+    else
+    {
+        while ((vp / 10U) > (vm / 10U))
+        {
+            last_removed_digit = vr % 10U;
+            vr /= 10U;
+            vp /= 10U;
+            vm /= 10U;
+            removed++;
+        }
+        p_ptr_decimal->digits = vr + (((vr == vm) || (last_removed_digit >= 5U)) ? 1U : 0U);
+    }
+    p_ptr_decimal->exponent = e10 + removed;
+}
+
+/**
+ * @brief Writes the digits in fixed notation, e.g. 1250, 12.5 or 0.0125.
+ */
+static uint32_t write_shortest_fixed(char * p_ptr_str, const shortest_decimal_t * p_ptr_decimal, uint32_t p_digit_count)
+{
+    uint32_t len = 0U;
+    uint32_t frac_len = 0U;
+    uint32_t int_len = 0U;
+
+    if (p_ptr_decimal->exponent >= 0)
+    {
+        write_digits_u32(&p_ptr_str[p_digit_count], p_ptr_decimal->digits, p_digit_count);
+        len = p_digit_count + (uint32_t)p_ptr_decimal->exponent;
+        memset(&p_ptr_str[p_digit_count], '0', (uint32_t)p_ptr_decimal->exponent);
+    }
+    else if ((uint32_t)-p_ptr_decimal->exponent < p_digit_count)
+    {
+        frac_len = (uint32_t)-p_ptr_decimal->exponent;
+        int_len = p_digit_count - frac_len;
+        write_digits_u32(&p_ptr_str[int_len], p_ptr_decimal->digits / s_pow10_u32[frac_len], int_len);
+        p_ptr_str[int_len] = '.';
+        len = p_digit_count + 1U;
+        write_digits_u32(&p_ptr_str[len], p_ptr_decimal->digits % s_pow10_u32[frac_len], frac_len);
+    }
+    else
+    {
+        len = 2U + (uint32_t)-p_ptr_decimal->exponent;
+        memcpy(p_ptr_str, "0.", 2U);
+        memset(&p_ptr_str[2], '0', len - 2U - p_digit_count);
+        write_digits_u32(&p_ptr_str[len], p_ptr_decimal->digits, p_digit_count);
+    }
+    return len;
+}
+
+/**
+ * @brief Writes the digits as d.ddde+XX, the point is left out for a single digit.
+ */
+static uint32_t write_shortest_scientific(char * p_ptr_str, const shortest_decimal_t * p_ptr_decimal, uint32_t p_digit_count)
+{
+    int32_t exponent = p_ptr_decimal->exponent + (int32_t)p_digit_count - 1;
+    uint32_t len = 1U;
+
+    write_digits_u32(&p_ptr_str[1], p_ptr_decimal->digits / s_pow10_u32[p_digit_count - 1U], 1U);
+    if (p_digit_count > 1U)
+    {
+        p_ptr_str[len++] = '.';
+        len += p_digit_count - 1U;
+        write_digits_u32(&p_ptr_str[len], p_ptr_decimal->digits % s_pow10_u32[p_digit_count - 1U], p_digit_count - 1U);
+    }
+    p_ptr_str[len++] = 'e';
+    p_ptr_str[len++] = (exponent < 0) ? '-' : '+';
+    len += 2U;
+    write_digits_u32(&p_ptr_str[len], (uint32_t)((exponent < 0) ? -exponent : exponent), 2U);
+    return len;
+}
+
+/**
+ * @brief Value of a decimal digit, 10 or more for any other character.
+ */
+static inline uint32_t parse_decimal_digit(char p_char)
+{
+    return (uint32_t)(uint8_t)p_char - (uint32_t)'0';
+}
+
+/**
+ * @brief Value of a hexadecimal digit of either case, 16 for any other character.
+ */
+static inline uint32_t parse_hex_digit(char p_char)
+{
+    uint32_t digit = parse_decimal_digit(p_char);
+    uint32_t letter = ((uint32_t)(uint8_t)p_char | 0x20U) - (uint32_t)'a';
+
+    return (digit <= 9U) ? digit : ((letter <= 5U) ? (letter + 10U) : 16U);
+}
+
+/**
+ * @brief Skips an optional '+' or '-', returns the number of characters skipped.
+ */
+static uint32_t parse_sign(const char * p_ptr_str, uint32_t p_str_len, bool * p_ptr_is_negative)
+{
+    *p_ptr_is_negative = ((p_str_len > 0U) && (p_ptr_str[0] == '-'));
+    return ((true == *p_ptr_is_negative) || ((p_str_len > 0U) && (p_ptr_str[0] == '+'))) ? 1U : 0U;
+}
+
+/**
+ * @brief Parses unsigned decimal digits. Bad characters and overflows are collected in flags and
+ *        checked once at the end, so the loop has no early exit. The first digits cannot overflow
+ *        and skip the overflow checks.
+ */
+template <typename T>
+static string_parse_status_t parse_digits(const char * p_ptr_str, uint32_t p_str_len, T * p_ptr_value)
+{
+    const uint32_t safe_len = (sizeof(T) == sizeof(uint32_t)) ? 9U : 19U;
+    T value = 0U;
+    uint32_t digit = 0U;
+    bool is_invalid = false;
+    bool is_overflow = false;
+    string_parse_status_t status = STRING_PARSE_OK;
+
+    for (uint32_t i = 0U; i < p_str_len; i++)
+    {
+        digit = parse_decimal_digit(p_ptr_str[i]);
+        is_invalid |= (digit > 9U);
+        if (i < safe_len)
+        {
+            value = (T)((value * 10U) + digit);
+        }
+        else
+        {
+            is_overflow |= __builtin_mul_overflow(value, (T)10U, &value);
+            is_overflow |= __builtin_add_overflow(value, (T)digit, &value);
+        }
+    }
+
+    if (p_str_len == 0U)
+    {
+        status = STRING_PARSE_EMPTY;
+    }
+    else if (true == is_invalid)
+    {
+        status = STRING_PARSE_INVALID;
+    }
+    else if (true == is_overflow)
+    {
+        status = STRING_PARSE_OVERFLOW;
+    }
+    else
+    {
+        *p_ptr_value = value;
+    }
+    return status;
+}
+
+/**
+ * @brief Parses an optionally signed decimal integer into its magnitude and sign.
+ */
+template <typename T>
+static string_parse_status_t parse_signed(const char * p_ptr_str, uint32_t p_str_len, T * p_ptr_magnitude, bool * p_ptr_is_negative)
+{
+    uint32_t sign_len = 0U;
+    string_parse_status_t status = STRING_PARSE_INVALID;
+
+    if (p_ptr_str != NULL)
+    {
+        sign_len = parse_sign(p_ptr_str, p_str_len, p_ptr_is_negative);
+        status = parse_digits(&p_ptr_str[sign_len], p_str_len - sign_len, p_ptr_magnitude);
+    }
+    return status;
+}
+
+/**
+ * @brief Loads and stores 32-bit words in little endian order at any alignment, whatever the target.
+ */
+static inline uint32_t load_u32_le(const uint8_t * p_ptr_src)
+{
+    return (uint32_t)p_ptr_src[0] | ((uint32_t)p_ptr_src[1] << 8) |
+           ((uint32_t)p_ptr_src[2] << 16) | ((uint32_t)p_ptr_src[3] << 24);
+}
+
+static inline void store_u32_le(uint8_t * p_ptr_dst, uint32_t p_word)
+{
+    p_ptr_dst[0] = (uint8_t)p_word;
+    p_ptr_dst[1] = (uint8_t)(p_word >> 8);
+    p_ptr_dst[2] = (uint8_t)(p_word >> 16);
+    p_ptr_dst[3] = (uint8_t)(p_word >> 24);
+}
+
+/**
+ * @brief Turns 2 bytes, in the low half of the word, into their 4 hexadecimal characters.
+ *        The nibbles are spread one per lane in text order, then '0' is added to every lane and
+ *        'a' - '0' - 10 more to the lanes above 9: adding 0x76 sets bit 7 of exactly those lanes.
+ */
+static inline uint32_t swar_bytes_to_hex(uint32_t p_bytes)
+{
+    uint32_t spread = (p_bytes & 0xFFU) | ((p_bytes & 0xFF00U) << 8);
+    uint32_t nibbles = ((spread >> 4) & 0x000F000FU) | ((spread & 0x000F000FU) << 8);
+    uint32_t letters = ((nibbles + SWAR_LANES(0x76U)) & SWAR_LANES(0x80U)) >> 7;
+
+    return nibbles + SWAR_LANES('0') + (letters * (uint32_t)('a' - '0' - 10));
+}
+
+/**
+ * @brief Turns 4 hexadecimal characters into 2 bytes, returns false if one is not a hexadecimal digit.
+ *        A range check adds a bias that sets bit 7 of the lanes at or above its bound. The lanes
+ *        are below 0x80 for valid text, so nothing carries into the next lane. Letters have bit 6
+ *        set and their low nibble is 1 to 6, so their value is the low nibble + 9.
+ */
+static inline bool swar_hex_to_bytes(uint32_t p_chars, uint8_t * p_ptr_bytes)
+{
+    uint32_t lower = p_chars | SWAR_LANES(0x20U);
+    uint32_t is_digit = (p_chars + SWAR_LANES(0x80U - '0')) & ~(p_chars + SWAR_LANES(0x7FU - '9'));
+    uint32_t is_letter = (lower + SWAR_LANES(0x80U - 'a')) & ~(lower + SWAR_LANES(0x7FU - 'f'));
+    uint32_t nibbles = (p_chars & SWAR_LANES(0x0FU)) + (((p_chars >> 6) & SWAR_LANES(0x01U)) * 9U);
+    uint32_t pairs = (nibbles << 4) | (nibbles >> 8);
+
+    p_ptr_bytes[0] = (uint8_t)pairs;
+    p_ptr_bytes[1] = (uint8_t)(pairs >> 16);
+    return ((p_chars & SWAR_LANES(0x80U)) == 0U) &&
+           (((is_digit | is_letter) & SWAR_LANES(0x80U)) == SWAR_LANES(0x80U));
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief Same as swar_bytes_to_hex() for 8 bytes, the nibbles are interleaved in text order.
+ */
+static inline __m128i sse2_nibbles_to_hex(__m128i p_nibbles)
+{
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(p_nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+
+    return _mm_add_epi8(_mm_add_epi8(p_nibbles, _mm_set1_epi8('0')), letters);
+}
+
+/**
+ * @brief Same as swar_hex_to_bytes() for 16 characters, bad characters are or-ed into p_ptr_invalid.
+ *        The compares are signed, characters of 0x80 and above fail both ranges.
+ */
+static inline __m128i sse2_hex_to_bytes(__m128i p_chars, __m128i * p_ptr_invalid)
+{
+    __m128i lower = _mm_or_si128(p_chars, _mm_set1_epi8(0x20));
+    __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(p_chars, _mm_set1_epi8('0' - 1)),
+                                     _mm_cmplt_epi8(p_chars, _mm_set1_epi8('9' + 1)));
+    __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    __m128i nibbles = _mm_add_epi8(_mm_and_si128(p_chars, _mm_set1_epi8(0x0F)),
+                                   _mm_and_si128(is_letter, _mm_set1_epi8(9)));
+
+    *p_ptr_invalid = _mm_or_si128(*p_ptr_invalid,
+                                  _mm_andnot_si128(_mm_or_si128(is_digit, is_letter), _mm_set1_epi8(-1)));
+    /* 16-bit lanes hold the high nibble in their low byte, the results are packed to bytes by the caller */
+    return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+                        _mm_srli_epi16(nibbles, 8));
+}
+#endif /* __SSE2__ */
+
+/**
+ * @brief Gets where a number is formatted: in place when its longest text and the terminator of
+ *        the formatter fit, in the scratch buffer otherwise.
+ */
+static char * builder_number_dest(string_builder_t * p_ptr_sb, char * p_ptr_scratch, uint32_t p_max_len)
+{
+    return ((p_ptr_sb->size - p_ptr_sb->length) >= p_max_len) ? &p_ptr_sb->buf[p_ptr_sb->length] : p_ptr_scratch;
+}
+
+static void builder_number_commit(string_builder_t * p_ptr_sb, const char * p_ptr_dest, uint32_t p_len)
+{
+    if (p_ptr_dest == &p_ptr_sb->buf[p_ptr_sb->length])
+    {
+        p_ptr_sb->length += p_len;
+    }
+    else
+    {
+        string_builder_append(p_ptr_sb, p_ptr_dest, p_len);
+    }
+}
+
 /***************************************************************************************************
 * External data definitions.
 ***************************************************************************************************/
@@ -61,47 +762,32 @@ void string_reverse(char * p_ptr_str, uint32_t p_str_len)
 uint32_t string_itoa(int32_t p_num, char * p_ptr_str, uint32_t p_digit, base_t p_base)
 {
     uint32_t i = 0;
-    bool is_negative = false;
+    uint32_t magnitude = 0U;
+    uint32_t digits = 0U;
 
     if (p_ptr_str != NULL)
     {
-        if (p_num == 0)
+        /* The magnitude is taken as unsigned, so INT32_MIN does not overflow */
+        magnitude = (p_num < 0) ? (0U - (uint32_t)p_num) : (uint32_t)p_num;
+        digits = (p_base == BASE_16) ? count_nibbles_u32(magnitude) : count_digits_u32(magnitude);
+        if (p_num < 0)
+        {
+            p_ptr_str[i++] = '-';
+        }
+        for (; digits < p_digit; p_digit--)
         {
             p_ptr_str[i++] = '0';
-            p_ptr_str[i] = '\0';
+        }
+        i += digits;
+        if (p_base == BASE_16)
+        {
+            write_nibbles_u32(&p_ptr_str[i], magnitude, digits);
         }
         else
         {
-            if (p_num < 0 && p_base == BASE_10)
-            {
-                is_negative = true;
-                p_num = -p_num;
-            }
-            uint32_t num_pos = (uint32_t)p_num;
-            while (num_pos != 0)
-            {
-                uint32_t rem = num_pos % p_base;
-                p_ptr_str[i] = (rem > 9) ? (rem - 10) + 'a' : rem + '0';
-                i++;
-                num_pos = num_pos / p_base;
-            }
-
-            while (i < p_digit)
-            {
-                p_ptr_str[i] = '0';
-                i++;
-            }
-
-            if (is_negative)
-            {
-                p_ptr_str[i] = '-';
-                i++;
-            }
-
-            string_reverse(p_ptr_str, i);
-
-            p_ptr_str[i] = '\0';
+            write_digits_u32(&p_ptr_str[i], magnitude, digits);
         }
+        p_ptr_str[i] = '\0';
     }
     else
     {
@@ -111,28 +797,159 @@ uint32_t string_itoa(int32_t p_num, char * p_ptr_str, uint32_t p_digit, base_t p
     return i;
 }
 
-uint32_t string_ftoa(float p_fnum, char * p_ptr_str, uint32_t p_after_point)
+uint32_t string_u32toa(uint32_t p_num, char * p_ptr_str)
 {
-    int32_t i_part = 0;
-    uint32_t i = 0;
-    float f_part = 0.0f;
-    
-    if(p_ptr_str != NULL)
+    uint32_t len = 0U;
+
+    if (p_ptr_str != NULL)
+    {
+        len = count_digits_u32(p_num);
+        write_digits_u32(&p_ptr_str[len], p_num, len);
+        p_ptr_str[len] = '\0';
+    }
+    return len;
+}
+
+uint32_t string_i32toa(int32_t p_num, char * p_ptr_str)
+{
+    uint32_t len = 0U;
+
+    if (p_ptr_str != NULL)
     {
-        i_part = (int32_t)p_fnum;
-        i = string_itoa(i_part, p_ptr_str, 0, 10);
-        p_ptr_str[i++] = '.';
-        f_part = p_fnum - (float)i_part;
-        if (f_part < 0)
+        if (p_num < 0)
         {
-            f_part = -f_part;
+            p_ptr_str[len++] = '-';
         }
-        for (uint32_t j = 0; j < p_after_point; j++)
+        len += string_u32toa((p_num < 0) ? (0U - (uint32_t)p_num) : (uint32_t)p_num, &p_ptr_str[len]);
+    }
+    return len;
+}
+
+uint32_t string_u64toa(uint64_t p_num, char * p_ptr_str)
+{
+    uint32_t len = 0U;
+    uint32_t chunks[2];
+    uint32_t chunk_count = 0U;
+    uint64_t quotient = 0U;
+
+    if (p_ptr_str != NULL)
+    {
+        /* Only up to two 64-bit divisions, the 9 digit chunks are written with 32-bit arithmetic */
+        while (p_num > UINT32_MAX)
+        {
+            quotient = p_num / DECIMAL_CHUNK_VAL;
+            chunks[chunk_count++] = (uint32_t)(p_num - (quotient * DECIMAL_CHUNK_VAL));
+            p_num = quotient;
+        }
+        len = count_digits_u32((uint32_t)p_num);
+        write_digits_u32(&p_ptr_str[len], (uint32_t)p_num, len);
+        while (chunk_count > 0U)
+        {
+            len += DECIMAL_CHUNK_DIGITS;
+            write_digits_u32(&p_ptr_str[len], chunks[--chunk_count], DECIMAL_CHUNK_DIGITS);
+        }
+        p_ptr_str[len] = '\0';
+    }
+    return len;
+}
+
+uint32_t string_i64toa(int64_t p_num, char * p_ptr_str)
+{
+    uint32_t len = 0U;
+
+    if (p_ptr_str != NULL)
+    {
+        if (p_num < 0)
+        {
+            p_ptr_str[len++] = '-';
+        }
+        len += string_u64toa((p_num < 0) ? (0U - (uint64_t)p_num) : (uint64_t)p_num, &p_ptr_str[len]);
+    }
+    return len;
+}
+
+uint32_t string_hex32toa(uint32_t p_num, char * p_ptr_str)
+{
+    uint32_t len = 0U;
+
+    if (p_ptr_str != NULL)
+    {
+        len = count_nibbles_u32(p_num);
+        write_nibbles_u32(&p_ptr_str[len], p_num, len);
+        p_ptr_str[len] = '\0';
+    }
+    return len;
+}
+
+uint32_t string_hex64toa(uint64_t p_num, char * p_ptr_str)
+{
+    uint32_t len = 0U;
+
+    if (p_ptr_str != NULL)
+    {
+        if (p_num > UINT32_MAX)
+        {
+            len = count_nibbles_u32((uint32_t)(p_num >> 32));
+            write_nibbles_u32(&p_ptr_str[len], (uint32_t)(p_num >> 32), len);
+            len += 8U;
+            write_nibbles_u32(&p_ptr_str[len], (uint32_t)p_num, 8U);
+            p_ptr_str[len] = '\0';
+        }
+        else
+        {
+            len = string_hex32toa((uint32_t)p_num, p_ptr_str);
+        }
+    }
+    return len;
+}
+
+uint32_t string_ftoa(float p_fnum, char * p_ptr_str, uint32_t p_after_point)
+{
+    /* Every float is exact as a double */
+    return string_dtoa((double)p_fnum, p_ptr_str, p_after_point);
+}
+
+uint32_t string_dtoa(double p_num, char * p_ptr_str, uint32_t p_after_point)
+{
+    uint32_t i = 0;
+    double magnitude = 0.0;
+    uint64_t int_part = 0U;
+    uint32_t frac_part = 0U;
+
+    if(p_ptr_str != NULL)
+    {
+        if (p_after_point > STRING_FTOA_MAX_DECIMALS)
+        {
+            p_after_point = STRING_FTOA_MAX_DECIMALS;
+        }
+
+        if (isnan(p_num))
         {
-            f_part *= 10;
-            i_part = (int32_t)f_part;
-            p_ptr_str[i++] = (char)(i_part + '0');
-            f_part -= (float)i_part;
+            memcpy(p_ptr_str, "nan", 3U);
+            i = 3U;
+        }
+        else
+        {
+            /* The sign is kept for values between -1 and 0 and for -0.0, like printf */
+            if (signbit(p_num))
+            {
+                p_ptr_str[i++] = '-';
+            }
+            magnitude = fabs(p_num);
+            if (isinf(magnitude))
+            {
+                memcpy(&p_ptr_str[i], "inf", 3U);
+                i += 3U;
+            }
+            else if (magnitude >= FTOA_FIXED_LIMIT)
+            {
+                i += write_scientific(&p_ptr_str[i], magnitude, p_after_point);
+            }
+            else
+            {
+                split_fixed(magnitude, p_after_point, &int_part, &frac_part);
+                i += write_fixed(&p_ptr_str[i], int_part, frac_part, p_after_point);
+            }
         }
         p_ptr_str[i] = '\0';
     }
@@ -141,4 +958,576 @@ uint32_t string_ftoa(float p_fnum, char * p_ptr_str, uint32_t p_after_point)
         /* Do nothing */
     }
     return i;
-}
\ No newline at end of file
+}
+
+uint32_t string_ftoa_shortest(float p_fnum, char * p_ptr_str)
+{
+    shortest_decimal_t decimal;
+    uint32_t bits = 0U;
+    uint32_t mantissa = 0U;
+    uint32_t biased_exp = 0U;
+    uint32_t digit_count = 0U;
+    uint32_t fixed_len = 0U;
+    uint32_t len = 0U;
+
+    if (p_ptr_str != NULL)
+    {
+        memcpy(&bits, &p_fnum, sizeof(bits));
+        mantissa = bits & ((1U << FLOAT_MANTISSA_BITS) - 1U);
+        biased_exp = (bits >> FLOAT_MANTISSA_BITS) & FLOAT_EXPONENT_MASK;
+        if ((biased_exp == FLOAT_EXPONENT_MASK) || ((0U == biased_exp) && (0U == mantissa)))
+        {
+            /* nan, inf and zeros, -0 keeps its sign */
+            len = string_dtoa((double)p_fnum, p_ptr_str, 0U);
+        }
+        else
+        {
+            if (0U != (bits >> 31))
+            {
+                p_ptr_str[len++] = '-';
+            }
+            float_to_shortest(mantissa, biased_exp, &decimal);
+            digit_count = count_digits_u32(decimal.digits);
+            if (decimal.exponent >= 0)
+            {
+                fixed_len = digit_count + (uint32_t)decimal.exponent;
+            }
+            else
+            {
+                fixed_len = ((uint32_t)-decimal.exponent < digit_count) ? (digit_count + 1U) :
+                                                                          (2U + (uint32_t)-decimal.exponent);
+            }
+            /* The fixed form unless the scientific one is shorter, e.g. 1e+10 or 1e-40 */
+            if (fixed_len <= (digit_count + ((digit_count > 1U) ? 1U : 0U) + SHORTEST_SCI_EXP_LEN))
+            {
+                len += write_shortest_fixed(&p_ptr_str[len], &decimal, digit_count);
+            }
+            else
+            {
+                len += write_shortest_scientific(&p_ptr_str[len], &decimal, digit_count);
+            }
+            p_ptr_str[len] = '\0';
+        }
+    }
+    return len;
+}
+
+string_parse_status_t string_parse_u32(const char * p_ptr_str, uint32_t p_str_len, uint32_t * p_ptr_value)
+{
+    uint32_t magnitude = 0U;
+    bool is_negative = false;
+    string_parse_status_t status = parse_signed(p_ptr_str, p_str_len, &magnitude, &is_negative);
+
+    if ((status == STRING_PARSE_OK) && (true == is_negative))
+    {
+        status = STRING_PARSE_INVALID;
+    }
+    else if ((status == STRING_PARSE_OK) && (p_ptr_value != NULL))
+    {
+        *p_ptr_value = magnitude;
+    }
+    return status;
+}
+
+string_parse_status_t string_parse_i32(const char * p_ptr_str, uint32_t p_str_len, int32_t * p_ptr_value)
+{
+    uint32_t magnitude = 0U;
+    bool is_negative = false;
+    string_parse_status_t status = parse_signed(p_ptr_str, p_str_len, &magnitude, &is_negative);
+
+    /* The negative range has one more value, INT32_MIN */
+    if ((status == STRING_PARSE_OK) && (magnitude > ((uint32_t)INT32_MAX + (is_negative ? 1U : 0U))))
+    {
+        status = STRING_PARSE_OVERFLOW;
+    }
+    else if ((status == STRING_PARSE_OK) && (p_ptr_value != NULL))
+    {
+        *p_ptr_value = (int32_t)(is_negative ? (0U - magnitude) : magnitude);
+    }
+    return status;
+}
+
+string_parse_status_t string_parse_u64(const char * p_ptr_str, uint32_t p_str_len, uint64_t * p_ptr_value)
+{
+    uint64_t magnitude = 0U;
+    bool is_negative = false;
+    string_parse_status_t status = parse_signed(p_ptr_str, p_str_len, &magnitude, &is_negative);
+
+    if ((status == STRING_PARSE_OK) && (true == is_negative))
+    {
+        status = STRING_PARSE_INVALID;
+    }
+    else if ((status == STRING_PARSE_OK) && (p_ptr_value != NULL))
+    {
+        *p_ptr_value = magnitude;
+    }
+    return status;
+}
+
+string_parse_status_t string_parse_i64(const char * p_ptr_str, uint32_t p_str_len, int64_t * p_ptr_value)
+{
+    uint64_t magnitude = 0U;
+    bool is_negative = false;
+    string_parse_status_t status = parse_signed(p_ptr_str, p_str_len, &magnitude, &is_negative);
+
+    if ((status == STRING_PARSE_OK) && (magnitude > ((uint64_t)INT64_MAX + (is_negative ? 1U : 0U))))
+    {
+        status = STRING_PARSE_OVERFLOW;
+    }
+    else if ((status == STRING_PARSE_OK) && (p_ptr_value != NULL))
+    {
+        *p_ptr_value = (int64_t)(is_negative ? (0U - magnitude) : magnitude);
+    }
+    return status;
+}
+
+string_parse_status_t string_parse_hex32(const char * p_ptr_str, uint32_t p_str_len, uint32_t * p_ptr_value)
+{
+    uint32_t value = 0U;
+    uint32_t digit = 0U;
+    uint32_t i = 0U;
+    bool is_invalid = false;
+    bool is_overflow = false;
+    string_parse_status_t status = STRING_PARSE_INVALID;
+
+    if (p_ptr_str != NULL)
+    {
+        if ((p_str_len >= 2U) && (p_ptr_str[0] == '0') && ((p_ptr_str[1] | 0x20) == 'x'))
+        {
+            i = 2U;
+        }
+        status = (i == p_str_len) ? STRING_PARSE_EMPTY : STRING_PARSE_OK;
+        for (; i < p_str_len; i++)
+        {
+            digit = parse_hex_digit(p_ptr_str[i]);
+            is_invalid |= (digit > 15U);
+            /* A set top nibble would be shifted out */
+            is_overflow |= ((value >> 28) != 0U);
+            value = (value << 4) | (digit & 0xFU);
+        }
+
+        if (status == STRING_PARSE_EMPTY)
+        {
+            /* Do nothing */
+        }
+        else if (true == is_invalid)
+        {
+            status = STRING_PARSE_INVALID;
+        }
+        else if (true == is_overflow)
+        {
+            status = STRING_PARSE_OVERFLOW;
+        }
+        else if (p_ptr_value != NULL)
+        {
+            *p_ptr_value = value;
+        }
+    }
+    return status;
+}
+
+string_parse_status_t string_parse_float(const char * p_ptr_str, uint32_t p_str_len, float * p_ptr_value)
+{
+    uint64_t mantissa = 0U;
+    uint32_t mantissa_digits = 0U;
+    uint32_t digit_count = 0U;
+    uint32_t digit = 0U;
+    uint32_t i = 0U;
+    int32_t exp10 = 0;
+    int32_t exp_value = 0;
+    bool is_negative = false;
+    bool is_exp_negative = false;
+    double value = 0.0;
+    float result = 0.0f;
+    string_parse_status_t status = STRING_PARSE_INVALID;
+
+    if (p_ptr_str != NULL)
+    {
+        i = parse_sign(p_ptr_str, p_str_len, &is_negative);
+
+        /* Integer digits, the ones past the kept significant digits only scale the value */
+        for (; (i < p_str_len) && ((digit = parse_decimal_digit(p_ptr_str[i])) <= 9U); i++, digit_count++)
+        {
+            if (mantissa_digits < PARSE_FLOAT_MAX_DIGITS)
+            {
+                mantissa = (mantissa * 10U) + digit;
+                mantissa_digits += (mantissa != 0U) ? 1U : 0U;
+            }
+            else
+            {
+                exp10++;
+            }
+        }
+        /* Fraction digits, the dropped ones do not change the value */
+        if ((i < p_str_len) && (p_ptr_str[i] == '.'))
+        {
+            for (i++; (i < p_str_len) && ((digit = parse_decimal_digit(p_ptr_str[i])) <= 9U); i++, digit_count++)
+            {
+                if (mantissa_digits < PARSE_FLOAT_MAX_DIGITS)
+                {
+                    mantissa = (mantissa * 10U) + digit;
+                    mantissa_digits += (mantissa != 0U) ? 1U : 0U;
+                    exp10--;
+                }
+            }
+        }
+        if ((digit_count > 0U) && (i < p_str_len) && ((p_ptr_str[i] | 0x20) == 'e'))
+        {
+            i++;
+            i += parse_sign(&p_ptr_str[i], p_str_len - i, &is_exp_negative);
+            /* At least one exponent digit, the loop leaves i there otherwise and the check below fails */
+            if ((i < p_str_len) && (parse_decimal_digit(p_ptr_str[i]) <= 9U))
+            {
+                for (; (i < p_str_len) && ((digit = parse_decimal_digit(p_ptr_str[i])) <= 9U); i++)
+                {
+                    exp_value = (exp_value < PARSE_EXP_DIGITS_LIMIT) ? ((exp_value * 10) + (int32_t)digit) : exp_value;
+                }
+                exp10 += is_exp_negative ? -exp_value : exp_value;
+            }
+            else
+            {
+                i = p_str_len + 1U;
+            }
+        }
+
+        if (digit_count == 0U)
+        {
+            status = (i == p_str_len) ? STRING_PARSE_EMPTY : STRING_PARSE_INVALID;
+        }
+        else if (i != p_str_len)
+        {
+            status = STRING_PARSE_INVALID;
+        }
+        else if ((mantissa != 0U) && (exp10 > PARSE_FLOAT_MAX_EXP10))
+        {
+            status = STRING_PARSE_OVERFLOW;
+        }
+        else
+        {
+            /* Exact below 2^53 and with exponents up to 22, rounded once by the multiply or divide */
+            value = (double)mantissa;
+            if ((mantissa == 0U) || (exp10 < PARSE_FLOAT_MIN_EXP10))
+            {
+                value = 0.0;
+            }
+            else if (exp10 >= 0)
+            {
+                for (; exp10 > PARSE_POW10_MAX_EXACT; exp10 -= PARSE_POW10_MAX_EXACT)
+                {
+                    value *= s_pow10_f64[PARSE_POW10_MAX_EXACT];
+                }
+                value *= s_pow10_f64[exp10];
+            }
+            else
+            {
+                for (; exp10 < -PARSE_POW10_MAX_EXACT; exp10 += PARSE_POW10_MAX_EXACT)
+                {
+                    value /= s_pow10_f64[PARSE_POW10_MAX_EXACT];
+                }
+                value /= s_pow10_f64[-exp10];
+            }
+
+            result = (float)value;
+            if (isinf(result))
+            {
+                status = STRING_PARSE_OVERFLOW;
+            }
+            else
+            {
+                status = STRING_PARSE_OK;
+                if (p_ptr_value != NULL)
+                {
+                    *p_ptr_value = is_negative ? -result : result;
+                }
+            }
+        }
+    }
+    return status;
+}
+
+uint32_t string_hex_encode(const uint8_t * p_ptr_bytes, uint32_t p_byte_count, char * p_ptr_str)
+{
+    uint32_t i = 0U;
+    uint32_t word = 0U;
+    uint8_t * dst_ptr = (uint8_t *)p_ptr_str;
+
+    if ((p_ptr_bytes != NULL) && (p_ptr_str != NULL))
+    {
+#if defined(__SSE2__)
+        for (; (i + 16U) <= p_byte_count; i += 16U)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)&p_ptr_bytes[i]);
+            __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+            __m128i low = _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
+
+            _mm_storeu_si128((__m128i *)&dst_ptr[2U * i], sse2_nibbles_to_hex(_mm_unpacklo_epi8(high, low)));
+            _mm_storeu_si128((__m128i *)&dst_ptr[(2U * i) + 16U], sse2_nibbles_to_hex(_mm_unpackhi_epi8(high, low)));
+        }
+#endif /* __SSE2__ */
+        for (; (i + 4U) <= p_byte_count; i += 4U)
+        {
+            word = load_u32_le(&p_ptr_bytes[i]);
+            store_u32_le(&dst_ptr[2U * i], swar_bytes_to_hex(word & 0xFFFFU));
+            store_u32_le(&dst_ptr[(2U * i) + 4U], swar_bytes_to_hex(word >> 16));
+        }
+        for (; i < p_byte_count; i++)
+        {
+            p_ptr_str[2U * i] = s_hex_digits[p_ptr_bytes[i] >> 4];
+            p_ptr_str[(2U * i) + 1U] = s_hex_digits[p_ptr_bytes[i] & 0xFU];
+        }
+        p_ptr_str[2U * i] = '\0';
+    }
+    return 2U * i;
+}
+
+string_parse_status_t string_hex_decode(const char * p_ptr_str, uint32_t p_str_len, uint8_t * p_ptr_bytes)
+{
+    const uint8_t * src_ptr = (const uint8_t *)p_ptr_str;
+    uint32_t i = 0U;
+    bool is_valid = true;
+    uint32_t high = 0U;
+    uint32_t low = 0U;
+    string_parse_status_t status = STRING_PARSE_INVALID;
+
+    if ((p_ptr_str != NULL) && (p_ptr_bytes != NULL) && ((p_str_len % 2U) == 0U))
+    {
+#if defined(__SSE2__)
+        __m128i invalid = _mm_setzero_si128();
+
+        for (; (i + 32U) <= p_str_len; i += 32U)
+        {
+            __m128i first = sse2_hex_to_bytes(_mm_loadu_si128((const __m128i *)&src_ptr[i]), &invalid);
+            __m128i second = sse2_hex_to_bytes(_mm_loadu_si128((const __m128i *)&src_ptr[i + 16U]), &invalid);
+
+            _mm_storeu_si128((__m128i *)&p_ptr_bytes[i / 2U], _mm_packus_epi16(first, second));
+        }
+        is_valid = (_mm_movemask_epi8(invalid) == 0);
+#endif /* __SSE2__ */
+        /* The result of each step is and-ed in, the loop does not branch on the characters */
+        for (; (i + 4U) <= p_str_len; i += 4U)
+        {
+            is_valid &= swar_hex_to_bytes(load_u32_le(&src_ptr[i]), &p_ptr_bytes[i / 2U]);
+        }
+        if (i < p_str_len)
+        {
+            high = parse_hex_digit(p_ptr_str[i]);
+            low = parse_hex_digit(p_ptr_str[i + 1U]);
+            is_valid &= ((high | low) <= 15U);
+            p_ptr_bytes[i / 2U] = (uint8_t)((high << 4) | (low & 0xFU));
+        }
+        status = (p_str_len == 0U) ? STRING_PARSE_EMPTY : ((true == is_valid) ? STRING_PARSE_OK : STRING_PARSE_INVALID);
+    }
+    return status;
+}
+
+uint32_t string_base64_encode(const uint8_t * p_ptr_bytes, uint32_t p_byte_count, char * p_ptr_str)
+{
+    uint32_t i = 0U;
+    uint32_t len = 0U;
+    uint32_t word = 0U;
+
+    if ((p_ptr_bytes != NULL) && (p_ptr_str != NULL))
+    {
+        for (; (i + 3U) <= p_byte_count; i += 3U)
+        {
+            word = ((uint32_t)p_ptr_bytes[i] << 16) | ((uint32_t)p_ptr_bytes[i + 1U] << 8) | p_ptr_bytes[i + 2U];
+            p_ptr_str[len] = s_base64_chars[word >> 18];
+            p_ptr_str[len + 1U] = s_base64_chars[(word >> 12) & 0x3FU];
+            p_ptr_str[len + 2U] = s_base64_chars[(word >> 6) & 0x3FU];
+            p_ptr_str[len + 3U] = s_base64_chars[word & 0x3FU];
+            len += 4U;
+        }
+        if (i < p_byte_count)
+        {
+            /* 1 or 2 bytes left, the missing ones are zero and their characters are padding */
+            word = ((uint32_t)p_ptr_bytes[i] << 16) | (((i + 1U) < p_byte_count) ? ((uint32_t)p_ptr_bytes[i + 1U] << 8) : 0U);
+            p_ptr_str[len] = s_base64_chars[word >> 18];
+            p_ptr_str[len + 1U] = s_base64_chars[(word >> 12) & 0x3FU];
+            p_ptr_str[len + 2U] = ((i + 1U) < p_byte_count) ? s_base64_chars[(word >> 6) & 0x3FU] : '=';
+            p_ptr_str[len + 3U] = '=';
+            len += 4U;
+        }
+        p_ptr_str[len] = '\0';
+    }
+    return len;
+}
+
+string_parse_status_t string_base64_decode(const char * p_ptr_str, uint32_t p_str_len, uint8_t * p_ptr_bytes, uint32_t * p_ptr_byte_count)
+{
+    const uint8_t * src_ptr = (const uint8_t *)p_ptr_str;
+    uint32_t i = 0U;
+    uint32_t len = 0U;
+    uint32_t pad_count = 0U;
+    uint32_t values[4];
+    uint32_t invalid = 0U;
+    uint32_t word = 0U;
+    string_parse_status_t status = STRING_PARSE_INVALID;
+
+    if ((p_ptr_str != NULL) && (p_ptr_bytes != NULL) && ((p_str_len % 4U) == 0U))
+    {
+        for (; i < p_str_len; i += 4U)
+        {
+            values[0] = s_base64_values[src_ptr[i]];
+            values[1] = s_base64_values[src_ptr[i + 1U]];
+            values[2] = s_base64_values[src_ptr[i + 2U]];
+            values[3] = s_base64_values[src_ptr[i + 3U]];
+            if ((i + 4U) == p_str_len)
+            {
+                /* Only the last group may end with "=" or "==", the padding reads as zero bits */
+                pad_count = (src_ptr[i + 3U] == '=') ? ((src_ptr[i + 2U] == '=') ? 2U : 1U) : 0U;
+                values[2] = (pad_count == 2U) ? 0U : values[2];
+                values[3] = (pad_count >= 1U) ? 0U : values[3];
+            }
+            /* Valid values are below 64, an invalid one sets bit 7 */
+            invalid |= values[0] | values[1] | values[2] | values[3];
+            word = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+            p_ptr_bytes[len] = (uint8_t)(word >> 16);
+            p_ptr_bytes[len + 1U] = (uint8_t)(word >> 8);
+            p_ptr_bytes[len + 2U] = (uint8_t)word;
+            len += 3U;
+        }
+
+        if (p_str_len == 0U)
+        {
+            status = STRING_PARSE_EMPTY;
+        }
+        else if ((invalid & 0x80U) == 0U)
+        {
+            status = STRING_PARSE_OK;
+            if (p_ptr_byte_count != NULL)
+            {
+                *p_ptr_byte_count = len - pad_count;
+            }
+        }
+    }
+    return status;
+}
+
+void string_builder_init(string_builder_t * p_ptr_sb, char * p_ptr_buf, uint32_t p_buf_size)
+{
+    p_ptr_sb->buf = p_ptr_buf;
+    p_ptr_sb->size = (p_ptr_buf != NULL) ? p_buf_size : 0U;
+    p_ptr_sb->length = 0U;
+    p_ptr_sb->is_truncated = false;
+}
+
+void string_builder_append(string_builder_t * p_ptr_sb, const char * p_ptr_str, uint32_t p_str_len)
+{
+    if (p_str_len > (p_ptr_sb->size - p_ptr_sb->length))
+    {
+        p_str_len = p_ptr_sb->size - p_ptr_sb->length;
+        p_ptr_sb->is_truncated = true;
+    }
+    if (p_str_len > 0U)
+    {
+        memcpy(&p_ptr_sb->buf[p_ptr_sb->length], p_ptr_str, p_str_len);
+        p_ptr_sb->length += p_str_len;
+    }
+}
+
+void string_builder_append_str(string_builder_t * p_ptr_sb, const char * p_ptr_str)
+{
+    if (p_ptr_str != NULL)
+    {
+        string_builder_append(p_ptr_sb, p_ptr_str, strlen(p_ptr_str));
+    }
+}
+
+void string_builder_append_char(string_builder_t * p_ptr_sb, char p_char)
+{
+    if (p_ptr_sb->length < p_ptr_sb->size)
+    {
+        p_ptr_sb->buf[p_ptr_sb->length++] = p_char;
+    }
+    else
+    {
+        p_ptr_sb->is_truncated = true;
+    }
+}
+
+void string_builder_append_u32(string_builder_t * p_ptr_sb, uint32_t p_num)
+{
+    char scratch[STRING_U32_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_u32toa(p_num, dest_ptr));
+}
+
+void string_builder_append_padded_u32(string_builder_t * p_ptr_sb, uint32_t p_num, uint32_t p_min_digits)
+{
+    for (uint32_t digits = count_digits_u32(p_num); p_min_digits > digits; p_min_digits--)
+    {
+        string_builder_append_char(p_ptr_sb, '0');
+    }
+    string_builder_append_u32(p_ptr_sb, p_num);
+}
+
+void string_builder_append_i32(string_builder_t * p_ptr_sb, int32_t p_num)
+{
+    char scratch[STRING_I32_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_i32toa(p_num, dest_ptr));
+}
+
+void string_builder_append_u64(string_builder_t * p_ptr_sb, uint64_t p_num)
+{
+    char scratch[STRING_U64_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_u64toa(p_num, dest_ptr));
+}
+
+void string_builder_append_i64(string_builder_t * p_ptr_sb, int64_t p_num)
+{
+    char scratch[STRING_I64_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_i64toa(p_num, dest_ptr));
+}
+
+void string_builder_append_hex32(string_builder_t * p_ptr_sb, uint32_t p_num)
+{
+    char scratch[STRING_HEX32_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_hex32toa(p_num, dest_ptr));
+}
+
+void string_builder_append_hex64(string_builder_t * p_ptr_sb, uint64_t p_num)
+{
+    char scratch[STRING_HEX64_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_hex64toa(p_num, dest_ptr));
+}
+
+void string_builder_append_float(string_builder_t * p_ptr_sb, float p_num, uint32_t p_after_point)
+{
+    string_builder_append_double(p_ptr_sb, (double)p_num, p_after_point);
+}
+
+void string_builder_append_double(string_builder_t * p_ptr_sb, double p_num, uint32_t p_after_point)
+{
+    char scratch[STRING_FTOA_MAX_LEN];
+    char * dest_ptr = builder_number_dest(p_ptr_sb, scratch, sizeof(scratch));
+
+    builder_number_commit(p_ptr_sb, dest_ptr, string_dtoa(p_num, dest_ptr, p_after_point));
+}
+
+const char * string_builder_c_str(string_builder_t * p_ptr_sb)
+{
+    const char * str_ptr = "";
+
+    if (p_ptr_sb->size > 0U)
+    {
+        if (p_ptr_sb->length == p_ptr_sb->size)
+        {
+            p_ptr_sb->length--;
+            p_ptr_sb->is_truncated = true;
+        }
+        p_ptr_sb->buf[p_ptr_sb->length] = '\0';
+        str_ptr = p_ptr_sb->buf;
+    }
+    return str_ptr;
+}
@@ -13,10 +13,33 @@
 * Header files.
 ***************************************************************************************************/
 
+#include <stdint.h>
+
 /***************************************************************************************************
 * Macro definitions.
 ***************************************************************************************************/
 
+/* Buffer sizes that hold any value of the integer formatters, terminator included */
+#define STRING_U32_MAX_LEN (11U)
+#define STRING_I32_MAX_LEN (12U)
+#define STRING_U64_MAX_LEN (21U)
+#define STRING_I64_MAX_LEN (21U)
+#define STRING_HEX32_MAX_LEN (9U)
+#define STRING_HEX64_MAX_LEN (17U)
+
+/* Decimals of the float formatters are capped to this, the buffer size holds any value */
+#define STRING_FTOA_MAX_DECIMALS (9U)
+#define STRING_FTOA_MAX_LEN (32U)
+
+/* Buffer sizes of the bulk encoders and decoders for p_len input bytes or characters, terminator included */
+#define STRING_HEX_ENCODED_LEN(p_len) ((2U * (p_len)) + 1U)
+#define STRING_BASE64_ENCODED_LEN(p_len) (((((p_len) + 2U) / 3U) * 4U) + 1U)
+#define STRING_BASE64_DECODED_MAX_LEN(p_len) (((p_len) / 4U) * 3U)
+
+/* Appends a string literal without scanning it for its terminator */
+#define STRING_BUILDER_APPEND_LITERAL(p_ptr_sb, p_literal) \
+    string_builder_append((p_ptr_sb), (p_literal), sizeof(p_literal) - 1U)
+
 /***************************************************************************************************
 * External type declarations.
 ***************************************************************************************************/
@@ -25,6 +48,61 @@ typedef enum base_t_enum
     BASE_10 = 10,
     BASE_16 = 16,
 } base_t;
+
+typedef enum string_parse_status_t_enum
+{
+    STRING_PARSE_OK = 0,        /* The whole text is a number of the type */
+    STRING_PARSE_EMPTY,         /* No text, or only a sign or a prefix */
+    STRING_PARSE_INVALID,       /* A character that does not belong to the number */
+    STRING_PARSE_OVERFLOW,      /* A number out of the range of the type */
+} string_parse_status_t;
+
+/* Text assembled in a caller supplied buffer. Appends that do not fit are cut at the end of the
+   buffer and flag the builder as truncated, nothing is allocated. The text is not NUL terminated
+   until string_builder_c_str() is called */
+typedef struct string_builder_t_struct
+{
+    char * buf;
+    uint32_t size;
+    uint32_t length;
+    bool is_truncated;
+} string_builder_t;
+/* Text of a known length made by the constexpr formatters (string_xxx_c) below. A constexpr object
+   of it is placed in flash, e.g. static constexpr string_const_t<4> s_label = string_u32toa_c<123>();
+   Its buf member is a NUL terminated char array, it can be passed to other constexpr formatters */
+template <uint32_t N>
+struct string_const_t
+{
+    char buf[N];
+
+    constexpr const char * c_str() const
+    {
+        return buf;
+    }
+
+    constexpr uint32_t length() const
+    {
+        return N - 1U;
+    }
+};
+
+/* Compile time list of indexes 0 to N - 1, the constexpr formatters expand one character per index */
+template <uint32_t... I>
+struct string_index_seq_t
+{
+};
+
+template <uint32_t N, uint32_t... I>
+struct string_make_index_seq_t : string_make_index_seq_t<N - 1U, N - 1U, I...>
+{
+};
+
+template <uint32_t... I>
+struct string_make_index_seq_t<0U, I...>
+{
+    typedef string_index_seq_t<I...> type;
+};
+
 /***************************************************************************************************
 * External data declarations.
 ***************************************************************************************************/
@@ -43,23 +121,306 @@ void string_reverse(char * p_ptr_str, uint32_t p_str_len);
 
 /**
  * @brief This function converts an integer number to a string.
+ *        Negative numbers get a '-' in both bases, the digits are zero padded after the sign.
  * 
  * @param p_num input: The number to be converted.
  * @param p_ptr_str output: The string that will hold the converted number.
- * @param p_digit input: The number of digits in the converted number.
+ * @param p_digit input: The minimum number of digits in the converted number.
  * @param p_base input: The base of the converted number, 10 or 16.
  * @return The length of the converted string.
  */
 uint32_t string_itoa(int32_t p_num, char * p_ptr_str, uint32_t p_digit, base_t p_base);
 
+/**
+ * @brief These functions convert an integer to decimal text. The digits are counted first and
+ *        written from the end two at a time, no reverse pass is needed.
+ * 
+ * @param p_num input: The number to be converted.
+ * @param p_ptr_str output: Buffer of at least STRING_xxx_MAX_LEN bytes, it is NUL terminated.
+ * @return The length of the converted string.
+ */
+uint32_t string_u32toa(uint32_t p_num, char * p_ptr_str);
+uint32_t string_i32toa(int32_t p_num, char * p_ptr_str);
+uint32_t string_u64toa(uint64_t p_num, char * p_ptr_str);
+uint32_t string_i64toa(int64_t p_num, char * p_ptr_str);
+
+/**
+ * @brief These functions convert the bits of an integer to lower case hexadecimal text,
+ *        without leading zeros.
+ * 
+ * @param p_num input: The number to be converted.
+ * @param p_ptr_str output: Buffer of at least STRING_HEXxx_MAX_LEN bytes, it is NUL terminated.
+ * @return The length of the converted string.
+ */
+uint32_t string_hex32toa(uint32_t p_num, char * p_ptr_str);
+uint32_t string_hex64toa(uint64_t p_num, char * p_ptr_str);
+
 /**
  * @brief This function converts a float number to a string.
  * 
  * @param p_fnum input: the float number to be converted.
- * @param p_ptr_str output: the string that will hold the converted number.
- * @param p_after_point input: the number of digits after the point.
+ * @param p_ptr_str output: the string that will hold the converted number, at least STRING_FTOA_MAX_LEN bytes.
+ * @param p_after_point input: the number of digits after the point, up to STRING_FTOA_MAX_DECIMALS.
  * @retval The length of the converted string.
  */
 uint32_t string_ftoa(float p_fnum, char * p_ptr_str, uint32_t p_after_point);
 
+/**
+ * @brief This function converts a double number to a string, rounded to nearest like printf("%.Nf").
+ *        The integer part and the scaled fraction are converted as 64-bit and 32-bit integers.
+ *        Magnitudes of 2^64 and above are written as d.ddde+XX, NaN and infinities as nan, inf and -inf.
+ * 
+ * @param p_num input: the number to be converted.
+ * @param p_ptr_str output: the string that will hold the converted number, at least STRING_FTOA_MAX_LEN bytes.
+ * @param p_after_point input: the number of digits after the point, up to STRING_FTOA_MAX_DECIMALS.
+ * @retval The length of the converted string.
+ */
+uint32_t string_dtoa(double p_num, char * p_ptr_str, uint32_t p_after_point);
+
+/**
+ * @brief This function converts a float number to the shortest string that reads back as the same float.
+ *        The digits are found with Ryu, among the shortest ones the closest to the float is taken.
+ *        They are written in fixed notation unless the d.ddde+XX form is shorter, e.g. 0.25, 1e-40 or 3.4e+38.
+ * 
+ * @param p_fnum input: the float number to be converted.
+ * @param p_ptr_str output: the string that will hold the converted number, at least STRING_FTOA_MAX_LEN bytes.
+ * @retval The length of the converted string.
+ */
+uint32_t string_ftoa_shortest(float p_fnum, char * p_ptr_str);
+
+/**
+ * @brief These functions parse the whole text as a decimal integer: an optional sign ('-' only
+ *        for the signed types) followed by digits. Nothing is allocated, the text does not need a
+ *        NUL terminator and a character that is not a digit fails the parse, spaces included.
+ * 
+ * @param p_ptr_str input: The text to be parsed.
+ * @param p_str_len input: The length of the text.
+ * @param p_ptr_value output: The parsed number, only written when STRING_PARSE_OK is returned.
+ * @retval STRING_PARSE_OK if the text is a number in the range of the type.
+ * @retval STRING_PARSE_EMPTY, STRING_PARSE_INVALID or STRING_PARSE_OVERFLOW otherwise.
+ */
+string_parse_status_t string_parse_u32(const char * p_ptr_str, uint32_t p_str_len, uint32_t * p_ptr_value);
+string_parse_status_t string_parse_i32(const char * p_ptr_str, uint32_t p_str_len, int32_t * p_ptr_value);
+string_parse_status_t string_parse_u64(const char * p_ptr_str, uint32_t p_str_len, uint64_t * p_ptr_value);
+string_parse_status_t string_parse_i64(const char * p_ptr_str, uint32_t p_str_len, int64_t * p_ptr_value);
+
+/**
+ * @brief This function parses the whole text as up to 8 hexadecimal digits of either case,
+ *        with an optional 0x or 0X prefix.
+ * 
+ * @param p_ptr_str input: The text to be parsed.
+ * @param p_str_len input: The length of the text.
+ * @param p_ptr_value output: The parsed number, only written when STRING_PARSE_OK is returned.
+ * @retval The status of the parse, see string_parse_u32().
+ */
+string_parse_status_t string_parse_hex32(const char * p_ptr_str, uint32_t p_str_len, uint32_t * p_ptr_value);
+
+/**
+ * @brief This function parses the whole text as a float: an optional sign, digits with an optional
+ *        decimal point and an optional exponent, e.g. "-12.5" or "1e-3". Up to 19 significant digits
+ *        are kept and scaled once by a power of 10 in double, so the result may differ from strtof()
+ *        in the last bit for long inputs. nan and inf are not accepted.
+ * 
+ * @param p_ptr_str input: The text to be parsed.
+ * @param p_str_len input: The length of the text.
+ * @param p_ptr_value output: The parsed number, only written when STRING_PARSE_OK is returned.
+ * @retval STRING_PARSE_OVERFLOW if the magnitude is too large for a float, values too small
+ *         for a float become 0. See string_parse_u32() for the other values.
+ */
+string_parse_status_t string_parse_float(const char * p_ptr_str, uint32_t p_str_len, float * p_ptr_value);
+
+/**
+ * @brief This function encodes bytes as lower case hexadecimal text, two characters per byte.
+ *        4 bytes are spread into nibbles and turned to characters per 32-bit step, 16 bytes per
+ *        step with SSE2 on the host.
+ * 
+ * @param p_ptr_bytes input: The bytes to be encoded.
+ * @param p_byte_count input: The number of bytes.
+ * @param p_ptr_str output: Buffer of at least STRING_HEX_ENCODED_LEN(p_byte_count) bytes, it is NUL terminated.
+ * @retval The length of the text.
+ */
+uint32_t string_hex_encode(const uint8_t * p_ptr_bytes, uint32_t p_byte_count, char * p_ptr_str);
+
+/**
+ * @brief This function decodes hexadecimal text of either case, two characters per byte.
+ *        4 characters are checked and converted per 32-bit step, 32 per step with SSE2 on the host.
+ * 
+ * @param p_ptr_str input: The text to be decoded, without a 0x prefix or separators.
+ * @param p_str_len input: The length of the text, an even number.
+ * @param p_ptr_bytes output: Buffer of at least p_str_len / 2 bytes. Its content is undefined on failure.
+ * @retval STRING_PARSE_OK if the whole text was decoded.
+ * @retval STRING_PARSE_EMPTY, or STRING_PARSE_INVALID for an odd length or a bad character.
+ */
+string_parse_status_t string_hex_decode(const char * p_ptr_str, uint32_t p_str_len, uint8_t * p_ptr_bytes);
+
+/**
+ * @brief This function encodes bytes as padded base64 text (RFC 4648), 3 bytes per 24-bit word.
+ * 
+ * @param p_ptr_bytes input: The bytes to be encoded.
+ * @param p_byte_count input: The number of bytes.
+ * @param p_ptr_str output: Buffer of at least STRING_BASE64_ENCODED_LEN(p_byte_count) bytes, it is NUL terminated.
+ * @retval The length of the text.
+ */
+uint32_t string_base64_encode(const uint8_t * p_ptr_bytes, uint32_t p_byte_count, char * p_ptr_str);
+
+/**
+ * @brief This function decodes padded base64 text (RFC 4648). Each group of 4 characters is looked
+ *        up and checked at once, without a branch per character.
+ * 
+ * @param p_ptr_str input: The text to be decoded, without line breaks.
+ * @param p_str_len input: The length of the text, a multiple of 4.
+ * @param p_ptr_bytes output: Buffer of at least STRING_BASE64_DECODED_MAX_LEN(p_str_len) bytes.
+ *                    Its content is undefined on failure.
+ * @param p_ptr_byte_count output: The number of decoded bytes, only written when STRING_PARSE_OK is returned.
+ * @retval STRING_PARSE_OK if the whole text was decoded.
+ * @retval STRING_PARSE_EMPTY, or STRING_PARSE_INVALID for a bad length, character or padding.
+ */
+string_parse_status_t string_base64_decode(const char * p_ptr_str, uint32_t p_str_len, uint8_t * p_ptr_bytes, uint32_t * p_ptr_byte_count);
+
+/**
+ * @brief This function starts an empty text in the buffer.
+ * 
+ * @param p_ptr_sb output: The builder.
+ * @param p_ptr_buf input: The buffer that holds the text.
+ * @param p_buf_size input: The size of the buffer.
+ */
+void string_builder_init(string_builder_t * p_ptr_sb, char * p_ptr_buf, uint32_t p_buf_size);
+
+/**
+ * @brief These functions append characters to the text, what does not fit is dropped.
+ * 
+ * @param p_ptr_sb input/output: The builder.
+ * @param p_ptr_str input: The characters, string_builder_append_str() takes a NUL terminated string.
+ * @param p_str_len input: The number of characters.
+ */
+void string_builder_append(string_builder_t * p_ptr_sb, const char * p_ptr_str, uint32_t p_str_len);
+void string_builder_append_str(string_builder_t * p_ptr_sb, const char * p_ptr_str);
+void string_builder_append_char(string_builder_t * p_ptr_sb, char p_char);
+
+/**
+ * @brief These functions append a number in the format of the matching string_xxxtoa() function.
+ *        A number that does not fit is cut like any other text.
+ * 
+ * @param p_ptr_sb input/output: The builder.
+ * @param p_num input: The number to be appended.
+ * @param p_min_digits input: The number of digits the number is zero padded to.
+ * @param p_after_point input: The number of digits after the point, up to STRING_FTOA_MAX_DECIMALS.
+ */
+void string_builder_append_u32(string_builder_t * p_ptr_sb, uint32_t p_num);
+void string_builder_append_padded_u32(string_builder_t * p_ptr_sb, uint32_t p_num, uint32_t p_min_digits);
+void string_builder_append_i32(string_builder_t * p_ptr_sb, int32_t p_num);
+void string_builder_append_u64(string_builder_t * p_ptr_sb, uint64_t p_num);
+void string_builder_append_i64(string_builder_t * p_ptr_sb, int64_t p_num);
+void string_builder_append_hex32(string_builder_t * p_ptr_sb, uint32_t p_num);
+void string_builder_append_hex64(string_builder_t * p_ptr_sb, uint64_t p_num);
+void string_builder_append_float(string_builder_t * p_ptr_sb, float p_num, uint32_t p_after_point);
+void string_builder_append_double(string_builder_t * p_ptr_sb, double p_num, uint32_t p_after_point);
+
+/**
+ * @brief This function NUL terminates the text. When the buffer is full, the last character
+ *        is replaced by the terminator and the builder is flagged as truncated.
+ * 
+ * @param p_ptr_sb input/output: The builder.
+ * @retval The text, "" when the buffer has no room for the terminator at all.
+ */
+const char * string_builder_c_str(string_builder_t * p_ptr_sb);
+
+/* C++11 constexpr functions are single return statements, the formatters below recurse and expand
+   index lists instead of looping. They only run at compile time when their result is constexpr */
+
+constexpr uint32_t string_count_digits_c(uint32_t p_num, uint32_t p_base)
+{
+    return (p_num < p_base) ? 1U : (1U + string_count_digits_c(p_num / p_base, p_base));
+}
+
+constexpr uint32_t string_pow_c(uint32_t p_base, uint32_t p_exp)
+{
+    return (p_exp == 0U) ? 1U : (p_base * string_pow_c(p_base, p_exp - 1U));
+}
+
+constexpr uint32_t string_magnitude_c(int32_t p_num)
+{
+    return (p_num < 0) ? (0U - (uint32_t)p_num) : (uint32_t)p_num;
+}
+
+/**
+ * @brief Character p_idx of a p_digits long number, the most significant one first.
+ */
+constexpr char string_digit_at_c(uint32_t p_num, uint32_t p_digits, uint32_t p_idx, uint32_t p_base)
+{
+    return "0123456789abcdef"[(p_num / string_pow_c(p_base, p_digits - 1U - p_idx)) % p_base];
+}
+
+template <uint32_t Magnitude, bool IsNegative, uint32_t Base, uint32_t... I>
+constexpr string_const_t<sizeof...(I) + 1U> string_format_c(string_index_seq_t<I...>)
+{
+    return {{((IsNegative && (I == 0U)) ? '-' :
+              string_digit_at_c(Magnitude, sizeof...(I) - (IsNegative ? 1U : 0U), I - (IsNegative ? 1U : 0U), Base))...,
+             '\0'}};
+}
+
+/**
+ * @brief These functions convert an integer known at compile time to text, in the format of the
+ *        matching string_xxxtoa() function, e.g. string_i32toa_c<-42>().buf is "-42".
+ * 
+ * @tparam Num The number to be converted.
+ * @retval The text, as long as the number needs.
+ */
+template <uint32_t Num>
+constexpr string_const_t<string_count_digits_c(Num, 10U) + 1U> string_u32toa_c()
+{
+    return string_format_c<Num, false, 10U>(typename string_make_index_seq_t<string_count_digits_c(Num, 10U)>::type());
+}
+
+template <int32_t Num>
+constexpr string_const_t<string_count_digits_c(string_magnitude_c(Num), 10U) + ((Num < 0) ? 2U : 1U)> string_i32toa_c()
+{
+    return string_format_c<string_magnitude_c(Num), (Num < 0), 10U>(
+        typename string_make_index_seq_t<string_count_digits_c(string_magnitude_c(Num), 10U) + ((Num < 0) ? 1U : 0U)>::type());
+}
+
+template <uint32_t Num>
+constexpr string_const_t<string_count_digits_c(Num, 16U) + 1U> string_hex32toa_c()
+{
+    return string_format_c<Num, false, 16U>(typename string_make_index_seq_t<string_count_digits_c(Num, 16U)>::type());
+}
+
+template <uint32_t N, uint32_t... I>
+constexpr string_const_t<N> string_reverse_c(const char * p_ptr_str, string_index_seq_t<I...>)
+{
+    return {{p_ptr_str[N - 2U - I]..., '\0'}};
+}
+
+/**
+ * @brief This function reverses a string literal or the text of a string_const_t at compile time.
+ * 
+ * @param p_str input: The string to be reversed, its terminator stays at the end.
+ * @retval The reversed string.
+ */
+template <uint32_t N>
+constexpr string_const_t<N> string_reverse_c(const char (&p_str)[N])
+{
+    return string_reverse_c<N>(p_str, typename string_make_index_seq_t<N - 1U>::type());
+}
+
+template <uint32_t N, uint32_t M, uint32_t... I>
+constexpr string_const_t<N + M - 1U> string_concat_c(const char * p_ptr_first, const char * p_ptr_second, string_index_seq_t<I...>)
+{
+    return {{((I < (N - 1U)) ? p_ptr_first[I] : p_ptr_second[I - (N - 1U)])..., '\0'}};
+}
+
+/**
+ * @brief This function joins two string literals or texts of string_const_t at compile time,
+ *        e.g. string_concat_c("v", string_u32toa_c<VERSION>().buf).
+ * 
+ * @param p_first input: The leading string.
+ * @param p_second input: The trailing string.
+ * @retval The joined string.
+ */
+template <uint32_t N, uint32_t M>
+constexpr string_const_t<N + M - 1U> string_concat_c(const char (&p_first)[N], const char (&p_second)[M])
+{
+    return string_concat_c<N, M>(p_first, p_second, typename string_make_index_seq_t<N + M - 2U>::type());
+}
+
 #endif /* STRING_UTIL_H */
@@ -10,7 +10,11 @@
 * Header files.
 ***************************************************************************************************/
 
+/* Log module of this file, defined before debug_logger.h is included */
+#define DBG_MODULE LOG_MODULE_WEB
+
 #include "web_server_util.h"
+#include "debug_trace.h"
 #include "Arduino.h"
 #include <DNSServer.h>
 #include <WiFi.h>
@@ -21,16 +25,67 @@
 * Macro definitions.
 ***************************************************************************************************/
 
+/* Quoted 64-bit content hash in hexadecimal, terminator included */
+#define WEB_ASSET_ETAG_LEN (STRING_HEX64_MAX_LEN + 2U)
+#define WEB_ASSET_READ_CHUNK_SIZE (256U)
+
+#define WEB_FNV1A_64_OFFSET (0xcbf29ce484222325ULL)
+#define WEB_FNV1A_64_PRIME (0x100000001b3ULL)
+
 /***************************************************************************************************
 * Local type definitions.
 ***************************************************************************************************/
 
+typedef enum web_asset_encoding_t_enum
+{
+    WEB_ASSET_IDENTITY = 0,
+    WEB_ASSET_GZIP,
+    WEB_ASSET_ENCODING_COUNT,
+} web_asset_encoding_t;
+
+typedef enum web_asset_id_t_enum
+{
+    WEB_ASSET_INDEX_HTML = 0,
+    WEB_ASSET_STYLE_CSS,
+    WEB_ASSET_IMG1_PNG,
+    WEB_ASSET_COUNT,
+} web_asset_id_t;
+
+/* One encoding of an asset. data_ptr is NULL when it did not fit in the cache and is read from SPIFFS */
+typedef struct web_asset_variant_t_struct
+{
+    const uint8_t * data_ptr;
+    uint32_t size;
+    bool is_present;
+    char etag[WEB_ASSET_ETAG_LEN];
+} web_asset_variant_t;
+
+typedef struct web_asset_t_struct
+{
+    const char * paths[WEB_ASSET_ENCODING_COUNT];
+    const char * content_type;
+    const char * cache_control;
+    web_asset_variant_t variants[WEB_ASSET_ENCODING_COUNT];
+} web_asset_t;
+
 /***************************************************************************************************
  * Local data definitions.
 ***************************************************************************************************/
 
 static AsyncWebServer s_async_web_server(80);
 
+/* The page is revalidated on every load, so a new firmware image shows at once.
+   The style and image are reused for an hour without asking */
+static web_asset_t s_web_assets[WEB_ASSET_COUNT] = {
+    {{"/index.html", "/index.html.gz"}, "text/html", "no-cache", {}},
+    {{"/style.css", "/style.css.gz"}, "text/css", "max-age=3600", {}},
+    {{"/img1.png", "/img1.png.gz"}, "image/png", "max-age=3600", {}},
+};
+
+static uint8_t s_web_asset_cache[WEB_ASSET_CACHE_SIZE];
+static uint32_t s_web_asset_cache_used = 0U;
+static bool s_web_assets_are_loaded = false;
+
 static const String s_html_error_page = PROGMEM(
 "<center>"
     "<h3 style=color:red;font-weight:bold;>"
@@ -44,6 +99,231 @@ static const String s_html_error_page = PROGMEM(
 * Local function definitions.
 ***************************************************************************************************/
 
+static uint64_t web_server_hash(uint64_t p_hash, const uint8_t * p_ptr_data, uint32_t p_size)
+{
+    for (uint32_t i = 0U; i < p_size; i++)
+    {
+        p_hash = (p_hash ^ p_ptr_data[i]) * WEB_FNV1A_64_PRIME;
+    }
+    return p_hash;
+}
+
+/**
+ * @brief Loads one encoding of an asset in the cache if it fits, and hashes it for its ETag.
+ *        An asset that does not fit is only read to be hashed.
+ */
+static void web_server_load_variant(const char * p_ptr_path, web_asset_variant_t * p_ptr_variant)
+{
+    File file;
+    uint8_t chunk[WEB_ASSET_READ_CHUNK_SIZE];
+    uint8_t * dest_ptr = NULL;
+    uint32_t read_size = 0U;
+    uint32_t total_size = 0U;
+    uint64_t hash = WEB_FNV1A_64_OFFSET;
+    string_builder_t etag;
+
+    if (SPIFFS.exists(p_ptr_path))
+    {
+        file = SPIFFS.open(p_ptr_path, "r");
+    }
+    if (file)
+    {
+        p_ptr_variant->size = file.size();
+        if (p_ptr_variant->size <= (WEB_ASSET_CACHE_SIZE - s_web_asset_cache_used))
+        {
+            dest_ptr = &s_web_asset_cache[s_web_asset_cache_used];
+        }
+
+        do
+        {
+            read_size = file.read((dest_ptr != NULL) ? &dest_ptr[total_size] : chunk,
+                                  (dest_ptr != NULL) ? (p_ptr_variant->size - total_size) : sizeof(chunk));
+            hash = web_server_hash(hash, (dest_ptr != NULL) ? &dest_ptr[total_size] : chunk, read_size);
+            total_size += read_size;
+        } while ((read_size > 0U) && (total_size < p_ptr_variant->size));
+        file.close();
+
+        if (total_size == p_ptr_variant->size)
+        {
+            if (dest_ptr != NULL)
+            {
+                p_ptr_variant->data_ptr = dest_ptr;
+                s_web_asset_cache_used += total_size;
+            }
+            else
+            {
+                logger_w("An asset of %d bytes does not fit in the cache, it is read from SPIFFS\n", total_size);
+            }
+            string_builder_init(&etag, p_ptr_variant->etag, sizeof(p_ptr_variant->etag));
+            string_builder_append_char(&etag, '"');
+            string_builder_append_hex64(&etag, hash);
+            string_builder_append_char(&etag, '"');
+            string_builder_c_str(&etag);
+            p_ptr_variant->is_present = true;
+        }
+        else
+        {
+            logger_e("An asset could not be read from SPIFFS\n");
+        }
+    }
+}
+
+/**
+ * @brief Forgets the cached assets, they are loaded again from SPIFFS on the next start.
+ */
+static void web_server_clear_assets(void)
+{
+    for (uint8_t i = 0U; i < WEB_ASSET_COUNT; i++)
+    {
+        memset(s_web_assets[i].variants, 0, sizeof(s_web_assets[i].variants));
+    }
+    s_web_asset_cache_used = 0U;
+    s_web_assets_are_loaded = false;
+}
+
+static void web_server_load_assets(void)
+{
+    for (uint8_t i = 0U; i < WEB_ASSET_COUNT; i++)
+    {
+        /* The gzip variants go first, they are the smaller ones and the ones most clients get */
+        web_server_load_variant(s_web_assets[i].paths[WEB_ASSET_GZIP], &s_web_assets[i].variants[WEB_ASSET_GZIP]);
+        web_server_load_variant(s_web_assets[i].paths[WEB_ASSET_IDENTITY], &s_web_assets[i].variants[WEB_ASSET_IDENTITY]);
+    }
+    logger_i("%d bytes of web assets are cached\n", s_web_asset_cache_used);
+    s_web_assets_are_loaded = true;
+}
+
+/**
+ * @brief Checks whether a header of the request contains a token, e.g. "gzip" in Accept-Encoding.
+ */
+static bool web_server_header_contains(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_header_name, const char *p_ptr_token)
+{
+    AsyncWebHeader *header_ptr = p_ptr_request->getHeader(p_ptr_header_name);
+
+    return (header_ptr != NULL) && (strstr(header_ptr->value().c_str(), p_ptr_token) != NULL);
+}
+
+static const char * web_server_skip_list_separators(const char * p_ptr_str)
+{
+    while ((*p_ptr_str == ',') || (*p_ptr_str == ' ') || (*p_ptr_str == '\t'))
+    {
+        p_ptr_str++;
+    }
+    return p_ptr_str;
+}
+
+/**
+ * @brief Checks an If-None-Match value against the ETag of the asset. The value is "*" or a comma
+ *        separated list of entity tags, a W/ prefix is ignored since the comparison is weak.
+ *        A quoted tag may contain commas, so the list is split at the quotes.
+ */
+static bool web_server_etag_list_matches(const char * p_ptr_list, const char * p_ptr_etag)
+{
+    const char * entry_ptr = web_server_skip_list_separators(p_ptr_list);
+    const char * end_ptr = NULL;
+    const uint32_t etag_len = strlen(p_ptr_etag);
+    bool is_match = false;
+
+    while ((false == is_match) && (entry_ptr != NULL) && (*entry_ptr != '\0'))
+    {
+        if (*entry_ptr == '*')
+        {
+            is_match = true;
+        }
+        else
+        {
+            if ((entry_ptr[0] == 'W') && (entry_ptr[1] == '/'))
+            {
+                entry_ptr += 2;
+            }
+            end_ptr = (*entry_ptr == '"') ? strchr(&entry_ptr[1], '"') : NULL;
+            if (end_ptr != NULL)
+            {
+                end_ptr++;
+                is_match = (((uint32_t)(end_ptr - entry_ptr) == etag_len) && (memcmp(entry_ptr, p_ptr_etag, etag_len) == 0));
+                entry_ptr = web_server_skip_list_separators(end_ptr);
+            }
+            else
+            {
+                /* Not an entity tag, the rest of the list cannot be split reliably */
+                entry_ptr = NULL;
+            }
+        }
+    }
+    return is_match;
+}
+
+/**
+ * @brief Sends an asset from the cache, or from SPIFFS when it did not fit. The gzip variant is sent
+ *        when the client accepts it, or when it is the only one and the request has no Accept-Encoding.
+ *        A gzip only asset is answered with 406 to a client that does not take gzip.
+ *        A matching If-None-Match is answered with 304 and no body.
+ */
+static void web_server_send_asset(AsyncWebServerRequest *p_ptr_request, web_asset_id_t p_asset_id)
+{
+    const web_asset_t *asset_ptr = &s_web_assets[p_asset_id];
+    const bool has_gzip = asset_ptr->variants[WEB_ASSET_GZIP].is_present;
+    const bool has_identity = asset_ptr->variants[WEB_ASSET_IDENTITY].is_present;
+    /* Without Accept-Encoding any coding is acceptable, the plain variant is still preferred then */
+    const bool is_gzip_sent = has_gzip && (web_server_header_contains(p_ptr_request, "Accept-Encoding", "gzip") ||
+                                           (!has_identity && !p_ptr_request->hasHeader("Accept-Encoding")));
+    const web_asset_encoding_t encoding = is_gzip_sent ? WEB_ASSET_GZIP : WEB_ASSET_IDENTITY;
+    const web_asset_variant_t *variant_ptr = &asset_ptr->variants[encoding];
+    AsyncWebHeader *if_none_match_ptr = p_ptr_request->getHeader("If-None-Match");
+    AsyncWebServerResponse *response_ptr = NULL;
+    bool is_not_modified = false;
+
+    if ((false == variant_ptr->is_present) && (true == has_gzip))
+    {
+        /* Only the gzip variant exists and the client does not take it */
+        p_ptr_request->send(406, "text/plain", "Not acceptable");
+    }
+    else if (false == variant_ptr->is_present)
+    {
+        p_ptr_request->send(404, "text/plain", "Not found");
+    }
+    else
+    {
+        is_not_modified = (if_none_match_ptr != NULL) &&
+                          web_server_etag_list_matches(if_none_match_ptr->value().c_str(), variant_ptr->etag);
+        if (true == is_not_modified)
+        {
+            response_ptr = p_ptr_request->beginResponse(304);
+        }
+        else if (variant_ptr->data_ptr != NULL)
+        {
+            /* Sent straight from the cache, the body is not copied */
+            response_ptr = p_ptr_request->beginResponse_P(200, asset_ptr->content_type, variant_ptr->data_ptr, variant_ptr->size);
+        }
+        else
+        {
+            response_ptr = p_ptr_request->beginResponse(SPIFFS, asset_ptr->paths[encoding], asset_ptr->content_type);
+        }
+
+        response_ptr->addHeader("ETag", variant_ptr->etag);
+        response_ptr->addHeader("Cache-Control", asset_ptr->cache_control);
+        if (true == has_gzip)
+        {
+            response_ptr->addHeader("Vary", "Accept-Encoding");
+        }
+        if ((encoding == WEB_ASSET_GZIP) && (false == is_not_modified))
+        {
+            response_ptr->addHeader("Content-Encoding", "gzip");
+        }
+        p_ptr_request->send(response_ptr);
+    }
+}
+
+/**
+ * @brief Gets the value of a parameter, NULL if the request does not have it.
+ */
+static const String * web_server_find_param_value(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name)
+{
+    AsyncWebParameter *param_ptr = p_ptr_request->getParam(p_ptr_param_name);
+
+    return (param_ptr != NULL) ? &param_ptr->value() : NULL;
+}
+
 /***************************************************************************************************
 * External data definitions.
 ***************************************************************************************************/
@@ -62,21 +342,27 @@ bool web_server_init(web_server_cb_t p_get_cb)
     }
     else
     {
+        if (false == s_web_assets_are_loaded)
+        {
+            web_server_load_assets();
+        }
         s_async_web_server.on
         (
             "/", HTTP_GET, 
             [](AsyncWebServerRequest *request)
             {
-                request->send(SPIFFS, "/index.html", "text/html", false);
-                logger_d(NULL, "Client connected\n");
+                TRACE_SCOPE("web /");
+                web_server_send_asset(request, WEB_ASSET_INDEX_HTML);
+                logger_d("Client connected\n");
             }
         );
         s_async_web_server.on
         (
             "/style.css", HTTP_GET, 
             [](AsyncWebServerRequest *request)
-            { 
-                request->send(SPIFFS, "/style.css", "text/css"); 
+            {
+                TRACE_SCOPE("web /style.css");
+                web_server_send_asset(request, WEB_ASSET_STYLE_CSS);
             }
         );
         s_async_web_server.on
@@ -84,7 +370,8 @@ bool web_server_init(web_server_cb_t p_get_cb)
             "/img1.png", HTTP_GET,
             [](AsyncWebServerRequest *request)
             {
-                request->send(SPIFFS, "/img1.png", "image/png");
+                TRACE_SCOPE("web /img1.png");
+                web_server_send_asset(request, WEB_ASSET_IMG1_PNG);
             }
         );
         s_async_web_server.on
@@ -92,6 +379,7 @@ bool web_server_init(web_server_cb_t p_get_cb)
             "/get", HTTP_GET,
             [p_get_cb](AsyncWebServerRequest *request)
             {
+                TRACE_SCOPE("web /get");
                 if (p_get_cb(request) == true)
                 {
                     request->send(200, "text/plain", "true");
@@ -110,6 +398,11 @@ bool web_server_init(web_server_cb_t p_get_cb)
 
 void web_server_start()
 {
+    /* Cleared by the last stop, SPIFFS may hold new assets since */
+    if ((false == s_web_assets_are_loaded) && SPIFFS.begin())
+    {
+        web_server_load_assets();
+    }
     s_async_web_server.begin();
 }
 
@@ -117,6 +410,7 @@ void web_server_stop()
 {
     s_async_web_server.end();
     SPIFFS.end();
+    web_server_clear_assets();
 }
 
 bool web_server_request_has_param(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name)
@@ -126,5 +420,33 @@ bool web_server_request_has_param(AsyncWebServerRequest *p_ptr_request, const ch
 
 int web_server_request_get_param(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name)
 {
-    return p_ptr_request->getParam(p_ptr_param_name)->value().toInt();
+    int32_t value = 0;
+
+    if (web_server_request_get_param_i32(p_ptr_request, p_ptr_param_name, &value) != STRING_PARSE_OK)
+    {
+        logger_w("A numeric parameter is missing or not a number\n");
+        value = 0;
+    }
+    return value;
+}
+
+string_parse_status_t web_server_request_get_param_i32(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name, int32_t *p_ptr_value)
+{
+    const String *value_ptr = web_server_find_param_value(p_ptr_request, p_ptr_param_name);
+
+    return (value_ptr != NULL) ? string_parse_i32(value_ptr->c_str(), value_ptr->length(), p_ptr_value) : STRING_PARSE_EMPTY;
+}
+
+string_parse_status_t web_server_request_get_param_u32(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name, uint32_t *p_ptr_value)
+{
+    const String *value_ptr = web_server_find_param_value(p_ptr_request, p_ptr_param_name);
+
+    return (value_ptr != NULL) ? string_parse_u32(value_ptr->c_str(), value_ptr->length(), p_ptr_value) : STRING_PARSE_EMPTY;
+}
+
+string_parse_status_t web_server_request_get_param_float(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name, float *p_ptr_value)
+{
+    const String *value_ptr = web_server_find_param_value(p_ptr_request, p_ptr_param_name);
+
+    return (value_ptr != NULL) ? string_parse_float(value_ptr->c_str(), value_ptr->length(), p_ptr_value) : STRING_PARSE_EMPTY;
 }
\ No newline at end of file
@@ -14,12 +14,19 @@
 ***************************************************************************************************/
 
 #include "debug_logger.h"
+#include "string_util.h"
 #include "ESPAsyncWebServer.h"
 
 /***************************************************************************************************
 * Macro definitions.
 ***************************************************************************************************/
 
+/* RAM the static assets are loaded into when the server is initialized or started again. Assets that do not fit
+   are read from SPIFFS on each request, they still get ETags */
+#ifndef WEB_ASSET_CACHE_SIZE
+#define WEB_ASSET_CACHE_SIZE (16384U)
+#endif
+
 /***************************************************************************************************
 * External type declarations.
 ***************************************************************************************************/
@@ -36,6 +43,8 @@ typedef bool (*web_server_cb_t)(AsyncWebServerRequest * p_ptr_request);
 
 /**
  * @brief This function initializes async web server on port 80 and SPIFFS module.
+ *        The static assets and their gzip variants (name.gz) are loaded on the first call.
+ *        They are served with strong ETags and Cache-Control, If-None-Match is answered with 304.
  * 
  * @param p_get_cb 
  * @retval true if the initialization is successful.
@@ -44,12 +53,12 @@ typedef bool (*web_server_cb_t)(AsyncWebServerRequest * p_ptr_request);
 bool web_server_init(web_server_cb_t p_get_cb);
 
 /**
- * @brief This function starts the web server.
+ * @brief This function starts the web server. The assets are loaded again if a stop cleared them.
  */
 void web_server_start();
 
 /**
- * @brief This function stops the web server and SPIFFS module.
+ * @brief This function stops the web server and SPIFFS module, and clears the cached assets.
  */
 void web_server_stop();
 
@@ -68,8 +77,21 @@ bool web_server_request_has_param(AsyncWebServerRequest *p_ptr_request, const ch
  * 
  * @param p_ptr_request pointer to the request struct.
  * @param p_ptr_param_name pointer to the parameter name.
- * @retval the numeric value of the parameter.
+ * @retval the numeric value of the parameter, 0 if it is missing or not a 32-bit integer.
  */
 int web_server_request_get_param(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name);
 
+/**
+ * @brief These functions parse the value of a specific parameter from the received request in place,
+ *        without allocating. The whole value must be a number, see the string_parse_xxx() functions.
+ * 
+ * @param p_ptr_request pointer to the request struct.
+ * @param p_ptr_param_name pointer to the parameter name.
+ * @param p_ptr_value output: the parsed value, only written when STRING_PARSE_OK is returned.
+ * @retval STRING_PARSE_EMPTY if the parameter is missing or empty, otherwise the status of the parse.
+ */
+string_parse_status_t web_server_request_get_param_i32(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name, int32_t *p_ptr_value);
+string_parse_status_t web_server_request_get_param_u32(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name, uint32_t *p_ptr_value);
+string_parse_status_t web_server_request_get_param_float(AsyncWebServerRequest *p_ptr_request, const char *p_ptr_param_name, float *p_ptr_value);
+
 #endif /* WEB_SERVER_UTIL_H */
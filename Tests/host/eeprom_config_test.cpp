@@ -0,0 +1,181 @@
+/***************************************************************************************************
+* File Name: eeprom_config_test.cpp
+* Module: Tests/host
+* Abstract: Checks the config layout of HW_eeprom_config.h across firmware updates: a struct that
+*           grows within its capacity is migrated and does not move the sections after it, and a section
+*           added at the end keeps the data of the other sections and the key-value records.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include "EEPROM.h"
+#include "HW_eeprom_config.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define KV_KEY (3U)
+
+/***************************************************************************************************
+* Local type definitions.
+***************************************************************************************************/
+
+/* First release of the wifi config */
+struct wifi_config_v1_t
+{
+    static const uint16_t SCHEMA_VERSION = 1U;
+    static const uint16_t EEPROM_CAPACITY = 64U;
+    char ssid[16];
+    uint16_t channel;
+
+    static bool migrate(uint16_t, const uint8_t *, uint16_t, wifi_config_v1_t &)
+    {
+        return false;
+    }
+};
+
+/* Second release, a field is added at the end */
+struct wifi_config_t
+{
+    static const uint16_t SCHEMA_VERSION = 2U;
+    static const uint16_t EEPROM_CAPACITY = 64U;
+    char ssid[16];
+    uint16_t channel;
+    uint32_t tx_power;
+
+    static bool migrate(uint16_t p_stored_version, const uint8_t * p_ptr_stored, uint16_t p_stored_size,
+                        wifi_config_t & p_config)
+    {
+        bool ret_val = (1U == p_stored_version && sizeof(wifi_config_v1_t) == p_stored_size);
+        if (true == ret_val)
+        {
+            memcpy(&p_config, p_ptr_stored, sizeof(wifi_config_v1_t));
+            p_config.tx_power = 20U;
+        }
+        return ret_val;
+    }
+};
+
+struct motor_config_t
+{
+    static const uint16_t SCHEMA_VERSION = 1U;
+    static const uint16_t EEPROM_CAPACITY = 16U;
+    int32_t max_speed;
+    int32_t acceleration;
+
+    static bool migrate(uint16_t, const uint8_t *, uint16_t, motor_config_t &)
+    {
+        return false;
+    }
+};
+
+/* Added by the third release */
+struct display_config_t
+{
+    static const uint16_t SCHEMA_VERSION = 1U;
+    static const uint16_t EEPROM_CAPACITY = 32U;
+    uint8_t brightness;
+
+    static bool migrate(uint16_t, const uint8_t *, uint16_t, display_config_t &)
+    {
+        return false;
+    }
+};
+
+typedef eeprom_layout<wifi_config_v1_t, motor_config_t> layout_v1_t;
+typedef eeprom_layout<wifi_config_t, motor_config_t> layout_v2_t;
+typedef eeprom_layout<wifi_config_t, motor_config_t, display_config_t> layout_v3_t;
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+/* The section after the grown struct keeps its address, and the data area keeps its size */
+static_assert(layout_v1_t::address_of<motor_config_t>() == layout_v2_t::address_of<motor_config_t>(),
+              "A grown config struct moved the next section");
+static_assert(layout_v1_t::DATA_SIZE == layout_v2_t::DATA_SIZE, "A grown config struct changed the data size");
+static_assert(false == eeprom_sections_are_valid<motor_config_t, wifi_config_t, motor_config_t>::is_unique,
+              "A duplicate config struct is not detected");
+static_assert(true == eeprom_sections_are_valid<wifi_config_t, motor_config_t>::is_unique &&
+              true == eeprom_sections_are_valid<wifi_config_t, motor_config_t>::fits,
+              "A valid layout is rejected");
+
+/**
+ * @brief A section added at the end grows the data size. The sections saved before and the
+ *        key-value records survive, the new section is empty until it is saved.
+ */
+static void check_added_section(const motor_config_t & p_motor)
+{
+    const uint8_t record[] = {1U, 2U, 3U, 4U, 5U};
+    uint8_t record_read[sizeof(record)];
+    uint16_t record_size = 0U;
+    wifi_config_t wifi;
+    motor_config_t motor_read = {0, 0};
+    display_config_t display = {0U};
+
+    HOST_CHECK(true == ardal_eeprom_init(layout_v2_t::DATA_SIZE));
+    HOST_CHECK(true == ardal_eeprom_kv_write(KV_KEY, record, sizeof(record)));
+    ardal_eeprom_deinit();
+
+    HOST_CHECK(true == ardal_eeprom_init(layout_v3_t::DATA_SIZE));
+    memset(&wifi, 0, sizeof(wifi));
+    HOST_CHECK(DATA_VALID == layout_v3_t::load(wifi) && 0 == strcmp(wifi.ssid, "home") && 20U == wifi.tx_power);
+    HOST_CHECK(DATA_VALID == layout_v3_t::load(motor_read) && p_motor.max_speed == motor_read.max_speed);
+    HOST_CHECK(DATA_INVALID == layout_v3_t::load(display));
+    HOST_CHECK(DATA_VALID == ardal_eeprom_kv_read(KV_KEY, record_read, sizeof(record_read), &record_size));
+    HOST_CHECK(sizeof(record) == record_size && 0 == memcmp(record, record_read, sizeof(record)));
+    display.brightness = 80U;
+    HOST_CHECK(true == layout_v3_t::save(display));
+    ardal_eeprom_deinit();
+
+    /* Migrated once, the next boot finds the data at the new size */
+    HOST_CHECK(true == ardal_eeprom_init(layout_v3_t::DATA_SIZE));
+    display.brightness = 0U;
+    HOST_CHECK(DATA_VALID == layout_v3_t::load(display) && 80U == display.brightness);
+    HOST_CHECK(DATA_VALID == layout_v3_t::load(motor_read) && p_motor.acceleration == motor_read.acceleration);
+    HOST_CHECK(DATA_VALID == ardal_eeprom_kv_read(KV_KEY, record_read, sizeof(record_read), &record_size));
+    ardal_eeprom_deinit();
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    wifi_config_v1_t wifi_v1 = {{'h', 'o', 'm', 'e'}, 6U};
+    motor_config_t motor = {1200, 300};
+    wifi_config_t wifi;
+    motor_config_t motor_read = {0, 0};
+
+    /* First release saves both structs */
+    HOST_CHECK(true == ardal_eeprom_init(layout_v1_t::DATA_SIZE));
+    HOST_CHECK(true == layout_v1_t::save(wifi_v1));
+    HOST_CHECK(true == layout_v1_t::save(motor));
+    ardal_eeprom_deinit();
+
+    /* Second release loads them, the wifi config is migrated and saved again */
+    HOST_CHECK(true == ardal_eeprom_init(layout_v2_t::DATA_SIZE));
+    memset(&wifi, 0, sizeof(wifi));
+    HOST_CHECK(DATA_VALID == layout_v2_t::load(motor_read));
+    HOST_CHECK(motor.max_speed == motor_read.max_speed && motor.acceleration == motor_read.acceleration);
+    HOST_CHECK(DATA_VALID == layout_v2_t::load(wifi));
+    HOST_CHECK(0 == strcmp(wifi.ssid, "home") && 6U == wifi.channel && 20U == wifi.tx_power);
+    ardal_eeprom_deinit();
+
+    /* After the migration the struct loads without migrating again, the motor config is untouched */
+    HOST_CHECK(true == ardal_eeprom_init(layout_v2_t::DATA_SIZE));
+    memset(&wifi, 0, sizeof(wifi));
+    HOST_CHECK(DATA_VALID == layout_v2_t::load(wifi) && 20U == wifi.tx_power);
+    HOST_CHECK(DATA_VALID == layout_v2_t::load(motor_read) && motor.max_speed == motor_read.max_speed);
+    ardal_eeprom_deinit();
+
+    check_added_section(motor);
+    return host_test_report("eeprom_config_test");
+}
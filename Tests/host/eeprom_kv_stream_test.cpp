@@ -0,0 +1,159 @@
+/***************************************************************************************************
+* File Name: eeprom_kv_stream_test.cpp
+* Module: Tests/host
+* Abstract: Checks the key-value store with a certificate sized blob next to 80 KB of data slots, the
+*           reclaiming of stream writes that are never ended: after EEPROM_STREAM_TIMEOUT_MS, and on deinit,
+*           and that a held view keeps the records in place.
+*           Built with -DEEPROM_KV_AREA_SIZE=4096 -DEEPROM_STREAM_TIMEOUT_MS=50.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <Arduino.h>
+#include "EEPROM.h"
+#include "HW_eeprom.h"
+#include "debug_logger.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+/* The two data slots take 80 KB after the key-value area */
+#define DATA_SIZE (40000U)
+#define CERT_KEY (0U)
+#define CERT_SIZE (2048U)
+#define STREAM_CHUNK_SIZE (100U)
+#define VIEW_KEY (7U)
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static uint8_t s_cert[CERT_SIZE];
+static uint8_t s_buffer[EEPROM_KV_MAX_RECORD_SIZE];
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static void reboot(void)
+{
+    ardal_eeprom_deinit();
+    HOST_CHECK(true == ardal_eeprom_init(DATA_SIZE));
+}
+
+static bool write_cert(void)
+{
+    eeprom_stream_t stream;
+    bool ret_val = ardal_eeprom_stream_write_begin(&stream, CERT_KEY, CERT_SIZE);
+
+    for (uint32_t position = 0U; position < CERT_SIZE && true == ret_val; position += STREAM_CHUNK_SIZE)
+    {
+        ret_val = ardal_eeprom_stream_write(&stream, &s_cert[position],
+                                            (CERT_SIZE - position) < STREAM_CHUNK_SIZE ? (uint16_t)(CERT_SIZE - position) :
+                                                                                         (uint16_t)STREAM_CHUNK_SIZE);
+    }
+    return (true == ardal_eeprom_stream_write_end(&stream) && true == ret_val);
+}
+
+static bool is_cert_valid(void)
+{
+    uint16_t read_size = 0U;
+    return (DATA_VALID == ardal_eeprom_kv_read(CERT_KEY, s_buffer, sizeof(s_buffer), &read_size) &&
+            CERT_SIZE == read_size && 0 == memcmp(s_cert, s_buffer, CERT_SIZE));
+}
+
+/**
+ * @brief A stream left open blocks the compaction until it times out, then it is abandoned.
+ */
+static void check_stale_stream(void)
+{
+    eeprom_stream_t stream;
+
+    /* Leaves 1512 deleted bytes that only a compaction frees */
+    HOST_CHECK(true == ardal_eeprom_kv_write(1U, s_buffer, 1500U));
+    HOST_CHECK(true == ardal_eeprom_kv_erase(1U));
+    HOST_CHECK(true == ardal_eeprom_stream_write_begin(&stream, 2U, STREAM_CHUNK_SIZE));
+    HOST_CHECK(true == ardal_eeprom_stream_write(&stream, s_cert, 10U));
+    HOST_CHECK(false == ardal_eeprom_kv_write(3U, s_buffer, 800U));
+
+    delay(EEPROM_STREAM_TIMEOUT_MS + 20U);
+    HOST_CHECK(true == ardal_eeprom_kv_write(3U, s_buffer, 800U));
+    HOST_CHECK(false == ardal_eeprom_stream_write(&stream, s_cert, 10U));
+    HOST_CHECK(false == ardal_eeprom_stream_write_end(&stream));
+    HOST_CHECK(true == is_cert_valid());
+}
+
+/**
+ * @brief A stream still open on deinit does not block the compaction after the next init.
+ */
+static void check_stream_open_on_deinit(void)
+{
+    eeprom_stream_t stream;
+
+    HOST_CHECK(true == ardal_eeprom_kv_erase(3U));
+    HOST_CHECK(true == ardal_eeprom_stream_write_begin(&stream, 4U, STREAM_CHUNK_SIZE));
+    reboot();
+    HOST_CHECK(true == ardal_eeprom_kv_write(5U, s_buffer, 1300U));
+    HOST_CHECK(false == ardal_eeprom_stream_write(&stream, s_cert, 10U));
+    HOST_CHECK(true == is_cert_valid());
+}
+
+/**
+ * @brief A held view blocks the compaction that would move its record, releasing it unblocks it.
+ */
+static void check_view_across_compaction(void)
+{
+    const uint8_t * view_ptr = NULL;
+    uint16_t view_size = 0U;
+
+    /* The viewed record follows 1312 deleted bytes, so a compaction would move it down */
+    HOST_CHECK(true == ardal_eeprom_kv_write(VIEW_KEY, s_cert, STREAM_CHUNK_SIZE));
+    HOST_CHECK(true == ardal_eeprom_kv_erase(5U));
+    view_ptr = ardal_eeprom_kv_get_view(VIEW_KEY, &view_size);
+    HOST_CHECK(NULL != view_ptr && STREAM_CHUNK_SIZE == view_size);
+
+    HOST_CHECK(false == ardal_eeprom_kv_write(8U, s_buffer, 800U));
+    HOST_CHECK(NULL != view_ptr && 0 == memcmp(view_ptr, s_cert, STREAM_CHUNK_SIZE));
+
+    ardal_eeprom_kv_release_view(view_ptr);
+    HOST_CHECK(true == ardal_eeprom_kv_write(8U, s_buffer, 800U));
+    HOST_CHECK(DATA_VALID == ardal_eeprom_kv_read(VIEW_KEY, s_buffer, sizeof(s_buffer), &view_size) &&
+               STREAM_CHUNK_SIZE == view_size && 0 == memcmp(s_buffer, s_cert, STREAM_CHUNK_SIZE));
+    HOST_CHECK(true == is_cert_valid());
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    eeprom_stream_t stream;
+
+    debug_agents_init();
+    for (uint32_t i = 0; i < CERT_SIZE; i++)
+    {
+        s_cert[i] = (uint8_t)((i * 31U) + (i >> 8));
+    }
+    HOST_CHECK(true == ardal_eeprom_init(DATA_SIZE));
+
+    /* The certificate record is found again after a reset */
+    HOST_CHECK(true == write_cert());
+    reboot();
+    HOST_CHECK(true == is_cert_valid());
+    HOST_CHECK(false == ardal_eeprom_stream_write_begin(&stream, 6U, EEPROM_KV_MAX_RECORD_SIZE + 1U));
+
+    check_stale_stream();
+    check_stream_open_on_deinit();
+    check_view_across_compaction();
+
+    ardal_eeprom_deinit();
+    debug_agents_flush();
+    return host_test_report("eeprom_kv_stream_test");
+}
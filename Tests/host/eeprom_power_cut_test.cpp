@@ -0,0 +1,249 @@
+/***************************************************************************************************
+* File Name: eeprom_power_cut_test.cpp
+* Module: Tests/host
+* Abstract: Cuts the power after every byte a data write commits to the mock EEPROM, then checks
+*           that ardal_eeprom_init() recovers the last good A/B slot: the previous or the new data.
+*           Also checks that a write costs one commit, which writes count as coalesced and that the
+*           single copy layout is migrated.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <vector>
+#include "EEPROM.h"
+#include "HW_eeprom.h"
+#include "debug_logger.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define DATA_SIZE (48U)
+#define DATA_START_ADRS (EEPROM_DATA_START_ADRS)
+/* Long enough that both async writes land before the commit task wakes */
+#define QUIET_PERIOD_MS (10000U)
+
+/* Single copy layout written by the first release */
+#define LEGACY_MAGIC_NUMBER_VAL ((uint16_t)0xdeadU)
+#define LEGACY_MAGIC_NUMBER_ADRS (0U)
+#define LEGACY_CHECKSUM_ADRS (3U)
+
+/***************************************************************************************************
+* Local type definitions.
+***************************************************************************************************/
+
+typedef enum read_result_t_enum
+{
+    READ_OLD = 0,
+    READ_NEW,
+    READ_OTHER,
+    READ_INVALID,
+} read_result_t;
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static void fill(uint8_t * p_ptr_data, uint32_t p_size, uint8_t p_seed)
+{
+    for (uint32_t i = 0; i < p_size; i++)
+    {
+        p_ptr_data[i] = (uint8_t)(p_seed + (i * 7U));
+    }
+}
+
+static bool write_data(const uint8_t * p_ptr_data)
+{
+    return ardal_eeprom_write_data((uint8_t *)p_ptr_data, DATA_SIZE, DATA_START_ADRS);
+}
+
+static read_result_t read_data(const uint8_t * p_ptr_old, const uint8_t * p_ptr_new)
+{
+    uint8_t data[DATA_SIZE];
+    read_result_t result = READ_INVALID;
+
+    if (DATA_VALID == ardal_eeprom_read_data(data, DATA_SIZE, DATA_START_ADRS))
+    {
+        result = (0 == memcmp(data, p_ptr_old, DATA_SIZE)) ? READ_OLD :
+                 (0 == memcmp(data, p_ptr_new, DATA_SIZE)) ? READ_NEW : READ_OTHER;
+    }
+    return result;
+}
+
+/**
+ * @brief Simulates a reset: the module state is dropped and init reads the flash again.
+ */
+static void reboot(void)
+{
+    ardal_eeprom_deinit();
+    eeprom_mock_power_on();
+    HOST_CHECK(true == ardal_eeprom_init(DATA_SIZE));
+}
+
+/**
+ * @brief Replays the write from the same flash content once per byte it commits, with the power cut
+ *        after 0, 1, 2... bytes. After each cut the old data must be read, or the new data once its last
+ *        byte is written, and the next write must work.
+ */
+static void check_power_cuts(const uint8_t * p_ptr_old, const uint8_t * p_ptr_new)
+{
+    std::vector<uint8_t> base_flash;
+    uint32_t write_size = 0U;
+    uint32_t old_count = 0U;
+    uint32_t new_count = 0U;
+    read_result_t result = READ_INVALID;
+
+    reboot();
+    base_flash = eeprom_mock_flash();
+    write_size = eeprom_mock_written_count();
+    HOST_CHECK(true == write_data(p_ptr_new));
+    write_size = eeprom_mock_written_count() - write_size;
+
+    for (uint32_t cut = 0; cut <= write_size; cut++)
+    {
+        ardal_eeprom_deinit();
+        eeprom_mock_flash() = base_flash;
+        reboot();
+        eeprom_mock_cut_power_after((int32_t)cut);
+        HOST_CHECK((cut < write_size) != write_data(p_ptr_new));
+        reboot();
+
+        result = read_data(p_ptr_old, p_ptr_new);
+        old_count += (READ_OLD == result) ? 1U : 0U;
+        new_count += (READ_NEW == result) ? 1U : 0U;
+        if (false == HOST_CHECK(READ_OLD == result || READ_NEW == result) ||
+            false == HOST_CHECK(cut < write_size || READ_NEW == result))
+        {
+            printf("Power cut after %u of %u bytes, read result %d\n", cut, write_size, result);
+        }
+        /* The recovered area takes writes again */
+        HOST_CHECK(true == write_data(p_ptr_old));
+        reboot();
+        HOST_CHECK(READ_OLD == read_data(p_ptr_old, p_ptr_new));
+    }
+    printf("%u power cuts, old data read %u times, new data %u times\n", write_size + 1U, old_count, new_count);
+}
+
+static void check_one_commit_per_write(void)
+{
+    uint8_t data[DATA_SIZE];
+    uint32_t commit_count = 0U;
+
+    reboot();
+    fill(data, DATA_SIZE, 0x40U);
+    commit_count = eeprom_mock_commit_count();
+    HOST_CHECK(true == write_data(data));
+    HOST_CHECK(1U == (eeprom_mock_commit_count() - commit_count));
+}
+
+/**
+ * @brief A write retrying a failed sync commit is not coalesced, an async write joining the pending
+ *        commit is.
+ */
+static void check_coalesced_writes(void)
+{
+    uint8_t data[DATA_SIZE];
+    eeprom_stats_t before;
+    eeprom_stats_t after;
+
+    reboot();
+    fill(data, DATA_SIZE, 0x50U);
+    ardal_eeprom_get_stats(&before);
+    eeprom_mock_cut_power_after(0);
+    HOST_CHECK(false == write_data(data));
+    eeprom_mock_power_on();
+    HOST_CHECK(true == write_data(data));
+    ardal_eeprom_get_stats(&after);
+    HOST_CHECK(2U == (after.write_count - before.write_count));
+    HOST_CHECK(0U == (after.coalesced_write_count - before.coalesced_write_count));
+
+    HOST_CHECK(true == ardal_eeprom_set_async_commit(true, QUIET_PERIOD_MS));
+    ardal_eeprom_get_stats(&before);
+    HOST_CHECK(true == write_data(data));
+    fill(data, DATA_SIZE, 0x60U);
+    HOST_CHECK(true == write_data(data));
+    HOST_CHECK(true == ardal_eeprom_set_async_commit(false, 0U));
+    ardal_eeprom_get_stats(&after);
+    HOST_CHECK(1U == (after.coalesced_write_count - before.coalesced_write_count));
+    HOST_CHECK(1U == (after.commit_count - before.commit_count));
+}
+
+/**
+ * @brief Builds the single copy layout: magic number, checksum of the last write and the data.
+ *        The checksum only covers the bytes of the last write, not the whole area.
+ */
+static void write_legacy_image(const uint8_t * p_ptr_data, uint32_t p_last_write_size)
+{
+    uint32_t sum = 0U;
+    uint16_t magic = LEGACY_MAGIC_NUMBER_VAL;
+    uint16_t checksum = 0U;
+    std::vector<uint8_t> & flash = eeprom_mock_flash();
+
+    for (uint32_t i = 0; i < p_last_write_size; i++)
+    {
+        sum += p_ptr_data[i];
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xFFFFU) + (sum >> 16);
+    }
+    checksum = (uint16_t)~sum;
+    flash.assign(DATA_START_ADRS + DATA_SIZE, 0U);
+    memcpy(&flash[LEGACY_MAGIC_NUMBER_ADRS], &magic, sizeof(magic));
+    memcpy(&flash[LEGACY_CHECKSUM_ADRS], &checksum, sizeof(checksum));
+    memcpy(&flash[DATA_START_ADRS], p_ptr_data, DATA_SIZE);
+}
+
+static void check_legacy_migration(uint32_t p_last_write_size)
+{
+    uint8_t data[DATA_SIZE];
+    uint8_t read_back[DATA_SIZE];
+
+    ardal_eeprom_deinit();
+    fill(data, DATA_SIZE, 0x11U);
+    write_legacy_image(data, p_last_write_size);
+    eeprom_mock_power_on();
+    HOST_CHECK(true == ardal_eeprom_init(DATA_SIZE));
+    HOST_CHECK(DATA_VALID == ardal_eeprom_read_data(read_back, DATA_SIZE, DATA_START_ADRS) &&
+               0 == memcmp(data, read_back, DATA_SIZE));
+    /* The migrated data survives a reset */
+    reboot();
+    HOST_CHECK(DATA_VALID == ardal_eeprom_read_data(read_back, DATA_SIZE, DATA_START_ADRS) &&
+               0 == memcmp(data, read_back, DATA_SIZE));
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    uint8_t first_data[DATA_SIZE];
+    uint8_t old_data[DATA_SIZE];
+    uint8_t new_data[DATA_SIZE];
+
+    debug_agents_init();
+    fill(first_data, DATA_SIZE, 0x33U);
+    fill(old_data, DATA_SIZE, 0x01U);
+    fill(new_data, DATA_SIZE, 0x80U);
+
+    /* Both slots hold valid data before the interrupted write, and neither holds the new data */
+    HOST_CHECK(true == ardal_eeprom_init(DATA_SIZE));
+    HOST_CHECK(true == write_data(first_data));
+    HOST_CHECK(true == write_data(old_data));
+    check_power_cuts(old_data, new_data);
+
+    check_one_commit_per_write();
+    check_coalesced_writes();
+    check_legacy_migration(DATA_SIZE);
+    check_legacy_migration(DATA_SIZE / 2U);
+
+    ardal_eeprom_deinit();
+    debug_agents_flush();
+    return host_test_report("eeprom_power_cut_test");
+}
@@ -0,0 +1,156 @@
+/***************************************************************************************************
+* File Name: eeprom_read_bench.cpp
+* Module: Tests/host
+* Abstract: Host benchmark of the HW_eeprom reads: time, bytes copied and bytes checksummed per read
+*           for copies, views, key-value reads and streams, taken from ardal_eeprom_get_stats().
+*           The first release copied each read twice and checksummed it once, the stats show what is left.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include "EEPROM.h"
+#include "HW_eeprom.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define DATA_SIZE (1024U)
+#define DATA_START_ADRS (EEPROM_DATA_START_ADRS)
+#define READ_SIZE (256U)
+#define KV_KEY (1U)
+#define KV_VALUE_SIZE (128U)
+#define STREAM_CHUNK_SIZE (32U)
+#define BENCH_READ_COUNT (200000U)
+
+/***************************************************************************************************
+* Local type definitions.
+***************************************************************************************************/
+
+typedef bool (*read_func_t)(void);
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static uint8_t s_buffer[DATA_SIZE];
+/* Sum of the read bytes, keeps the reads from being optimized out */
+static volatile uint32_t s_total = 0U;
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static bool read_copy(void)
+{
+    bool ret_val = (DATA_VALID == ardal_eeprom_read_data(s_buffer, READ_SIZE, DATA_START_ADRS));
+    s_total += s_buffer[READ_SIZE - 1U];
+    return ret_val;
+}
+
+static bool read_view(void)
+{
+    const uint8_t * data_ptr = ardal_eeprom_get_data_view(READ_SIZE, DATA_START_ADRS);
+    if (NULL != data_ptr)
+    {
+        s_total += data_ptr[READ_SIZE - 1U];
+    }
+    return (NULL != data_ptr);
+}
+
+static bool read_kv_copy(void)
+{
+    uint16_t data_size = 0U;
+    bool ret_val = (DATA_VALID == ardal_eeprom_kv_read(KV_KEY, s_buffer, sizeof(s_buffer), &data_size));
+    s_total += s_buffer[data_size - 1U];
+    return ret_val;
+}
+
+static bool read_kv_view(void)
+{
+    uint16_t data_size = 0U;
+    const uint8_t * data_ptr = ardal_eeprom_kv_get_view(KV_KEY, &data_size);
+    if (NULL != data_ptr)
+    {
+        s_total += data_ptr[data_size - 1U];
+        ardal_eeprom_kv_release_view(data_ptr);
+    }
+    return (NULL != data_ptr);
+}
+
+static bool read_kv_stream(void)
+{
+    eeprom_stream_t stream;
+    uint16_t read_size = 0U;
+    bool ret_val = (DATA_VALID == ardal_eeprom_stream_read_begin(&stream, KV_KEY));
+
+    while (true == ret_val && (read_size = ardal_eeprom_stream_read(&stream, s_buffer, STREAM_CHUNK_SIZE)) > 0U)
+    {
+        s_total += s_buffer[read_size - 1U];
+    }
+    return (true == ret_val && DATA_VALID == ardal_eeprom_stream_read_end(&stream));
+}
+
+/**
+ * @brief Runs the read BENCH_READ_COUNT times and prints the time and the stats deltas per read.
+ */
+static bool run_bench(const char * p_ptr_name, read_func_t p_read)
+{
+    eeprom_stats_t before;
+    eeprom_stats_t after;
+    bool ret_val = true;
+    std::chrono::steady_clock::time_point start;
+    double ns = 0.0;
+
+    ardal_eeprom_get_stats(&before);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_READ_COUNT && true == ret_val; i++)
+    {
+        ret_val = p_read();
+    }
+    ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    ardal_eeprom_get_stats(&after);
+
+    printf("%-22s %8.1f ns/read %8.1f bytes copied/read %8.2f bytes checksummed/read\n", p_ptr_name,
+           ns / BENCH_READ_COUNT,
+           (double)(after.bytes_copied - before.bytes_copied) / BENCH_READ_COUNT,
+           (double)(after.bytes_checksummed - before.bytes_checksummed) / BENCH_READ_COUNT);
+    return ret_val;
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    bool ret_val = true;
+
+    for (uint32_t i = 0; i < DATA_SIZE; i++)
+    {
+        s_buffer[i] = (uint8_t)i;
+    }
+    ret_val = ardal_eeprom_init(DATA_SIZE) &&
+              ardal_eeprom_write_data(s_buffer, DATA_SIZE, DATA_START_ADRS) &&
+              ardal_eeprom_kv_write(KV_KEY, s_buffer, KV_VALUE_SIZE);
+    /* A reset, the first read checks the data against its CRC again */
+    ardal_eeprom_deinit();
+    ret_val = ret_val && ardal_eeprom_init(DATA_SIZE);
+
+    printf("%u byte data reads, %u byte record reads\n", READ_SIZE, KV_VALUE_SIZE);
+    printf("first release: %u bytes copied and %u bytes checksummed per data read\n", 2U * READ_SIZE, READ_SIZE);
+    ret_val = ret_val && run_bench("ardal_eeprom_read_data", read_copy);
+    ret_val = ret_val && run_bench("data view", read_view);
+    ret_val = ret_val && run_bench("kv read", read_kv_copy);
+    ret_val = ret_val && run_bench("kv view", read_kv_view);
+    ret_val = ret_val && run_bench("kv stream", read_kv_stream);
+    ardal_eeprom_deinit();
+    return (true == ret_val) ? 0 : 1;
+}
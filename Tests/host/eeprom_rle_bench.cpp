@@ -0,0 +1,212 @@
+/***************************************************************************************************
+* File Name: eeprom_rle_bench.cpp
+* Module: Tests/host
+* Abstract: Host benchmark of the run length compressed key-value records on typical config shapes:
+*           compression ratio, write and read time with and without compression, and the commit
+*           time and the flash bytes changed per commit.
+*           Built with -DEEPROM_KV_AREA_SIZE=4096.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include "EEPROM.h"
+#include "HW_eeprom.h"
+#include "debug_logger.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define DATA_SIZE (64U)
+#define SHAPE_SIZE (256U)
+#define BENCH_COUNT (20000U)
+#define COMMIT_COUNT (2000U)
+/* Long enough that the background task never commits inside a timed loop */
+#define QUIET_PERIOD_MS (60000U)
+/* Byte changed between two commits, like a counter in the config */
+#define CHANGED_BYTE_OFFSET (8U)
+/* Size of a record header in the key-value area */
+#define KV_HEADER_SIZE (12U)
+
+/***************************************************************************************************
+* Local type definitions.
+***************************************************************************************************/
+
+typedef struct shape_t_struct
+{
+    const char * name;
+    uint8_t data[SHAPE_SIZE];
+} shape_t;
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static shape_t s_shapes[4];
+/* Key-value bytes used by the records of all shapes, headers included */
+static uint32_t s_raw_area_size = 0U;
+static uint32_t s_rle_area_size = 0U;
+static uint8_t s_buffer[SHAPE_SIZE];
+/* Sum of the read bytes, keeps the reads from being optimized out */
+static volatile uint32_t s_total = 0U;
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static double elapsed_ns(std::chrono::steady_clock::time_point p_start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - p_start).count();
+}
+
+/**
+ * @brief Fills the shapes: a config struct of mostly zeros, a calibration table with its unused
+ *        entries left erased, credentials padded with zeros, and random bytes that do not compress.
+ */
+static void build_shapes(void)
+{
+    std::mt19937 rng(5U);
+    uint16_t value = 0U;
+
+    memset(s_shapes, 0, sizeof(s_shapes));
+    s_shapes[0].name = "mostly zero config";
+    s_shapes[0].data[0] = 3U;
+    s_shapes[0].data[4] = 0x10U;
+    s_shapes[0].data[40] = 1U;
+    s_shapes[0].data[200] = 0xFFU;
+
+    s_shapes[1].name = "calibration table";
+    memset(s_shapes[1].data, 0xFF, SHAPE_SIZE);
+    for (uint32_t i = 0; i < (SHAPE_SIZE / 4U); i += 2U)
+    {
+        value = (uint16_t)(1000U + (37U * i));
+        memcpy(&s_shapes[1].data[i], &value, sizeof(value));
+    }
+
+    s_shapes[2].name = "credentials";
+    strcpy((char *)&s_shapes[2].data[0], "office-network-2g");
+    strcpy((char *)&s_shapes[2].data[64], "correct horse battery staple");
+    strcpy((char *)&s_shapes[2].data[128], "mqtt.example.com");
+
+    s_shapes[3].name = "random";
+    for (uint32_t i = 0; i < SHAPE_SIZE; i++)
+    {
+        s_shapes[3].data[i] = (uint8_t)rng();
+    }
+}
+
+static double time_writes(uint16_t p_key, const uint8_t * p_ptr_data, bool p_compress)
+{
+    bool ret_val = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_COUNT && true == ret_val; i++)
+    {
+        ret_val = (true == p_compress) ? ardal_eeprom_kv_write_compressed(p_key, p_ptr_data, SHAPE_SIZE) :
+                                         ardal_eeprom_kv_write(p_key, p_ptr_data, SHAPE_SIZE);
+    }
+    return (true == ret_val) ? elapsed_ns(start) / BENCH_COUNT : -1.0;
+}
+
+static double time_reads(uint16_t p_key)
+{
+    bool ret_val = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_COUNT && true == ret_val; i++)
+    {
+        ret_val = (DATA_VALID == ardal_eeprom_kv_read(p_key, s_buffer, sizeof(s_buffer), NULL));
+        s_total += s_buffer[SHAPE_SIZE - 1U];
+    }
+    return (true == ret_val) ? elapsed_ns(start) / BENCH_COUNT : -1.0;
+}
+
+/**
+ * @brief Changes one byte of the record before every commit, and prints the commit time and the flash
+ *        bytes the commit changed. The ESP32 EEPROM library rewrites its whole NVS blob on a commit,
+ *        so on the target the commit time follows the area size that compression lets shrink.
+ */
+static bool run_commits(const char * p_ptr_label, uint16_t p_key, const uint8_t * p_ptr_data, bool p_compress)
+{
+    uint8_t data[SHAPE_SIZE];
+    bool ret_val = true;
+    uint32_t written_count = eeprom_mock_written_count();
+    double ns = 0.0;
+    std::chrono::steady_clock::time_point start;
+
+    memcpy(data, p_ptr_data, SHAPE_SIZE);
+    for (uint32_t i = 0; i < COMMIT_COUNT && true == ret_val; i++)
+    {
+        data[CHANGED_BYTE_OFFSET] = (uint8_t)i;
+        ret_val = (true == p_compress) ? ardal_eeprom_kv_write_compressed(p_key, data, SHAPE_SIZE) :
+                                         ardal_eeprom_kv_write(p_key, data, SHAPE_SIZE);
+        start = std::chrono::steady_clock::now();
+        ret_val = ret_val && ardal_eeprom_flush();
+        ns += elapsed_ns(start);
+    }
+    printf("    commit %-10s %8.1f ns/commit %6.1f flash bytes changed/commit\n", p_ptr_label, ns / COMMIT_COUNT,
+           (double)(eeprom_mock_written_count() - written_count) / COMMIT_COUNT);
+    return ret_val;
+}
+
+static bool run_shape(uint16_t p_shape)
+{
+    const uint8_t * data_ptr = s_shapes[p_shape].data;
+    uint16_t raw_key = (uint16_t)(2U * p_shape);
+    uint16_t rle_key = (uint16_t)(raw_key + 1U);
+    eeprom_kv_info_t info;
+    double write_ns = time_writes(raw_key, data_ptr, false);
+    double write_rle_ns = time_writes(rle_key, data_ptr, true);
+    double read_ns = time_reads(raw_key);
+    double read_rle_ns = time_reads(rle_key);
+    bool ret_val = (write_ns >= 0.0 && write_rle_ns >= 0.0 && read_ns >= 0.0 && read_rle_ns >= 0.0 &&
+                    true == ardal_eeprom_kv_get_info(rle_key, &info) && true == ardal_eeprom_flush());
+
+    if (true == ret_val)
+    {
+        s_raw_area_size += KV_HEADER_SIZE + SHAPE_SIZE;
+        s_rle_area_size += KV_HEADER_SIZE + info.stored_size;
+        printf("%s: %u bytes stored as %u (%.0f %%)%s\n", s_shapes[p_shape].name, info.raw_size, info.stored_size,
+               (100.0 * info.stored_size) / info.raw_size, (true == info.is_compressed) ? "" : ", not compressed");
+        printf("    write      %8.1f ns raw %8.1f ns compressed\n", write_ns, write_rle_ns);
+        printf("    read       %8.1f ns raw %8.1f ns compressed\n", read_ns, read_rle_ns);
+        ret_val = run_commits("raw", raw_key, data_ptr, false) &&
+                  run_commits("compressed", rle_key, data_ptr, true);
+    }
+    return ret_val;
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    bool ret_val = true;
+
+    debug_agents_init();
+    build_shapes();
+    ret_val = ardal_eeprom_init(DATA_SIZE) && ardal_eeprom_set_async_commit(true, QUIET_PERIOD_MS);
+
+    printf("%u byte records, %u byte key-value area\n", SHAPE_SIZE, EEPROM_KV_AREA_SIZE);
+    for (uint16_t shape = 0U; shape < (sizeof(s_shapes) / sizeof(s_shapes[0])) && true == ret_val; shape++)
+    {
+        ret_val = run_shape(shape);
+    }
+    /* The mock commit only compares RAM, on the target the whole blob is rewritten */
+    printf("key-value bytes used by all shapes: %u raw, %u compressed\n", s_raw_area_size, s_rle_area_size);
+    printf("the EEPROM library rewrites its whole blob on a commit, so the commit time on the target scales\n"
+           "with the area, which compression lets shrink from %u to %u bytes for these records\n",
+           s_raw_area_size, s_rle_area_size);
+    ardal_eeprom_deinit();
+    debug_agents_flush();
+    return (true == ret_val) ? 0 : 1;
+}
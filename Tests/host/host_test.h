@@ -0,0 +1,73 @@
+/***************************************************************************************************
+* File Name: host_test.h
+* Module: Tests/host
+* Abstract: Checks shared by the host tests, a failed check is printed and counted and the test
+*           returns the failure count from main().
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+/* Only the first failures are printed, a broken routine would flood the output otherwise */
+#define HOST_TEST_MAX_PRINTED (20U)
+
+#define HOST_CHECK(p_cond) host_test_check((p_cond), #p_cond, __FILE__, __LINE__)
+
+/* Compares a produced string with the expected one, p_input describes the input in the message */
+#define HOST_CHECK_STR(p_got, p_expected, p_input) \
+    host_test_check_str((p_got), (p_expected), (p_input), __FILE__, __LINE__)
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+inline uint32_t & host_test_fail_count(void)
+{
+    static uint32_t s_fail_count = 0U;
+    return s_fail_count;
+}
+
+inline bool host_test_check(bool p_cond, const char * p_ptr_expr, const char * p_ptr_file, int p_line)
+{
+    if (false == p_cond && host_test_fail_count()++ < HOST_TEST_MAX_PRINTED)
+    {
+        printf("%s:%d: check failed: %s\n", p_ptr_file, p_line, p_ptr_expr);
+    }
+    return p_cond;
+}
+
+inline bool host_test_check_str(const char * p_ptr_got, const char * p_ptr_expected, const char * p_ptr_input,
+                                const char * p_ptr_file, int p_line)
+{
+    bool is_equal = (0 == strcmp(p_ptr_got, p_ptr_expected));
+    if (false == is_equal && host_test_fail_count()++ < HOST_TEST_MAX_PRINTED)
+    {
+        printf("%s:%d: %s: got \"%s\", expected \"%s\"\n", p_ptr_file, p_line, p_ptr_input, p_ptr_got, p_ptr_expected);
+    }
+    return is_equal;
+}
+
+/**
+ * @brief Prints the result of the test, the return value is meant for main().
+ */
+inline int host_test_report(const char * p_ptr_name)
+{
+    printf("%s: %u failed checks\n", p_ptr_name, host_test_fail_count());
+    return (0U == host_test_fail_count()) ? 0 : 1;
+}
+
+#endif /* HOST_TEST_H */
@@ -0,0 +1,168 @@
+/***************************************************************************************************
+* File Name: log_decoder_cases.cpp
+* Module: Tests/host
+* Abstract: Renders a set of log records with logger_format() and writes each record together with
+*           the produced text to the file given as first argument. log_decoder_test.py decodes the
+*           same records with Tools/log_decoder and compares both texts.
+*           One record per line: level, function name, format, arguments and text, tab separated.
+*           Strings are hex encoded, float arguments are written as their raw bits.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "debug_logger.h"
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static void write_hex(FILE * p_ptr_file, const char * p_ptr_text, uint32_t p_len)
+{
+    if (0U == p_len)
+    {
+        fputc('-', p_ptr_file);
+    }
+    for (uint32_t i = 0U; i < p_len; i++)
+    {
+        fprintf(p_ptr_file, "%02x", (uint8_t)p_ptr_text[i]);
+    }
+}
+
+static void write_case(FILE * p_ptr_file,
+                       debug_level_t p_level,
+                       const char * p_ptr_func,
+                       const char * p_ptr_msg,
+                       const log_arg_t * p_ptr_args,
+                       uint8_t p_arg_count)
+{
+    char line[LOG_TEXT_MAX_LEN];
+    uint16_t len = logger_format(line, sizeof(line), p_level, p_ptr_func, p_ptr_msg, p_ptr_args, p_arg_count);
+
+    fprintf(p_ptr_file, "%u\t", (unsigned)p_level);
+    write_hex(p_ptr_file, p_ptr_func, (NULL != p_ptr_func) ? strlen(p_ptr_func) : 0U);
+    fputc('\t', p_ptr_file);
+    write_hex(p_ptr_file, p_ptr_msg, strlen(p_ptr_msg));
+    fputc('\t', p_ptr_file);
+    for (uint8_t i = 0U; i < p_arg_count; i++)
+    {
+        const log_arg_t * arg_ptr = &p_ptr_args[i];
+        fprintf(p_ptr_file, (i > 0U) ? " %c:" : "%c:", arg_ptr->type);
+        switch (arg_ptr->type)
+        {
+        case LOG_ARG_INT32:
+            fprintf(p_ptr_file, "%d", (int)arg_ptr->value.i32);
+            break;
+        case LOG_ARG_UINT32:
+            fprintf(p_ptr_file, "%u", (unsigned)arg_ptr->value.u32);
+            break;
+        case LOG_ARG_INT64:
+            fprintf(p_ptr_file, "%lld", (long long)arg_ptr->value.i64);
+            break;
+        case LOG_ARG_UINT64:
+            fprintf(p_ptr_file, "%llu", (unsigned long long)arg_ptr->value.u64);
+            break;
+        default:
+        {
+            uint32_t bits = 0U;
+            memcpy(&bits, &arg_ptr->value.f32, sizeof(bits));
+            fprintf(p_ptr_file, "%08x", (unsigned)bits);
+            break;
+        }
+        }
+    }
+    fputc('\t', p_ptr_file);
+    write_hex(p_ptr_file, line, len);
+    fputc('\n', p_ptr_file);
+}
+
+static void write_float_case(FILE * p_ptr_file, const char * p_ptr_msg, float p_fnum)
+{
+    log_arg_t arg = log_arg_make(p_fnum);
+    write_case(p_ptr_file, DBG_LVL_INFO, NULL, p_ptr_msg, &arg, 1U);
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(int argc, char ** argv)
+{
+    const log_arg_t args[] = {log_arg_make(-5), log_arg_make(7U), log_arg_make((int64_t)-1), log_arg_make(2.5f)};
+    const log_arg_t wide_args[] = {log_arg_make(INT64_MIN), log_arg_make(UINT64_MAX), log_arg_make(INT32_MIN),
+                                   log_arg_make(UINT32_MAX)};
+    FILE * file_ptr = NULL;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <output file>\n", argv[0]);
+        return 2;
+    }
+    file_ptr = fopen(argv[1], "w");
+    if (NULL == file_ptr)
+    {
+        perror(argv[1]);
+        return 2;
+    }
+
+    /* Levels, function names and a leading newline */
+    write_case(file_ptr, DBG_LVL_ERR, "setup", "motor %d stalled\n", args, 1U);
+    write_case(file_ptr, DBG_LVL_WARN, NULL, "\nqueue %u full\n", &args[1], 1U);
+    write_case(file_ptr, DBG_LVL_PERIODIC, "loop", "tick\n", NULL, 0U);
+    write_case(file_ptr, DBG_LVL_INFO, "loop", "\n", NULL, 0U);
+    write_case(file_ptr, DBG_LVL_DEBUG, NULL, "%d %u %d %f\n", args, 4U);
+
+    /* Integer arguments of all widths */
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%d %d %d %d\n", wide_args, 4U);
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%x %x %x %x\n", wide_args, 4U);
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%x %x %x\n", args, 3U);
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%f %f %.0f %.2f\n", wide_args, 4U);
+
+    /* Float arguments of the integer conversions: truncated, clamped, nan and inf as text */
+    write_float_case(file_ptr, "%d\n", 3.7f);
+    write_float_case(file_ptr, "%d\n", -2.5f);
+    write_float_case(file_ptr, "%d\n", -0.5f);
+    write_float_case(file_ptr, "%d\n", 1e18f);
+    write_float_case(file_ptr, "%d\n", 1e30f);
+    write_float_case(file_ptr, "%d\n", -1e30f);
+    write_float_case(file_ptr, "%x\n", 1e30f);
+    write_float_case(file_ptr, "%x\n", -1e30f);
+    write_float_case(file_ptr, "%x\n", 5e9f);
+    write_float_case(file_ptr, "%x\n", -1.5f);
+    write_float_case(file_ptr, "%d\n", NAN);
+    write_float_case(file_ptr, "%x\n", -NAN);
+    write_float_case(file_ptr, "%d\n", INFINITY);
+    write_float_case(file_ptr, "%#08x\n", -INFINITY);
+    write_float_case(file_ptr, "%+d\n", NAN);
+
+    /* Float conversion: precision cap, negative zero and the scientific notation above 2^64 */
+    write_float_case(file_ptr, "%f\n", -0.0f);
+    write_float_case(file_ptr, "%.12f\n", 0.1f);
+    write_float_case(file_ptr, "%.9f\n", 3.14159265f);
+    write_float_case(file_ptr, "%f\n", 1e20f);
+    write_float_case(file_ptr, "%.1f\n", -3e38f);
+    write_float_case(file_ptr, "%f\n", 1.8e19f);
+    write_float_case(file_ptr, "%f\n", INFINITY);
+    write_float_case(file_ptr, "%08.3f\n", NAN);
+
+    /* Flags and width */
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%+5d|%-4d|%05d|%-05d\n", args, 4U);
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "% d|%#06x|%4x|%#x\n", args, 4U);
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%+8.2f|% 5d|%-+6d|%099d\n", &args[3], 1U);
+    write_float_case(file_ptr, "%99d\n", 1.0f);
+    write_float_case(file_ptr, "%-+10.1f|\n", -2.25f);
+
+    /* Text that is no specifier and missing arguments */
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "100%,%d %%d %\t%.f\n", args, 1U);
+    write_case(file_ptr, DBG_LVL_INFO, NULL, "%d %d %d\n", args, 2U);
+
+    fclose(file_ptr);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+File Name: log_decoder_test.py
+Module: Tests/host
+Abstract: Decodes the records written by log_decoder_cases with Tools/log_decoder and compares the
+          text with the one logger_format() produced on the device side for the same record.
+          Each record is packed into a binary record first, so the argument parsing is covered too.
+
+Usage:
+    log_decoder_test.py cases.txt
+"""
+
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "Tools", "log_decoder"))
+import log_decoder  # noqa: E402
+
+FMT_ADRS = 0x3F400000
+FUNC_ADRS = 0x3F410000
+# logger_format() renders no stamp, the one of the decoder is cut off before comparing
+STAMP = re.compile(r"^(\n?)\[\d+\.\d{6} \d+#\d+\] ")
+MAX_PRINTED = 20
+
+
+class DictStrings:
+    """Stands in for the ELF file, it knows the strings of the record being decoded."""
+
+    def __init__(self):
+        self.strings = {}
+
+    def get(self, address):
+        return self.strings.get(address)
+
+
+def unhex(text):
+    return "" if text == "-" else bytes.fromhex(text).decode("utf-8")
+
+
+def pack_record(level, sequence, func_name, args):
+    payload = bytearray()
+    for arg in args:
+        arg_type, value = arg.split(":")
+        if arg_type == "f":
+            raw = bytes.fromhex(value)[::-1]
+        else:
+            raw = struct.pack(log_decoder.ARG_FORMATS[arg_type], int(value))
+        payload += arg_type.encode() + raw
+    func_adrs = FUNC_ADRS if func_name else 0
+    header = struct.pack(log_decoder.LOG_BIN_HEADER_FORMAT, log_decoder.LOG_BIN_SYNC,
+                         log_decoder.LOG_BIN_HEADER_LEN + len(payload), level, len(args), 0, sequence,
+                         FMT_ADRS, func_adrs, sequence * 1000)
+    return header + payload
+
+
+def main():
+    strings = DictStrings()
+    fail_count = 0
+    with open(sys.argv[1], "r") as cases_file:
+        for sequence, line in enumerate(cases_file):
+            level, func_hex, fmt_hex, args_text, expected_hex = line.rstrip("\n").split("\t")
+            func_name = unhex(func_hex)
+            strings.strings = {FMT_ADRS: unhex(fmt_hex), FUNC_ADRS: func_name}
+            record = pack_record(int(level), sequence, func_name, args_text.split())
+            chunks = [record]
+            output = []
+            log_decoder.decode_stream(strings, lambda: chunks.pop() if chunks else b"", output.append)
+            got = STAMP.sub(r"\1", "".join(output), count=1)
+            expected = unhex(expected_hex)
+            if got != expected:
+                if fail_count < MAX_PRINTED:
+                    print("%r [%s]: got %r, expected %r" % (unhex(fmt_hex), args_text, got, expected))
+                fail_count += 1
+    # The timestamp has 64 bits, 83 minutes after boot is past 2^32 us
+    strings.strings = {FMT_ADRS: "late\n"}
+    got = log_decoder.render(strings, 3, 1, 7, FMT_ADRS, 0, 5000000001, [])
+    if not got.startswith("[5000.000001 1#7] "):
+        print("64-bit timestamp: got %r" % got)
+        fail_count += 1
+    print("log_decoder_test: %u failed checks" % fail_count)
+    return 0 if fail_count == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
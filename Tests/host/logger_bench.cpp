@@ -0,0 +1,256 @@
+/***************************************************************************************************
+* File Name: logger_bench.cpp
+* Module: Tests/host
+* Abstract: Host benchmark of logger_x(): nanoseconds and messages per second for each message
+*           shape and for calls filtered out at run time and at compile time, plus the time the
+*           drain task spends rendering each shape, next to the path of the first release: a memset of
+*           the 512-byte shared buffer and a render of the message with snprintf for the parameters.
+*           Build and run it with Tests/host/run_host_tests.sh bench.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include "debug_logger.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+/* Calls timed between two flushes, below LOG_QUEUE_DEPTH so no record is dropped */
+#define BENCH_BATCH_SIZE (LOG_QUEUE_DEPTH / 2U)
+#define BENCH_BATCH_COUNT (4000U)
+#define BENCH_RENDER_COUNT (200000U)
+/* Size of the shared message buffer of the first release, cleared on every call */
+#define FIRST_RELEASE_MSG_LEN (512U)
+#define FIRST_RELEASE_PARAM_COUNT (3U)
+#define BENCH_LONG_FUNC_NAME "a_very_long_function_name_that_is_printed_with_every_debug_message_of_the_logger"
+
+/***************************************************************************************************
+* Local type definitions.
+***************************************************************************************************/
+
+typedef void (*bench_call_t)(uint32_t p_idx);
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static char s_first_release_msg[FIRST_RELEASE_MSG_LEN];
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static double elapsed_ns(std::chrono::steady_clock::time_point p_start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - p_start).count();
+}
+
+/* Two messages in turn, so the duplicate collapsing does not kick in */
+static void call_no_params(uint32_t p_idx)
+{
+    if (0U == (p_idx & 1U))
+    {
+        logger_w("Sensor calibration done\n");
+    }
+    else
+    {
+        logger_w("Sensor calibration started\n");
+    }
+}
+
+static void call_one_int(uint32_t p_idx)
+{
+    logger_w("Sample %d stored\n", p_idx);
+}
+
+static void call_three_floats(uint32_t p_idx)
+{
+    logger_w("Accel x %f y %f z %f\n", (float)p_idx * 0.5f, 1.25f, -3.0f);
+}
+
+static void a_very_long_function_name_that_is_printed_with_every_debug_message_of_the_logger(uint32_t p_idx)
+{
+    logger_d("Long function name %d\n", p_idx);
+}
+
+static void call_filtered_at_run_time(uint32_t p_idx)
+{
+    logger_d("Filtered at run time %d %f\n", p_idx, 2.5f);
+}
+
+/* This module is built with LOG_LEVEL_WEB set to DBG_LVL_ERR, its debug calls compile to nothing */
+#undef DBG_MODULE
+#define DBG_MODULE LOG_MODULE_WEB
+static void call_filtered_at_compile_time(uint32_t p_idx)
+{
+    logger_d("Filtered at compile time %d %f\n", p_idx, 2.5f);
+}
+#undef DBG_MODULE
+#define DBG_MODULE LOG_MODULE_DEFAULT
+
+/**
+ * @brief Times the calls alone, the records are flushed between the batches outside the timed region.
+ *        Each call gets another index, so the duplicate collapsing does not kick in.
+ * @return The cost of one call in ns
+ */
+static double run_calls(bench_call_t p_call)
+{
+    double total_ns = 0.0;
+    std::chrono::steady_clock::time_point start;
+    uint32_t idx = 0U;
+
+    debug_agents_flush();
+    for (uint32_t batch = 0; batch < BENCH_BATCH_COUNT; batch++)
+    {
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_BATCH_SIZE; i++)
+        {
+            p_call(idx++);
+        }
+        total_ns += elapsed_ns(start);
+        debug_agents_flush();
+    }
+    return total_ns / idx;
+}
+
+/**
+ * @brief Times the rendering the drain task does for every sink in the text format.
+ * @return The cost of one rendered line in ns
+ */
+static double run_render(debug_level_t p_lvl, const char * p_ptr_func_name, const char * p_ptr_msg,
+                         const log_arg_t * p_ptr_args, uint8_t p_arg_count)
+{
+    char line[LOG_TEXT_MAX_LEN];
+    volatile uint32_t total_len = 0U;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_RENDER_COUNT; i++)
+    {
+        total_len += logger_format(line, sizeof(line), p_lvl, p_ptr_func_name, p_ptr_msg, p_ptr_args, p_arg_count);
+    }
+    return elapsed_ns(start) / BENCH_RENDER_COUNT;
+}
+
+/**
+ * @brief Renders the message like the first release did: the whole shared buffer is cleared, then the
+ *        level, the function name and the message are copied byte by byte, and every %d, %x or %f
+ *        takes the next of the three float parameters.
+ */
+static uint16_t first_release_render(debug_level_t p_lvl, const char * p_ptr_func_name, const char * p_ptr_msg,
+                                     const float * p_ptr_params)
+{
+    static const char * const log_strings[] = {
+        "", "\033[0;31m[ERROR]\033[0m\t", "\033[0;33m[ WARN]\033[0m\t", "\033[0;32m[ INFO]\033[0m\t",
+        "\033[0;35m[PRDIC]\033[0m\t", "\033[0;36m[DEBUG]\033[0m\t"
+    };
+    uint16_t bytes_written = 0U;
+    uint8_t param_count = 0U;
+
+    memset(s_first_release_msg, '\0', FIRST_RELEASE_MSG_LEN);
+    strcpy(s_first_release_msg, log_strings[p_lvl]);
+    bytes_written = (uint16_t)strlen(log_strings[p_lvl]);
+    if (NULL != p_ptr_func_name)
+    {
+        bytes_written += (uint16_t)snprintf(&s_first_release_msg[bytes_written], FIRST_RELEASE_MSG_LEN - bytes_written,
+                                            "\033[1m[FUNC: %s]\033[0m ->", p_ptr_func_name);
+    }
+    for (uint16_t i = 0; (i < FIRST_RELEASE_MSG_LEN) && (p_ptr_msg[i] != '\0'); i++)
+    {
+        if (p_ptr_msg[i] == '%' && param_count < FIRST_RELEASE_PARAM_COUNT)
+        {
+            switch (p_ptr_msg[++i])
+            {
+            case 'f':
+                bytes_written += (uint16_t)snprintf(&s_first_release_msg[bytes_written], FIRST_RELEASE_MSG_LEN - bytes_written,
+                                                    "%.3f", p_ptr_params[param_count]);
+                break;
+            case 'x':
+                bytes_written += (uint16_t)snprintf(&s_first_release_msg[bytes_written], FIRST_RELEASE_MSG_LEN - bytes_written,
+                                                    "%x", (int32_t)p_ptr_params[param_count]);
+                break;
+            default:
+                bytes_written += (uint16_t)snprintf(&s_first_release_msg[bytes_written], FIRST_RELEASE_MSG_LEN - bytes_written,
+                                                    "%d", (int32_t)p_ptr_params[param_count]);
+                break;
+            }
+            param_count++;
+        }
+        else
+        {
+            s_first_release_msg[bytes_written++] = p_ptr_msg[i];
+        }
+    }
+    return bytes_written;
+}
+
+/**
+ * @brief Times the first release path for one message.
+ * @return The cost of one message in ns
+ */
+static double run_first_release(debug_level_t p_lvl, const char * p_ptr_func_name, const char * p_ptr_msg,
+                                const float * p_ptr_params)
+{
+    volatile uint32_t total_len = 0U;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_RENDER_COUNT; i++)
+    {
+        total_len += first_release_render(p_lvl, p_ptr_func_name, p_ptr_msg, p_ptr_params);
+    }
+    return elapsed_ns(start) / BENCH_RENDER_COUNT;
+}
+
+static void print_result(const char * p_ptr_name, double p_call_ns, double p_render_ns, double p_first_release_ns)
+{
+    printf("%-26s %9.1f ns/msg %12.0f msg/s", p_ptr_name, p_call_ns, 1e9 / p_call_ns);
+    if (p_render_ns > 0.0)
+    {
+        printf(" %9.1f ns/msg rendered %9.1f ns/msg first release", p_render_ns, p_first_release_ns);
+    }
+    printf("\n");
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    logger_stats_t stats;
+    const log_arg_t int_args[1] = {log_arg_make(12345)};
+    const log_arg_t float_args[3] = {log_arg_make(0.5f), log_arg_make(1.25f), log_arg_make(-3.0f)};
+    const float int_params[FIRST_RELEASE_PARAM_COUNT] = {12345.0f, 0.0f, 0.0f};
+    const float float_params[FIRST_RELEASE_PARAM_COUNT] = {0.5f, 1.25f, -3.0f};
+
+    debug_agents_init();
+    print_result("no params", run_calls(call_no_params),
+                 run_render(DBG_LVL_WARN, NULL, "Sensor calibration done\n", NULL, 0U),
+                 run_first_release(DBG_LVL_WARN, NULL, "Sensor calibration done\n", int_params));
+    print_result("one int", run_calls(call_one_int),
+                 run_render(DBG_LVL_WARN, NULL, "Sample %d stored\n", int_args, 1U),
+                 run_first_release(DBG_LVL_WARN, NULL, "Sample %d stored\n", int_params));
+    print_result("three floats", run_calls(call_three_floats),
+                 run_render(DBG_LVL_WARN, NULL, "Accel x %f y %f z %f\n", float_args, 3U),
+                 run_first_release(DBG_LVL_WARN, NULL, "Accel x %f y %f z %f\n", float_params));
+    print_result("long function name",
+                 run_calls(a_very_long_function_name_that_is_printed_with_every_debug_message_of_the_logger),
+                 run_render(DBG_LVL_DEBUG, BENCH_LONG_FUNC_NAME, "Long function name %d\n", int_args, 1U),
+                 run_first_release(DBG_LVL_DEBUG, BENCH_LONG_FUNC_NAME, "Long function name %d\n", int_params));
+    debug_agents_set_threshold(DBG_LVL_ERR);
+    print_result("filtered at run time", run_calls(call_filtered_at_run_time), 0.0, 0.0);
+    print_result("filtered at compile time", run_calls(call_filtered_at_compile_time), 0.0, 0.0);
+    debug_agents_set_threshold(DBG_LVL_DEBUG);
+
+    debug_agents_get_stats(&stats);
+    printf("enqueued %u dropped %u suppressed %u repeated %u\n",
+           stats.enqueued_count, stats.dropped_count, stats.suppressed_count, stats.repeated_count);
+    return (0U == stats.dropped_count) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************************************
+* File Name: logger_crash_test.cpp
+* Module: Tests/host
+* Abstract: Checks that ERR and WARN messages reach the crash log even when the reset comes before
+*           the drain task ran, and that a drained message is not written to it twice.
+*           A second debug_agents_init() stands in for the reset, the ring is kept like in RTC memory.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include "debug_logger.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static uint32_t count_lines(const char * p_ptr_log, const char * p_ptr_line)
+{
+    uint32_t count = 0U;
+    for (const char * found_ptr = strstr(p_ptr_log, p_ptr_line); NULL != found_ptr;
+         found_ptr = strstr(found_ptr + 1, p_ptr_line))
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Simulates a reset and reads the log of the boot before it.
+ */
+static void reset_and_read(char * p_ptr_log, uint16_t p_log_size)
+{
+    uint16_t len = 0U;
+
+    debug_agents_init();
+    len = debug_agents_read_crash_log(p_ptr_log, p_log_size - 1U);
+    p_ptr_log[len] = '\0';
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    char crash_log[LOG_CRASH_BUFFER_SIZE + 1U];
+
+    debug_agents_init();
+
+    /* Drained before the reset: written once, by the producer */
+    logger_e("Drained error %d\n", 1);
+    logger_i("Drained info %d\n", 2);
+    debug_agents_flush();
+    reset_and_read(crash_log, sizeof(crash_log));
+    HOST_CHECK(1U == count_lines(crash_log, "Drained error 1"));
+    HOST_CHECK(1U == count_lines(crash_log, "Drained info 2"));
+
+    /* The reset comes right after the calls, the drain task had no chance to run */
+    logger_w("Watchdog is about to fire %d\n", 3);
+    logger_e("Last error %d\n", 4);
+    reset_and_read(crash_log, sizeof(crash_log));
+    HOST_CHECK(1U == count_lines(crash_log, "Watchdog is about to fire 3"));
+    HOST_CHECK(1U == count_lines(crash_log, "Last error 4"));
+
+    /* The records still queued at the reset are drained after it, the errors are not written a second time */
+    debug_agents_flush();
+    reset_and_read(crash_log, sizeof(crash_log));
+    HOST_CHECK(1U == count_lines(crash_log, "Last error 4"));
+    return host_test_report("logger_crash_test");
+}
@@ -0,0 +1,128 @@
+/***************************************************************************************************
+* File Name: logger_format_test.cpp
+* Module: Tests/host
+* Abstract: Checks the argument rendering of logger_format(), among others float arguments of the
+*           integer conversions: nan, inf and values out of the int64_t range, the specifier grammar
+*           and the segment tables the logger_x macros build at compile time.
+*           Built with -fsanitize=float-cast-overflow, which catches a float cast out of range.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <math.h>
+#include "debug_logger.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+/* A '%' that starts no specifier is text, it is neither counted nor given an argument */
+static_assert(log_fmt_count("100%,def %d") == 1U, "'%,' is not a specifier");
+static_assert(log_fmt_count("%\t%d%%,") == 1U, "'%\\t' and '%%' are not specifiers");
+static_assert(log_fmt_count("%-+ 0#12.3f %5d %.f %d") == 3U, "Flags, width and precision");
+static_assert(log_fmt_count("........................................................................"
+                            "........................................................................"
+                            "...........%d") == 1U, "Long literal runs");
+
+static constexpr log_fmt_table<3U> s_table("a%-4x|%.2f!\n", log_fmt_make_indices<3U>());
+static_assert((s_table.segments[0].literal_len == 1U) && (s_table.segments[0].spec_len == 4U) &&
+              (s_table.segments[0].conversion == 'x') && (s_table.segments[0].flags == LOG_FMT_FLAG_LEFT) &&
+              (s_table.segments[0].width == 4U) && (s_table.segments[0].precision == LOG_FMT_NO_PRECISION),
+              "First segment");
+static_assert((s_table.segments[1].literal_len == 1U) && (s_table.segments[1].spec_len == 4U) &&
+              (s_table.segments[1].conversion == 'f') && (s_table.segments[1].precision == 2U), "Second segment");
+static_assert((s_table.segments[2].literal_len == 2U) && (s_table.segments[2].conversion == '\0'), "Literal tail");
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+/**
+ * @brief Formats the message and compares the text after the level prefix with the expected one.
+ *        The message starts with '<', so the prefix ends before the first '<'.
+ */
+static void check_format(const char * p_ptr_msg, const log_arg_t * p_ptr_args, uint8_t p_arg_count,
+                         const char * p_ptr_expected)
+{
+    char line[LOG_TEXT_MAX_LEN];
+    uint16_t len = logger_format(line, sizeof(line) - 1U, DBG_LVL_INFO, NULL, p_ptr_msg, p_ptr_args, p_arg_count);
+    const char * body_ptr = NULL;
+
+    line[len] = '\0';
+    body_ptr = strchr(line, '<');
+    HOST_CHECK_STR((NULL != body_ptr) ? body_ptr : line, p_ptr_expected, p_ptr_msg);
+}
+
+/**
+ * @brief Logs through the macro, so the segment table of the call site renders the line,
+ *        and looks for it in the crash log, which ERR records reach at once. A second
+ *        debug_agents_init() stands in for the reset before the log is read.
+ */
+static void check_segments(void)
+{
+    char crash_log[LOG_CRASH_BUFFER_SIZE + 1U];
+    uint16_t len = 0U;
+
+    logger_e("\n<%+5d|%-4x|%#06x|%.2f|%d%%|100%,|%\t>\n", 3, 10U, 255U, 2.25f, 7);
+    debug_agents_init();
+    len = debug_agents_read_crash_log(crash_log, sizeof(crash_log) - 1U);
+    crash_log[len] = '\0';
+    HOST_CHECK(NULL != strstr(crash_log, "<   +3|a   |0x00ff|2.25|7%%|100%,|%\t>\n"));
+}
+
+static void check_float(const char * p_ptr_msg, float p_fnum, const char * p_ptr_expected)
+{
+    log_arg_t arg = log_arg_make(p_fnum);
+    check_format(p_ptr_msg, &arg, 1U, p_ptr_expected);
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    const log_arg_t args[] = {log_arg_make(-5), log_arg_make(7U), log_arg_make((int64_t)-1), log_arg_make(2.5f)};
+
+    check_format("<%d %d %d %f>\n", args, 4U, "<-5 7 -1 2.500>\n");
+    check_format("<%x %x>\n", args, 2U, "<fffffffb 7>\n");
+
+    /* Floats of the integer conversions are truncated */
+    check_float("<%d>\n", 3.7f, "<3>\n");
+    check_float("<%d>\n", -2.5f, "<-2>\n");
+    check_float("<%d>\n", 1e18f, "<999999984306749440>\n");
+    check_float("<%d>\n", 1e30f, "<9223372036854775807>\n");
+    check_float("<%d>\n", -1e30f, "<-9223372036854775808>\n");
+    check_float("<%d>\n", 9223372036854775808.0f, "<9223372036854775807>\n");
+    check_float("<%d>\n", -9223372036854775808.0f, "<-9223372036854775808>\n");
+    check_float("<%d>\n", NAN, "<nan>\n");
+    check_float("<%d>\n", INFINITY, "<inf>\n");
+    check_float("<%d>\n", -INFINITY, "<-inf>\n");
+    check_float("<%x>\n", NAN, "<nan>\n");
+    check_float("<%x>\n", 255.9f, "<ff>\n");
+    check_float("<%f>\n", INFINITY, "<inf>\n");
+
+    /* Flags, width and precision, rendered like Tools/log_decoder */
+    check_format("<%+5d|%-4d|%05d|%-05d>\n", args, 4U, "<   -5|7   |-0001|2    >\n");
+    check_format("<% d|%#06x|%4x|%#x>\n", args, 4U, "<-5|0x0007|ffffffffffffffff|0x2>\n");
+    check_float("<%.1f>\n", 2.3f, "<2.3>\n");
+    check_float("<%8.2f>\n", -2.5f, "<   -2.50>\n");
+    check_float("<%+.0f>\n", 3.0f, "<+3>\n");
+    check_float("<%.12f>\n", 0.5f, "<0.500000000>\n");
+    check_float("<%08.3f>\n", NAN, "<00000nan>\n");
+    check_float("<%99d>\n", 1.0f, "<                                                               1>\n");
+
+    /* Anything that is not a specifier is copied as it is */
+    check_format("<100%,%d>\n", args, 1U, "<100%,-5>\n");
+    check_format("<%\t%d %.f>\n", args, 1U, "<%\t-5 %.f>\n");
+
+    debug_agents_init();
+    check_segments();
+    debug_agents_flush();
+    return host_test_report("logger_format_test");
+}
@@ -0,0 +1,103 @@
+/***************************************************************************************************
+* File Name: logger_rate_test.cpp
+* Module: Tests/host
+* Abstract: Checks the rate limit of PERIODIC messages: a burst passes, the rest is suppressed and
+*           counted, and the count is logged when another call site takes over the table entry.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include "debug_logger.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define CAPTURE_BUF_SIZE (4096U)
+#define CALL_COUNT (LOG_RATE_BURST + 7U)
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static char s_capture[CAPTURE_BUF_SIZE];
+static uint32_t s_capture_len = 0U;
+
+/* The table is indexed by the format address, formats a multiple of the table size apart share an entry */
+static char s_formats[2][LOG_RATE_TABLE_SIZE * 4U] __attribute__((aligned(4)));
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static uint16_t capture_write(void * p_ptr_ctx, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    (void)p_ptr_ctx;
+    if ((s_capture_len + p_len) < CAPTURE_BUF_SIZE)
+    {
+        memcpy(&s_capture[s_capture_len], p_ptr_data, p_len);
+        s_capture_len += p_len;
+        s_capture[s_capture_len] = '\0';
+    }
+    return p_len;
+}
+
+static uint32_t count_lines(const char * p_ptr_line)
+{
+    uint32_t count = 0U;
+    for (const char * found_ptr = strstr(s_capture, p_ptr_line); NULL != found_ptr;
+         found_ptr = strstr(found_ptr + 1, p_ptr_line))
+    {
+        count++;
+    }
+    return count;
+}
+
+static void log_periodic(const char * p_ptr_msg, uint32_t p_value)
+{
+    log_arg_t arg = log_arg_make(p_value);
+    logger_write(DBG_LVL_PERIODIC, NULL, NULL, p_ptr_msg, &arg, 1U);
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    log_sink_t sink = {"capture", capture_write, NULL, DBG_LVL_DEBUG, LOG_FORMAT_PLAIN, 0U};
+    logger_stats_t stats;
+    char expected[64];
+    const char * evicted_ptr = NULL;
+    const char * next_ptr = NULL;
+
+    strcpy(s_formats[0], "rate a %d\n");
+    strcpy(s_formats[1], "rate b %d\n");
+    debug_agents_init();
+    HOST_CHECK(true == debug_agents_add_sink(&sink));
+
+    /* The arguments differ, so no call is collapsed as a repeat */
+    for (uint32_t i = 0U; i < CALL_COUNT; i++)
+    {
+        log_periodic(s_formats[0], i);
+    }
+    log_periodic(s_formats[1], 0U);
+    debug_agents_flush();
+
+    HOST_CHECK(LOG_RATE_BURST == count_lines("rate a "));
+    snprintf(expected, sizeof(expected), "%u messages suppressed\n", (unsigned)(CALL_COUNT - LOG_RATE_BURST));
+    HOST_CHECK(1U == count_lines(expected));
+    evicted_ptr = strstr(s_capture, expected);
+    next_ptr = strstr(s_capture, "rate b 0\n");
+    HOST_CHECK(NULL != evicted_ptr && NULL != next_ptr && evicted_ptr < next_ptr);
+    debug_agents_get_stats(&stats);
+    HOST_CHECK((CALL_COUNT - LOG_RATE_BURST) == stats.suppressed_count);
+
+    debug_agents_remove_sink(&sink);
+    return host_test_report("logger_rate_test");
+}
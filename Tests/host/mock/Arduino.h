@@ -0,0 +1,64 @@
+/***************************************************************************************************
+* File Name: Arduino.h
+* Module: Tests/host
+* Abstract: Host stand-in of <Arduino.h> for the modules that include it, e.g. HW_eeprom.
+*           The task and time calls come from debug_logger_host.h, the recursive mutexes are
+*           std::recursive_mutex.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+#ifndef HOST_MOCK_ARDUINO_H
+#define HOST_MOCK_ARDUINO_H
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <mutex>
+#include "debug_logger_host.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFU)
+
+/***************************************************************************************************
+* External type declarations.
+***************************************************************************************************/
+
+typedef std::recursive_mutex * SemaphoreHandle_t;
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+inline TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)millis();
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return new std::recursive_mutex();
+}
+
+/* Only portMAX_DELAY is used by the modules, the wait is not bounded */
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t p_mutex, TickType_t p_ticks)
+{
+    (void)p_ticks;
+    p_mutex->lock();
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t p_mutex)
+{
+    p_mutex->unlock();
+    return pdTRUE;
+}
+
+#endif /* HOST_MOCK_ARDUINO_H */
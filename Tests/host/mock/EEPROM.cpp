@@ -0,0 +1,146 @@
+/***************************************************************************************************
+* File Name: EEPROM.cpp
+* Module: Tests/host
+* Abstract: Implementation of "Tests/host/mock/EEPROM.h".
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <string.h>
+#include "EEPROM.h"
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static std::vector<uint8_t> s_flash;
+static int32_t s_cut_after = EEPROM_MOCK_NO_CUT;
+static bool s_is_power_cut = false;
+static uint32_t s_written_count = 0U;
+static uint32_t s_commit_count = 0U;
+
+/***************************************************************************************************
+* External data definitions.
+***************************************************************************************************/
+
+EEPROMClass EEPROM;
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+bool EEPROMClass::begin(size_t p_size)
+{
+    /* Like a new NVS blob, the bytes never written read as 0 */
+    if (s_flash.size() < p_size)
+    {
+        s_flash.resize(p_size, 0U);
+    }
+    m_data.assign(s_flash.begin(), s_flash.begin() + p_size);
+    return true;
+}
+
+void EEPROMClass::end(void)
+{
+    m_data.clear();
+}
+
+bool EEPROMClass::commit(void)
+{
+    bool ret_val = (false == s_is_power_cut);
+
+    for (size_t i = 0; i < m_data.size() && true == ret_val; i++)
+    {
+        if (s_flash[i] != m_data[i])
+        {
+            if (0 == s_cut_after)
+            {
+                s_is_power_cut = true;
+                ret_val = false;
+            }
+            else
+            {
+                s_flash[i] = m_data[i];
+                s_written_count++;
+                if (s_cut_after > 0)
+                {
+                    s_cut_after--;
+                }
+            }
+        }
+    }
+    if (true == ret_val)
+    {
+        s_commit_count++;
+    }
+    return ret_val;
+}
+
+uint16_t EEPROMClass::length(void)
+{
+    return (uint16_t)m_data.size();
+}
+
+uint8_t * EEPROMClass::getDataPtr(void)
+{
+    return m_data.data();
+}
+
+size_t EEPROMClass::readBytes(int p_adrs, void * p_ptr_value, size_t p_len)
+{
+    memcpy(p_ptr_value, &m_data.at(p_adrs), p_len);
+    return p_len;
+}
+
+size_t EEPROMClass::writeBytes(int p_adrs, const void * p_ptr_value, size_t p_len)
+{
+    memcpy(&m_data.at(p_adrs), p_ptr_value, p_len);
+    return p_len;
+}
+
+uint16_t EEPROMClass::readUShort(int p_adrs)
+{
+    uint16_t value = 0U;
+    readBytes(p_adrs, &value, sizeof(value));
+    return value;
+}
+
+size_t EEPROMClass::writeUShort(int p_adrs, uint16_t p_value)
+{
+    return writeBytes(p_adrs, &p_value, sizeof(p_value));
+}
+
+std::vector<uint8_t> & eeprom_mock_flash(void)
+{
+    return s_flash;
+}
+
+void eeprom_mock_cut_power_after(int32_t p_byte_count)
+{
+    s_cut_after = p_byte_count;
+}
+
+void eeprom_mock_power_on(void)
+{
+    s_is_power_cut = false;
+    s_cut_after = EEPROM_MOCK_NO_CUT;
+}
+
+bool eeprom_mock_is_power_cut(void)
+{
+    return s_is_power_cut;
+}
+
+uint32_t eeprom_mock_written_count(void)
+{
+    return s_written_count;
+}
+
+uint32_t eeprom_mock_commit_count(void)
+{
+    return s_commit_count;
+}
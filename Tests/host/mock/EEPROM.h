@@ -0,0 +1,88 @@
+/***************************************************************************************************
+* File Name: EEPROM.h
+* Module: Tests/host
+* Abstract: Host stand-in of the ESP32 EEPROM library: a RAM image and a flash image that commit()
+*           copies the RAM image to. A power cut can be injected after any byte of a commit, the
+*           flash then keeps the bytes written before the cut and the RAM image is lost.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+#ifndef HOST_MOCK_EEPROM_H
+#define HOST_MOCK_EEPROM_H
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+/* No power cut armed */
+#define EEPROM_MOCK_NO_CUT (-1)
+
+/***************************************************************************************************
+* External type declarations.
+***************************************************************************************************/
+
+class EEPROMClass
+{
+public:
+    bool begin(size_t p_size);
+    void end(void);
+    bool commit(void);
+    uint16_t length(void);
+    uint8_t * getDataPtr(void);
+    size_t readBytes(int p_adrs, void * p_ptr_value, size_t p_len);
+    size_t writeBytes(int p_adrs, const void * p_ptr_value, size_t p_len);
+    uint16_t readUShort(int p_adrs);
+    size_t writeUShort(int p_adrs, uint16_t p_value);
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+/***************************************************************************************************
+* External data declarations.
+***************************************************************************************************/
+
+extern EEPROMClass EEPROM;
+
+/***************************************************************************************************
+* External function declarations.
+***************************************************************************************************/
+
+/**
+ * @brief Content that survives a power cut, begin() loads it into the RAM image.
+ */
+std::vector<uint8_t> & eeprom_mock_flash(void);
+
+/**
+ * @brief Cuts the power once p_byte_count more bytes have been written to the flash, counted over
+ *        all later commits. A commit writes the changed bytes in address order. The commit that
+ *        is cut fails, and so does every commit until power on.
+ * 
+ * @param p_byte_count input: Bytes written before the cut, EEPROM_MOCK_NO_CUT to disarm.
+ */
+void eeprom_mock_cut_power_after(int32_t p_byte_count);
+
+/**
+ * @brief Restores the power after a cut, the RAM image is reloaded by the next begin().
+ */
+void eeprom_mock_power_on(void);
+
+bool eeprom_mock_is_power_cut(void);
+
+/**
+ * @brief Returns the number of bytes written to the flash so far, a commit only writes the changed bytes.
+ */
+uint32_t eeprom_mock_written_count(void);
+
+uint32_t eeprom_mock_commit_count(void);
+
+#endif /* HOST_MOCK_EEPROM_H */
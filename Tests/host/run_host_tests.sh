@@ -0,0 +1,96 @@
+#!/bin/sh
+# Builds and runs the host tests and benchmarks of Tests/host on Linux.
+# The tests are built with ASan and UBSan, the benchmarks with -O2.
+#
+# Usage: Tests/host/run_host_tests.sh [test|bench|all]   (default: all)
+# CXX and BUILD_DIR can be overridden from the environment.
+
+set -e
+
+ROOT_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+BUILD_DIR=${BUILD_DIR:-"$ROOT_DIR/_host_build"}
+CXX=${CXX:-g++}
+MODE=${1:-all}
+
+INCLUDES="-I$ROOT_DIR/Src/debug_logger -I$ROOT_DIR/Src/HW_comm -I$ROOT_DIR/Src/string_util -I$ROOT_DIR/Src/debug_trace"
+LOGGER_SRC="$ROOT_DIR/Src/debug_logger/debug_logger.cpp $ROOT_DIR/Src/string_util/string_util.cpp $ROOT_DIR/Src/debug_trace/debug_trace.cpp"
+STRING_SRC="$ROOT_DIR/Src/string_util/string_util.cpp"
+# HW_eeprom builds against the Arduino and EEPROM stand-ins of Tests/host/mock
+EEPROM_INCLUDES="-I$ROOT_DIR/Tests/host/mock -I$ROOT_DIR/Src/HW_eeprom"
+EEPROM_SRC="$ROOT_DIR/Src/HW_eeprom/HW_eeprom.cpp $ROOT_DIR/Tests/host/mock/EEPROM.cpp $LOGGER_SRC"
+DEFINES="-DDEBUG_EN -DUART_DEBUG=1 -DLOG_HOST_UART_STUB=1"
+
+TEST_FLAGS="-std=gnu++11 -O1 -g -fno-omit-frame-pointer -fsanitize=address,undefined -fno-sanitize-recover=undefined"
+BENCH_FLAGS="-std=gnu++11 -O2 -DNDEBUG"
+
+mkdir -p "$BUILD_DIR"
+
+# build <name> <flags> <sources...>
+build()
+{
+    name=$1
+    flags=$2
+    shift 2
+    echo "== build $name"
+    # shellcheck disable=SC2086
+    $CXX $flags -pthread $INCLUDES $DEFINES "$@" -o "$BUILD_DIR/$name"
+}
+
+run()
+{
+    echo "== run $1"
+    "$BUILD_DIR/$1"
+}
+
+run_tests()
+{
+    build string_itoa_test "$TEST_FLAGS" "$ROOT_DIR/Tests/host/string_itoa_test.cpp" $STRING_SRC
+    run string_itoa_test
+    build string_float_test "$TEST_FLAGS" "$ROOT_DIR/Tests/host/string_float_test.cpp" $STRING_SRC
+    run string_float_test
+    build logger_format_test "$TEST_FLAGS -fsanitize=float-cast-overflow" "$ROOT_DIR/Tests/host/logger_format_test.cpp" $LOGGER_SRC
+    run logger_format_test
+    build logger_crash_test "$TEST_FLAGS" "$ROOT_DIR/Tests/host/logger_crash_test.cpp" $LOGGER_SRC
+    run logger_crash_test
+    build logger_rate_test "$TEST_FLAGS" "$ROOT_DIR/Tests/host/logger_rate_test.cpp" $LOGGER_SRC
+    run logger_rate_test
+    build trace_dump_test "$TEST_FLAGS -DTRACE_EN" "$ROOT_DIR/Tests/host/trace_dump_test.cpp" $LOGGER_SRC
+    run trace_dump_test
+    # The decoder renders the records logger_format() rendered on the device side
+    build log_decoder_cases "$TEST_FLAGS" "$ROOT_DIR/Tests/host/log_decoder_cases.cpp" $LOGGER_SRC
+    "$BUILD_DIR/log_decoder_cases" "$BUILD_DIR/log_decoder_cases.txt"
+    echo "== run log_decoder_test"
+    python3 -B "$ROOT_DIR/Tests/host/log_decoder_test.py" "$BUILD_DIR/log_decoder_cases.txt"
+    build eeprom_power_cut_test "$TEST_FLAGS $EEPROM_INCLUDES" "$ROOT_DIR/Tests/host/eeprom_power_cut_test.cpp" $EEPROM_SRC
+    run eeprom_power_cut_test
+    build eeprom_config_test "$TEST_FLAGS $EEPROM_INCLUDES" "$ROOT_DIR/Tests/host/eeprom_config_test.cpp" $EEPROM_SRC
+    run eeprom_config_test
+    build eeprom_kv_stream_test "$TEST_FLAGS $EEPROM_INCLUDES -DEEPROM_KV_AREA_SIZE=4096 -DEEPROM_STREAM_TIMEOUT_MS=50" \
+        "$ROOT_DIR/Tests/host/eeprom_kv_stream_test.cpp" $EEPROM_SRC
+    run eeprom_kv_stream_test
+}
+
+run_benches()
+{
+    build logger_bench "$BENCH_FLAGS -DLOG_RATE_LIMIT_LEVEL=9 -DLOG_LEVEL_WEB=1" \
+        "$ROOT_DIR/Tests/host/logger_bench.cpp" $LOGGER_SRC
+    run logger_bench
+
+    # C++17 for std::to_chars, the sources under test stay C++11
+    build string_itoa_bench "$BENCH_FLAGS -std=gnu++17" "$ROOT_DIR/Tests/host/string_itoa_bench.cpp" $STRING_SRC
+    run string_itoa_bench
+    build string_float_bench "$BENCH_FLAGS" "$ROOT_DIR/Tests/host/string_float_bench.cpp" $STRING_SRC
+    run string_float_bench
+    build eeprom_read_bench "$BENCH_FLAGS $EEPROM_INCLUDES" "$ROOT_DIR/Tests/host/eeprom_read_bench.cpp" $EEPROM_SRC
+    run eeprom_read_bench
+    build eeprom_rle_bench "$BENCH_FLAGS $EEPROM_INCLUDES -DEEPROM_KV_AREA_SIZE=4096" \
+        "$ROOT_DIR/Tests/host/eeprom_rle_bench.cpp" $EEPROM_SRC
+    run eeprom_rle_bench
+}
+
+case "$MODE" in
+    test) run_tests ;;
+    bench) run_benches ;;
+    all) run_tests; run_benches ;;
+    *) echo "usage: $0 [test|bench|all]"; exit 2 ;;
+esac
@@ -0,0 +1,106 @@
+/***************************************************************************************************
+* File Name: string_float_bench.cpp
+* Module: Tests/host
+* Abstract: Host benchmark of the float formatters and the float parser of string_util against
+*           snprintf and strtof.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "string_util.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define BENCH_VALUE_COUNT (2000000U)
+#define TEXT_BUF_SIZE (64U)
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static std::vector<float> s_values;
+/* Texts of the values with 3 decimals, the input of the parsers */
+static std::vector<std::vector<char> > s_texts;
+static char s_text[TEXT_BUF_SIZE];
+/* Sum of the results, keeps the calls from being optimized out */
+static volatile float s_total = 0.0f;
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+template <typename F>
+static void run_bench(const char * p_ptr_name, F p_func)
+{
+    float total = 0.0f;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_VALUE_COUNT; i++)
+    {
+        total += p_func(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    s_total += total;
+    printf("%-28s %7.1f ns/value\n", p_ptr_name, ns / BENCH_VALUE_COUNT);
+}
+
+static float format_ftoa(uint32_t p_idx) { return (float)string_ftoa(s_values[p_idx], s_text, 3U); }
+static float format_dtoa(uint32_t p_idx) { return (float)string_dtoa((double)s_values[p_idx], s_text, 6U); }
+static float format_shortest(uint32_t p_idx) { return (float)string_ftoa_shortest(s_values[p_idx], s_text); }
+static float snprintf_3f(uint32_t p_idx) { return (float)snprintf(s_text, sizeof(s_text), "%.3f", s_values[p_idx]); }
+static float snprintf_6f(uint32_t p_idx) { return (float)snprintf(s_text, sizeof(s_text), "%.6f", s_values[p_idx]); }
+static float snprintf_9g(uint32_t p_idx) { return (float)snprintf(s_text, sizeof(s_text), "%.9g", s_values[p_idx]); }
+
+static float parse_float(uint32_t p_idx)
+{
+    float value = 0.0f;
+    string_parse_float(s_texts[p_idx].data(), (uint32_t)(s_texts[p_idx].size() - 1U), &value);
+    return value;
+}
+
+static float parse_strtof(uint32_t p_idx)
+{
+    return strtof(s_texts[p_idx].data(), NULL);
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    std::mt19937 rng(7U);
+    uint32_t len = 0U;
+
+    /* Sensor like values: -1000 to 1000 with a few decimals */
+    s_values.resize(BENCH_VALUE_COUNT);
+    s_texts.resize(BENCH_VALUE_COUNT);
+    for (uint32_t i = 0; i < BENCH_VALUE_COUNT; i++)
+    {
+        s_values[i] = (float)((int32_t)(rng() % 2000000U) - 1000000) / 997.0f;
+        len = string_ftoa(s_values[i], s_text, 3U);
+        s_texts[i].assign(s_text, s_text + len + 1U);
+    }
+
+    run_bench("string_ftoa %.3f", format_ftoa);
+    run_bench("snprintf %.3f", snprintf_3f);
+    run_bench("string_dtoa %.6f", format_dtoa);
+    run_bench("snprintf %.6f", snprintf_6f);
+    run_bench("string_ftoa_shortest", format_shortest);
+    run_bench("snprintf %.9g", snprintf_9g);
+    run_bench("string_parse_float", parse_float);
+    run_bench("strtof", parse_strtof);
+    return 0;
+}
@@ -0,0 +1,271 @@
+/***************************************************************************************************
+* File Name: string_float_test.cpp
+* Module: Tests/host
+* Abstract: Compares the float formatters of string_util with snprintf and the float parser with
+*           strtof, on the special values and on random values of every exponent.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <float.h>
+#include <math.h>
+#include <random>
+#include <stdlib.h>
+#include "host_test.h"
+#include "string_util.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define RANDOM_VALUE_COUNT (1000000U)
+#define TEXT_BUF_SIZE (512U)
+/* Magnitude from which string_dtoa() switches to the d.ddde+XX form */
+#define FIXED_FORM_LIMIT (18446744073709551616.0)
+/* Sign, 9 significant digits, the point and e-XX */
+#define SHORTEST_MAX_LEN (15U)
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static float float_from_bits(uint32_t p_bits)
+{
+    float value = 0.0f;
+    memcpy(&value, &p_bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Builds what printf prints for the value: %.Nf, or %.Ne from 2^64 on.
+ *        printf keeps the sign of a NaN, the formatters always print nan.
+ */
+static void expected_text(double p_num, uint32_t p_after_point, char * p_ptr_expected)
+{
+    if (isnan(p_num))
+    {
+        strcpy(p_ptr_expected, "nan");
+    }
+    else if (fabs(p_num) >= FIXED_FORM_LIMIT && !isinf(p_num))
+    {
+        snprintf(p_ptr_expected, TEXT_BUF_SIZE, "%.*e", (int)p_after_point, p_num);
+    }
+    else
+    {
+        snprintf(p_ptr_expected, TEXT_BUF_SIZE, "%.*f", (int)p_after_point, p_num);
+    }
+}
+
+static void check_dtoa(double p_num, uint32_t p_after_point)
+{
+    char got[TEXT_BUF_SIZE];
+    char expected[TEXT_BUF_SIZE];
+    char input[TEXT_BUF_SIZE];
+    uint32_t len = string_dtoa(p_num, got, p_after_point);
+
+    expected_text(p_num, p_after_point, expected);
+    snprintf(input, sizeof(input), "string_dtoa(%.17g, %u)", p_num, p_after_point);
+    HOST_CHECK_STR(got, expected, input);
+    HOST_CHECK(strlen(got) == len);
+}
+
+static void check_ftoa(float p_fnum, uint32_t p_after_point)
+{
+    char got[TEXT_BUF_SIZE];
+    char expected[TEXT_BUF_SIZE];
+    char input[TEXT_BUF_SIZE];
+    uint32_t len = string_ftoa(p_fnum, got, p_after_point);
+
+    expected_text(p_fnum, p_after_point, expected);
+    snprintf(input, sizeof(input), "string_ftoa(%.9g, %u)", p_fnum, p_after_point);
+    HOST_CHECK_STR(got, expected, input);
+    HOST_CHECK(strlen(got) == len);
+}
+
+/**
+ * @brief Significant digits of a formatted number, the zeros before the first and after the last
+ *        other digit are not counted.
+ */
+static uint32_t count_significant_digits(const char * p_ptr_text)
+{
+    uint32_t count = 0U;
+    uint32_t zeros = 0U;
+
+    for (; (*p_ptr_text != '\0') && (*p_ptr_text != 'e'); p_ptr_text++)
+    {
+        if (*p_ptr_text == '0')
+        {
+            zeros += (count > 0U) ? 1U : 0U;
+        }
+        else if ((*p_ptr_text >= '1') && (*p_ptr_text <= '9'))
+        {
+            count += zeros + 1U;
+            zeros = 0U;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Fewest significant digits printf rounds the float to so that it reads back.
+ */
+static uint32_t printf_shortest_digits(float p_fnum)
+{
+    char text[TEXT_BUF_SIZE];
+    uint32_t digits = 1U;
+
+    for (; digits < 9U; digits++)
+    {
+        snprintf(text, sizeof(text), "%.*e", (int)digits - 1, p_fnum);
+        if (strtof(text, NULL) == p_fnum)
+        {
+            break;
+        }
+    }
+    return digits;
+}
+
+/**
+ * @brief The shortest form must read back as the same float, and have no more significant digits
+ *        than the fewest printf needs. It may have fewer, printf only tries the nearest value.
+ */
+static void check_ftoa_shortest(float p_fnum)
+{
+    char got[TEXT_BUF_SIZE];
+    uint32_t len = string_ftoa_shortest(p_fnum, got);
+    float read_back = strtof(got, NULL);
+
+    if (false == HOST_CHECK(read_back == p_fnum || (isnan(read_back) && isnan(p_fnum))))
+    {
+        printf("string_ftoa_shortest(%.9g) gave \"%s\"\n", p_fnum, got);
+    }
+    if (isfinite(p_fnum) && (p_fnum != 0.0f) &&
+        (false == HOST_CHECK(count_significant_digits(got) <= printf_shortest_digits(p_fnum))))
+    {
+        printf("string_ftoa_shortest(%.9g) gave \"%s\", not the fewest digits\n", p_fnum, got);
+    }
+    HOST_CHECK(strlen(got) == len && len <= SHORTEST_MAX_LEN);
+}
+
+/**
+ * @brief Parses the text with string_parse_float() and strtof(), the results must be equal.
+ */
+static void check_parse_float(const char * p_ptr_str)
+{
+    float expected = strtof(p_ptr_str, NULL);
+    float got = 0.0f;
+    string_parse_status_t status = string_parse_float(p_ptr_str, (uint32_t)strlen(p_ptr_str), &got);
+
+    if (isinf(expected))
+    {
+        HOST_CHECK(STRING_PARSE_OVERFLOW == status);
+    }
+    else if (false == HOST_CHECK(STRING_PARSE_OK == status && got == expected))
+    {
+        printf("string_parse_float(\"%s\") gave %.9g, strtof %.9g\n", p_ptr_str, got, expected);
+    }
+}
+
+static void check_special_values(void)
+{
+    const double values[] = {
+        0.0, -0.0, 0.5, 1.5, 2.5, -0.5, -0.25, 0.125, 1.005, 2147483648.0, 4294967296.5, -1e-9,
+        9.9999999999, 0.99999999995, 1e19, 1.8e19, 1.9e19, 1e20, -3.4e38, 9.9999e30, 123456.789,
+        NAN, -NAN, INFINITY, -INFINITY
+    };
+    char got[TEXT_BUF_SIZE];
+
+    for (uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        for (uint32_t after_point = 0; after_point <= STRING_FTOA_MAX_DECIMALS; after_point++)
+        {
+            check_dtoa(values[i], after_point);
+            check_ftoa((float)values[i], after_point);
+        }
+        check_ftoa_shortest((float)values[i]);
+    }
+    string_ftoa_shortest(0.1f, got);
+    HOST_CHECK_STR(got, "0.1", "string_ftoa_shortest(0.1f)");
+    string_ftoa_shortest(-2.5f, got);
+    HOST_CHECK_STR(got, "-2.5", "string_ftoa_shortest(-2.5f)");
+    string_ftoa_shortest(1e-40f, got);
+    HOST_CHECK_STR(got, "1e-40", "string_ftoa_shortest(1e-40f)");
+    string_ftoa_shortest(3.4e38f, got);
+    HOST_CHECK_STR(got, "3.4e+38", "string_ftoa_shortest(3.4e38f)");
+    string_ftoa_shortest(-0.0f, got);
+    HOST_CHECK_STR(got, "-0", "string_ftoa_shortest(-0.0f)");
+    string_ftoa_shortest(16777216.0f, got);
+    HOST_CHECK_STR(got, "16777216", "string_ftoa_shortest(16777216.0f)");
+    string_ftoa_shortest(1e10f, got);
+    HOST_CHECK_STR(got, "1e+10", "string_ftoa_shortest(1e10f)");
+    string_ftoa_shortest(0.0125f, got);
+    HOST_CHECK_STR(got, "0.0125", "string_ftoa_shortest(0.0125f)");
+    string_ftoa_shortest(FLT_MAX, got);
+    HOST_CHECK_STR(got, "3.4028235e+38", "string_ftoa_shortest(FLT_MAX)");
+    string_ftoa_shortest(-FLT_MIN, got);
+    HOST_CHECK_STR(got, "-1.1754944e-38", "string_ftoa_shortest(-FLT_MIN)");
+    string_ftoa_shortest(float_from_bits(1U), got);
+    HOST_CHECK_STR(got, "1e-45", "string_ftoa_shortest(smallest subnormal)");
+    /* A power of 2, the gap to the next lower float is half the gap above */
+    string_ftoa_shortest(1.0f, got);
+    HOST_CHECK_STR(got, "1", "string_ftoa_shortest(1.0f)");
+}
+
+static void check_parse_edges(void)
+{
+    float value = 0.0f;
+
+    check_parse_float("-12.5");
+    check_parse_float(".5");
+    check_parse_float("5.");
+    check_parse_float("1e-3");
+    check_parse_float("340282346638528859811704183484516925440");
+    check_parse_float("1e-50");
+    HOST_CHECK(STRING_PARSE_EMPTY == string_parse_float(".", 1U, &value));
+    HOST_CHECK(STRING_PARSE_INVALID == string_parse_float("1e+", 3U, &value));
+    HOST_CHECK(STRING_PARSE_INVALID == string_parse_float("nan", 3U, &value));
+    HOST_CHECK(STRING_PARSE_OVERFLOW == string_parse_float("1e39", 4U, &value));
+    HOST_CHECK(STRING_PARSE_OK == string_parse_float("-0", 2U, &value) && 0.0f == value && signbit(value));
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    std::mt19937_64 rng(7U);
+    char text[TEXT_BUF_SIZE];
+    float fnum = 0.0f;
+    double num = 0.0;
+
+    check_special_values();
+    check_parse_edges();
+    for (uint32_t i = 0; i < RANDOM_VALUE_COUNT; i++)
+    {
+        /* Every float bit pattern is equally likely, NaNs and infinities included */
+        fnum = float_from_bits((uint32_t)rng());
+        check_ftoa(fnum, (uint32_t)(rng() % (STRING_FTOA_MAX_DECIMALS + 1U)));
+        check_ftoa_shortest(fnum);
+
+        /* Doubles from 2^-113 to 2^90, with ties at the rounding digit */
+        num = ldexp((double)(rng() >> 11U), (int)(rng() % 204U) - 166);
+        num = (0U != (rng() & 1U)) ? -num : num;
+        check_dtoa(num, (uint32_t)(rng() % (STRING_FTOA_MAX_DECIMALS + 1U)));
+        check_dtoa((double)(rng() % 100000U) / 1024.0, (uint32_t)(rng() % (STRING_FTOA_MAX_DECIMALS + 1U)));
+
+        if (isfinite(fnum))
+        {
+            snprintf(text, sizeof(text), "%.*g", (int)(rng() % 12U) + 1, fnum);
+            check_parse_float(text);
+        }
+        snprintf(text, sizeof(text), "%s%u.%u", (0U != (rng() & 1U)) ? "-" : "",
+                 (uint32_t)(rng() % 100000U), (uint32_t)(rng() % 1000000U));
+        check_parse_float(text);
+    }
+    return host_test_report("string_float_test");
+}
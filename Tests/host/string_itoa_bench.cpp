@@ -0,0 +1,116 @@
+/***************************************************************************************************
+* File Name: string_itoa_bench.cpp
+* Module: Tests/host
+* Abstract: Host benchmark of the integer formatters of string_util against snprintf, and against
+*           std::to_chars when built as C++17.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <chrono>
+#include <inttypes.h>
+#include <random>
+#include <stdio.h>
+#include <vector>
+#include "string_util.h"
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define BENCH_VALUE_COUNT (4000000U)
+#define TEXT_BUF_SIZE (32U)
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static std::vector<uint32_t> s_values_32;
+static std::vector<uint64_t> s_values_64;
+static char s_text[TEXT_BUF_SIZE];
+/* Sum of the produced lengths, keeps the calls from being optimized out */
+static volatile uint32_t s_total_len = 0U;
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+/**
+ * @brief Runs p_format over all values and prints the time per value.
+ */
+template <typename T, typename F>
+static void run_bench(const char * p_ptr_name, const std::vector<T> & p_values, F p_format)
+{
+    uint32_t total_len = 0U;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < p_values.size(); i++)
+    {
+        total_len += p_format(p_values[i]);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    s_total_len += total_len;
+    printf("%-28s %7.2f ns/value\n", p_ptr_name, ns / p_values.size());
+}
+
+static uint32_t format_u32(uint32_t p_num) { return string_u32toa(p_num, s_text); }
+static uint32_t format_i32(uint32_t p_num) { return string_i32toa((int32_t)p_num, s_text); }
+static uint32_t format_hex32(uint32_t p_num) { return string_hex32toa(p_num, s_text); }
+static uint32_t format_itoa(uint32_t p_num) { return string_itoa((int32_t)p_num, s_text, 0U, BASE_10); }
+static uint32_t format_u64(uint64_t p_num) { return string_u64toa(p_num, s_text); }
+static uint32_t format_hex64(uint64_t p_num) { return string_hex64toa(p_num, s_text); }
+
+static uint32_t snprintf_u32(uint32_t p_num) { return (uint32_t)snprintf(s_text, sizeof(s_text), "%" PRIu32, p_num); }
+static uint32_t snprintf_i32(uint32_t p_num) { return (uint32_t)snprintf(s_text, sizeof(s_text), "%" PRId32, (int32_t)p_num); }
+static uint32_t snprintf_hex32(uint32_t p_num) { return (uint32_t)snprintf(s_text, sizeof(s_text), "%" PRIx32, p_num); }
+static uint32_t snprintf_u64(uint64_t p_num) { return (uint32_t)snprintf(s_text, sizeof(s_text), "%" PRIu64, p_num); }
+static uint32_t snprintf_hex64(uint64_t p_num) { return (uint32_t)snprintf(s_text, sizeof(s_text), "%" PRIx64, p_num); }
+
+#if __cplusplus >= 201703L
+static uint32_t to_chars_u32(uint32_t p_num) { return (uint32_t)(std::to_chars(s_text, s_text + sizeof(s_text), p_num).ptr - s_text); }
+static uint32_t to_chars_hex32(uint32_t p_num) { return (uint32_t)(std::to_chars(s_text, s_text + sizeof(s_text), p_num, 16).ptr - s_text); }
+static uint32_t to_chars_u64(uint64_t p_num) { return (uint32_t)(std::to_chars(s_text, s_text + sizeof(s_text), p_num).ptr - s_text); }
+#endif
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    std::mt19937_64 rng(2U);
+
+    /* The values are spread over every digit count, like counters and IDs in log messages */
+    s_values_32.resize(BENCH_VALUE_COUNT);
+    s_values_64.resize(BENCH_VALUE_COUNT);
+    for (uint32_t i = 0; i < BENCH_VALUE_COUNT; i++)
+    {
+        s_values_32[i] = (uint32_t)(rng() >> (32U + (rng() % 32U)));
+        s_values_64[i] = rng() >> (rng() % 64U);
+    }
+
+    run_bench("u32 string_u32toa", s_values_32, format_u32);
+    run_bench("u32 string_itoa", s_values_32, format_itoa);
+    run_bench("u32 snprintf", s_values_32, snprintf_u32);
+    run_bench("i32 string_i32toa", s_values_32, format_i32);
+    run_bench("i32 snprintf", s_values_32, snprintf_i32);
+    run_bench("hex32 string_hex32toa", s_values_32, format_hex32);
+    run_bench("hex32 snprintf", s_values_32, snprintf_hex32);
+    run_bench("u64 string_u64toa", s_values_64, format_u64);
+    run_bench("u64 snprintf", s_values_64, snprintf_u64);
+    run_bench("hex64 string_hex64toa", s_values_64, format_hex64);
+    run_bench("hex64 snprintf", s_values_64, snprintf_hex64);
+#if __cplusplus >= 201703L
+    run_bench("u32 std::to_chars", s_values_32, to_chars_u32);
+    run_bench("hex32 std::to_chars", s_values_32, to_chars_hex32);
+    run_bench("u64 std::to_chars", s_values_64, to_chars_u64);
+#endif
+    return 0;
+}
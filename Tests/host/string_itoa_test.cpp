@@ -0,0 +1,152 @@
+/***************************************************************************************************
+* File Name: string_itoa_test.cpp
+* Module: Tests/host
+* Abstract: Compares the integer formatters of string_util with snprintf, on the edge values and
+*           on random values spread over every magnitude.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <inttypes.h>
+#include <limits.h>
+#include <random>
+#include "host_test.h"
+#include "string_util.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define RANDOM_VALUE_COUNT (1000000U)
+#define TEXT_BUF_SIZE (64U)
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static void check_text(const char * p_ptr_got, uint32_t p_len, const char * p_ptr_expected, const char * p_ptr_input)
+{
+    HOST_CHECK_STR(p_ptr_got, p_ptr_expected, p_ptr_input);
+    HOST_CHECK(strlen(p_ptr_expected) == p_len);
+}
+
+/**
+ * @brief Formats p_num with every formatter and compares the text and the returned length with snprintf.
+ */
+static void check_value(uint64_t p_num)
+{
+    char got[TEXT_BUF_SIZE];
+    char expected[TEXT_BUF_SIZE];
+    char input[TEXT_BUF_SIZE];
+    uint32_t len = 0U;
+
+    snprintf(input, sizeof(input), "0x%" PRIx64, p_num);
+
+    len = string_u64toa(p_num, got);
+    snprintf(expected, sizeof(expected), "%" PRIu64, p_num);
+    check_text(got, len, expected, input);
+
+    len = string_i64toa((int64_t)p_num, got);
+    snprintf(expected, sizeof(expected), "%" PRId64, (int64_t)p_num);
+    check_text(got, len, expected, input);
+
+    len = string_hex64toa(p_num, got);
+    snprintf(expected, sizeof(expected), "%" PRIx64, p_num);
+    check_text(got, len, expected, input);
+
+    len = string_u32toa((uint32_t)p_num, got);
+    snprintf(expected, sizeof(expected), "%" PRIu32, (uint32_t)p_num);
+    check_text(got, len, expected, input);
+
+    len = string_i32toa((int32_t)p_num, got);
+    snprintf(expected, sizeof(expected), "%" PRId32, (int32_t)p_num);
+    check_text(got, len, expected, input);
+
+    len = string_hex32toa((uint32_t)p_num, got);
+    snprintf(expected, sizeof(expected), "%" PRIx32, (uint32_t)p_num);
+    check_text(got, len, expected, input);
+
+    len = string_itoa((int32_t)p_num, got, 0U, BASE_10);
+    snprintf(expected, sizeof(expected), "%" PRId32, (int32_t)p_num);
+    check_text(got, len, expected, input);
+}
+
+/**
+ * @brief Checks the powers of 10 and 2 and their neighbours, where the digit count changes.
+ */
+static void check_digit_count_edges(void)
+{
+    uint64_t power = 1U;
+
+    check_value(0U);
+    check_value(UINT64_MAX);
+    check_value((uint64_t)INT64_MIN);
+    check_value((uint64_t)INT64_MAX);
+    check_value((uint64_t)(int64_t)INT32_MIN);
+    check_value(UINT32_MAX);
+    for (uint32_t i = 0; i < 20U; i++)
+    {
+        check_value(power - 1U);
+        check_value(power);
+        check_value(power + 1U);
+        check_value((uint64_t)0U - power);
+        power *= 10U;
+    }
+    for (uint32_t shift = 0; shift < 64U; shift++)
+    {
+        check_value(((uint64_t)1U << shift) - 1U);
+        check_value((uint64_t)1U << shift);
+    }
+}
+
+/**
+ * @brief Checks the minimum digit count and base of string_itoa().
+ */
+static void check_itoa_options(void)
+{
+    char got[TEXT_BUF_SIZE];
+
+    string_itoa(INT32_MIN, got, 0U, BASE_10);
+    HOST_CHECK_STR(got, "-2147483648", "INT32_MIN base 10");
+    string_itoa(INT32_MIN, got, 0U, BASE_16);
+    HOST_CHECK_STR(got, "-80000000", "INT32_MIN base 16");
+    string_itoa(-255, got, 0U, BASE_16);
+    HOST_CHECK_STR(got, "-ff", "-255 base 16");
+    string_itoa(0, got, 3U, BASE_10);
+    HOST_CHECK_STR(got, "000", "0 with 3 digits");
+    string_itoa(-5, got, 4U, BASE_10);
+    HOST_CHECK_STR(got, "-0005", "-5 with 4 digits");
+    string_itoa(123456, got, 2U, BASE_10);
+    HOST_CHECK_STR(got, "123456", "123456 with 2 digits");
+}
+
+static void check_constexpr_formatters(void)
+{
+    HOST_CHECK_STR(string_u32toa_c<4294967295U>().c_str(), "4294967295", "string_u32toa_c");
+    HOST_CHECK_STR(string_i32toa_c<-2147483647 - 1>().c_str(), "-2147483648", "string_i32toa_c");
+    HOST_CHECK_STR(string_hex32toa_c<0xdeadbeefU>().c_str(), "deadbeef", "string_hex32toa_c");
+    HOST_CHECK_STR(string_u32toa_c<0U>().c_str(), "0", "string_u32toa_c 0");
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    std::mt19937_64 rng(1U);
+
+    check_digit_count_edges();
+    check_itoa_options();
+    check_constexpr_formatters();
+    /* The shift spreads the values over every digit count, not only the 19 and 20 digit ones */
+    for (uint32_t i = 0; i < RANDOM_VALUE_COUNT; i++)
+    {
+        check_value(rng() >> (rng() % 64U));
+    }
+    return host_test_report("string_itoa_test");
+}
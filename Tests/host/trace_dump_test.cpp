@@ -0,0 +1,295 @@
+/***************************************************************************************************
+* File Name: trace_dump_test.cpp
+* Module: Tests/host
+* Abstract: Records spans and instant events on two threads at once, dumps them and checks the JSON:
+*           that it is valid, that every event is there once and in the order of its thread, and that
+*           each instant lies inside the span around it. Then checks that a full ring keeps the newest
+*           events and that nothing is recorded while the trace is paused.
+*           Built with -DTRACE_EN.
+* Author: Naim ALMASRI
+* Date: 19.10.2026
+***************************************************************************************************/
+
+/***************************************************************************************************
+* Header files.
+***************************************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include "debug_trace.h"
+#include "host_test.h"
+
+/***************************************************************************************************
+* Macro definitions.
+***************************************************************************************************/
+
+#define THREAD_EVENT_COUNT (60U)
+#define JSON_BUF_SIZE (65536U)
+#define NAME_MAX_LEN (64U)
+
+/***************************************************************************************************
+* Local type definitions.
+***************************************************************************************************/
+
+typedef struct trace_json_event_t_struct
+{
+    char name[NAME_MAX_LEN];
+    char phase;
+    uint32_t ts;
+    uint32_t value;     /* Duration of a span, value of an instant */
+    uint32_t tid;
+} trace_json_event_t;
+
+/***************************************************************************************************
+* Local data definitions.
+***************************************************************************************************/
+
+static char s_json[JSON_BUF_SIZE];
+static uint32_t s_json_len = 0U;
+static trace_json_event_t s_events[TRACE_RING_DEPTH + 1U];
+static uint32_t s_event_count = 0U;
+static std::atomic<bool> s_is_started(false);
+
+/***************************************************************************************************
+* Local function definitions.
+***************************************************************************************************/
+
+static uint16_t json_sink_write(void * p_ptr_ctx, const uint8_t * p_ptr_data, uint16_t p_len)
+{
+    (void)p_ptr_ctx;
+    if ((s_json_len + p_len) < JSON_BUF_SIZE)
+    {
+        memcpy(&s_json[s_json_len], p_ptr_data, p_len);
+        s_json_len += p_len;
+        s_json[s_json_len] = '\0';
+    }
+    return p_len;
+}
+
+static const char * json_skip_space(const char * p_ptr_text)
+{
+    while ((*p_ptr_text == ' ') || (*p_ptr_text == '\n') || (*p_ptr_text == '\r') || (*p_ptr_text == '\t'))
+    {
+        p_ptr_text++;
+    }
+    return p_ptr_text;
+}
+
+static const char * json_parse_string(const char * p_ptr_text)
+{
+    for (p_ptr_text++; *p_ptr_text != '"'; p_ptr_text++)
+    {
+        if ((uint8_t)*p_ptr_text < 0x20U)
+        {
+            return NULL;
+        }
+        if ((*p_ptr_text == '\\') && (*++p_ptr_text == '\0'))
+        {
+            return NULL;
+        }
+    }
+    return p_ptr_text + 1;
+}
+
+static const char * json_parse_number(const char * p_ptr_text)
+{
+    const char * start_ptr = NULL;
+
+    if (*p_ptr_text == '-')
+    {
+        p_ptr_text++;
+    }
+    start_ptr = p_ptr_text;
+    while ((*p_ptr_text >= '0') && (*p_ptr_text <= '9'))
+    {
+        p_ptr_text++;
+    }
+    /* Only integers are written, a leading zero is only allowed alone */
+    if ((p_ptr_text == start_ptr) || ((*start_ptr == '0') && (p_ptr_text - start_ptr) > 1))
+    {
+        return NULL;
+    }
+    return p_ptr_text;
+}
+
+/**
+ * @brief Parses one JSON value, returns the text after it or NULL if it is not valid.
+ */
+static const char * json_parse_value(const char * p_ptr_text)
+{
+    bool is_object = false;
+    char close = '\0';
+
+    p_ptr_text = json_skip_space(p_ptr_text);
+    if (*p_ptr_text == '"')
+    {
+        return json_parse_string(p_ptr_text);
+    }
+    if ((*p_ptr_text != '{') && (*p_ptr_text != '['))
+    {
+        return json_parse_number(p_ptr_text);
+    }
+
+    is_object = (*p_ptr_text == '{');
+    close = (true == is_object) ? '}' : ']';
+    p_ptr_text = json_skip_space(p_ptr_text + 1);
+    if (*p_ptr_text == close)
+    {
+        return p_ptr_text + 1;
+    }
+    while (NULL != p_ptr_text)
+    {
+        if (true == is_object)
+        {
+            p_ptr_text = json_skip_space(p_ptr_text);
+            p_ptr_text = (*p_ptr_text == '"') ? json_parse_string(p_ptr_text) : NULL;
+            p_ptr_text = (NULL != p_ptr_text) ? json_skip_space(p_ptr_text) : NULL;
+            p_ptr_text = ((NULL != p_ptr_text) && (*p_ptr_text == ':')) ? (p_ptr_text + 1) : NULL;
+        }
+        p_ptr_text = (NULL != p_ptr_text) ? json_parse_value(p_ptr_text) : NULL;
+        p_ptr_text = (NULL != p_ptr_text) ? json_skip_space(p_ptr_text) : NULL;
+        if ((NULL != p_ptr_text) && (*p_ptr_text == close))
+        {
+            return p_ptr_text + 1;
+        }
+        p_ptr_text = ((NULL != p_ptr_text) && (*p_ptr_text == ',')) ? (p_ptr_text + 1) : NULL;
+    }
+    return NULL;
+}
+
+static bool is_json_valid(const char * p_ptr_text)
+{
+    const char * end_ptr = json_parse_value(p_ptr_text);
+    return ((NULL != end_ptr) && (*json_skip_space(end_ptr) == '\0'));
+}
+
+/**
+ * @brief Dumps the trace into s_json and reads the events back into s_events.
+ */
+static uint32_t dump_events(void)
+{
+    log_sink_t sink = {"json", json_sink_write, NULL, DBG_LVL_DEBUG, LOG_FORMAT_PLAIN, 0U};
+    trace_json_event_t * event_ptr = NULL;
+    uint32_t dumped_count = 0U;
+
+    s_json_len = 0U;
+    s_json[0] = '\0';
+    s_event_count = 0U;
+    dumped_count = debug_trace_dump(&sink);
+    HOST_CHECK(true == is_json_valid(s_json));
+
+    for (const char * line_ptr = strstr(s_json, "{\"name\":\""); (NULL != line_ptr) && (s_event_count <= TRACE_RING_DEPTH);
+         line_ptr = strstr(line_ptr + 1, "{\"name\":\""))
+    {
+        event_ptr = &s_events[s_event_count];
+        memset(event_ptr, 0, sizeof(*event_ptr));
+        if (5 == sscanf(line_ptr, "{\"name\":\"%63[^\"]\",\"ph\":\"%c\",\"ts\":%u,\"dur\":%u,\"pid\":0,\"tid\":%u}",
+                        event_ptr->name, &event_ptr->phase, &event_ptr->ts, &event_ptr->value, &event_ptr->tid) ||
+            5 == sscanf(line_ptr, "{\"name\":\"%63[^\"]\",\"ph\":\"%c\",\"s\":\"t\",\"ts\":%u,\"args\":{\"value\":%u},"
+                        "\"pid\":0,\"tid\":%u}",
+                        event_ptr->name, &event_ptr->phase, &event_ptr->ts, &event_ptr->value, &event_ptr->tid))
+        {
+            s_event_count++;
+        }
+    }
+    HOST_CHECK(dumped_count == s_event_count);
+    return dumped_count;
+}
+
+static void record_events(const char * p_ptr_span_name, const char * p_ptr_instant_name)
+{
+    while (false == s_is_started.load())
+    {
+        std::this_thread::yield();
+    }
+    for (uint32_t i = 0U; i < THREAD_EVENT_COUNT; i++)
+    {
+        TRACE_SCOPE(p_ptr_span_name);
+        TRACE_INSTANT(p_ptr_instant_name, i);
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Checks the events of one thread: each instant is followed by the span around it,
+ *        the instant values count up and the times do not go back.
+ */
+static void check_thread_events(const char * p_ptr_span_name, const char * p_ptr_instant_name)
+{
+    const trace_json_event_t * instant_ptr = NULL;
+    uint32_t next_value = 0U;
+    uint32_t last_ts = 0U;
+
+    for (uint32_t i = 0U; i < s_event_count; i++)
+    {
+        if (0 == strcmp(s_events[i].name, p_ptr_instant_name))
+        {
+            HOST_CHECK(NULL == instant_ptr && 'i' == s_events[i].phase && next_value == s_events[i].value);
+            HOST_CHECK(s_events[i].ts >= last_ts);
+            instant_ptr = &s_events[i];
+            last_ts = s_events[i].ts;
+            next_value++;
+        }
+        else if (0 == strcmp(s_events[i].name, p_ptr_span_name))
+        {
+            HOST_CHECK(NULL != instant_ptr && 'X' == s_events[i].phase);
+            HOST_CHECK(NULL != instant_ptr && s_events[i].ts <= instant_ptr->ts &&
+                       (s_events[i].ts + s_events[i].value) >= instant_ptr->ts);
+            instant_ptr = NULL;
+        }
+    }
+    HOST_CHECK(THREAD_EVENT_COUNT == next_value && NULL == instant_ptr);
+}
+
+/**
+ * @brief A full ring keeps the newest TRACE_RING_DEPTH events, a paused trace records nothing.
+ */
+static void check_full_ring(void)
+{
+    for (uint32_t i = 0U; i < (TRACE_RING_DEPTH + 10U); i++)
+    {
+        TRACE_INSTANT("ring", i);
+    }
+    debug_trace_enable(false);
+    TRACE_INSTANT("ring", 0U);
+    debug_trace_enable(true);
+
+    HOST_CHECK(TRACE_RING_DEPTH == dump_events());
+    for (uint32_t i = 0U; i < s_event_count; i++)
+    {
+        HOST_CHECK(0 == strcmp(s_events[i].name, "ring") && (i + 10U) == s_events[i].value);
+    }
+}
+
+/***************************************************************************************************
+* External function definitions.
+***************************************************************************************************/
+
+int main(void)
+{
+    debug_agents_init();
+
+    /* A quote would end the JSON string, it is replaced */
+    TRACE_INSTANT("quote\"name", 7U);
+    std::thread thread_a(record_events, "span_a", "instant_a");
+    std::thread thread_b(record_events, "span_b", "instant_b");
+    s_is_started.store(true);
+    thread_a.join();
+    thread_b.join();
+
+    HOST_CHECK((1U + (4U * THREAD_EVENT_COUNT)) == dump_events());
+    HOST_CHECK(0 == strcmp(s_events[0].name, "quote'name") && 7U == s_events[0].value);
+    check_thread_events("span_a", "instant_a");
+    check_thread_events("span_b", "instant_b");
+    for (uint32_t i = 0U; i < s_event_count; i++)
+    {
+        HOST_CHECK(0U == s_events[i].tid);
+    }
+
+    /* The checker itself must reject a broken dump */
+    HOST_CHECK(false == is_json_valid("{\"traceEvents\":[\n{\"name\":\"a\"},\n]}\n"));
+
+    check_full_ring();
+    debug_agents_flush();
+    return host_test_report("trace_dump_test");
+}
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""
+File Name: log_decoder.py
+Module: debug_logger
+Abstract: Host side decoder for the binary log records of the debug_logger module (LOG_BINARY_EN).
+
+The device only sends the address of the format string, the address of the function name,
+the core id, a sequence number, a timestamp and the raw arguments. The strings are read back
+from the firmware ELF file. A gap in the sequence numbers is reported as lost records.
+
+Usage:
+    log_decoder.py firmware.elf capture.bin       decode a captured byte stream
+    log_decoder.py firmware.elf -                 decode stdin
+    log_decoder.py firmware.elf --port /dev/ttyUSB0 [--baud 256000]   (needs pyserial)
+"""
+
+import argparse
+import math
+import re
+import struct
+import sys
+
+LOG_BIN_SYNC = 0xA5
+# sync, length, level, argument count, core id, sequence, format address, function address,
+# timestamp in us since boot (64 bits, it does not wrap)
+LOG_BIN_HEADER_FORMAT = "<BBBBBIIIQ"
+LOG_BIN_HEADER_LEN = struct.calcsize(LOG_BIN_HEADER_FORMAT)
+SEQUENCE_MASK = 0xFFFFFFFF
+
+# Argument type byte and the struct format of its value
+ARG_FORMATS = {"i": "<i", "u": "<I", "I": "<q", "U": "<Q", "f": "<f"}
+
+LOST_FORMAT = "\033[0;33m[ WARN]\033[0m\t%d records lost\n"
+
+LEVEL_PREFIX = [
+    "",
+    "\033[0;31m[ERROR]\033[0m\t",
+    "\033[0;33m[ WARN]\033[0m\t",
+    "\033[0;32m[ INFO]\033[0m\t",
+    "\033[0;35m[PRDIC]\033[0m\t",
+    "\033[0;36m[DEBUG]\033[0m\t",
+]
+
+# Limits of the device rendering, see debug_logger.h and string_util.h
+FMT_MAX_WIDTH = 64
+FTOA_MAX_DECIMALS = 9
+FTOA_FIXED_LIMIT = 2.0 ** 64
+FLOAT_INT64_LIMIT = 2.0 ** 63
+INT64_MAX = 0x7FFFFFFFFFFFFFFF
+INT64_MIN = -0x8000000000000000
+UINT64_MASK = 0xFFFFFFFFFFFFFFFF
+UINT32_MASK = 0xFFFFFFFF
+
+FORMAT_SPEC = re.compile(r"%([-+ 0#]*)(\d*)(?:\.(\d+))?([dfx])")
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class ElfStrings:
+    """Looks up NUL terminated strings by their run-time address in the loadable ELF sections."""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf_file:
+            data = elf_file.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+        is_64 = data[4] == 2
+        endian = "<" if data[5] == 1 else ">"
+        if is_64:
+            shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", data, 0x3A)
+            section_fmt = endian + "IIQQQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", data, 0x2E)
+            section_fmt = endian + "IIIIII"
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(section_fmt, data, shoff + i * shentsize)
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def get(self, address):
+        if address == 0:
+            return None
+        for base, content in self.sections:
+            if base <= address < base + len(content):
+                start = address - base
+                end = content.find(b"\0", start)
+                if end < 0:
+                    end = len(content)
+                return content[start:end].decode("utf-8", "replace")
+        return "<unknown string 0x%08x>" % address
+
+
+def format_float(value, decimals):
+    """Mirrors string_dtoa(): fixed notation below 2^64, scientific above, nan and inf as text."""
+    if math.isnan(value):
+        return "nan"
+    sign = "-" if math.copysign(1.0, value) < 0 else ""
+    magnitude = abs(value)
+    if math.isinf(magnitude):
+        return sign + "inf"
+    if magnitude >= FTOA_FIXED_LIMIT:
+        return sign + "%.*e" % (decimals, magnitude)
+    return sign + "%.*f" % (decimals, magnitude)
+
+
+def format_value(arg_type, value, conversion, decimals):
+    """Mirrors log_format_value() of the device, it never raises for any argument value."""
+    if conversion != "f" and arg_type == "f" and not math.isfinite(value):
+        return format_float(value, 0)
+    if conversion == "f":
+        # Integers go through double on the device too
+        return format_float(float(value), decimals)
+
+    is_negative = value < 0
+    if arg_type == "f":
+        # Truncated toward zero and clamped to the int64_t range
+        if value >= FLOAT_INT64_LIMIT:
+            magnitude = INT64_MAX
+        elif value <= -FLOAT_INT64_LIMIT:
+            magnitude = INT64_MIN & UINT64_MASK
+        else:
+            magnitude = int(value) & UINT64_MASK
+    else:
+        magnitude = int(value) & UINT64_MASK
+
+    if conversion == "x":
+        # Negative 32-bit values are printed as their 32-bit two's complement
+        if is_negative and arg_type != "I":
+            magnitude &= UINT32_MASK
+        return "%x" % magnitude
+    if is_negative and magnitude > INT64_MAX:
+        return "%d" % (magnitude - UINT64_MASK - 1)
+    return "%d" % magnitude
+
+
+def format_arg(spec, arg_type, value):
+    """Mirrors log_format_arg(): the value is padded for its flags and width."""
+    flags, width, precision, conversion = spec.groups()
+    width = min(int(width or 0), FMT_MAX_WIDTH)
+    decimals = 3 if precision is None else min(int(precision), FTOA_MAX_DECIMALS)
+    digits = format_value(arg_type, value, conversion, decimals)
+
+    sign = ""
+    if digits.startswith("-"):
+        sign = "-"
+        digits = digits[1:]
+    elif "+" in flags:
+        sign = "+"
+    elif " " in flags:
+        sign = " "
+    prefix = "0x" if ("#" in flags and conversion == "x") else ""
+    pad = max(width - len(sign) - len(prefix) - len(digits), 0)
+    if "-" in flags:
+        # Left justification wins over zero padding
+        return sign + prefix + digits + " " * pad
+    if "0" in flags:
+        return sign + prefix + "0" * pad + digits
+    return " " * pad + sign + prefix + digits
+
+
+def render(strings, level, core_id, sequence, fmt_adrs, func_adrs, timestamp_us, args):
+    fmt = strings.get(fmt_adrs) or ""
+    func_name = strings.get(func_adrs)
+    arg_iter = iter(args)
+
+    def substitute(match):
+        try:
+            arg_type, value = next(arg_iter)
+        except StopIteration:
+            return match.group(0)
+        return format_arg(match, arg_type, value)
+
+    leading_newline = ""
+    if fmt.startswith("\n"):
+        leading_newline = "\n"
+        fmt = fmt[1:]
+    if not fmt:
+        # A bare newline has no prefix on the device either
+        return leading_newline
+    text = FORMAT_SPEC.sub(substitute, fmt)
+    prefix = "[%d.%06d %d#%d] " % (timestamp_us // 1000000, timestamp_us % 1000000, core_id, sequence)
+    if level < len(LEVEL_PREFIX):
+        prefix += LEVEL_PREFIX[level]
+    if func_name is not None:
+        prefix += "\033[1m[FUNC: %s]\033[0m ->" % func_name
+    return leading_newline + prefix + text
+
+
+def parse_args(record, arg_count):
+    """Returns the typed arguments of a record, None if the record is malformed."""
+    args = []
+    offset = LOG_BIN_HEADER_LEN
+    for _ in range(arg_count):
+        if offset >= len(record):
+            return None
+        arg_type = chr(record[offset])
+        arg_format = ARG_FORMATS.get(arg_type)
+        if arg_format is None or offset + 1 + struct.calcsize(arg_format) > len(record):
+            return None
+        args.append((arg_type, struct.unpack_from(arg_format, record, offset + 1)[0]))
+        offset += 1 + struct.calcsize(arg_format)
+    return args if offset == len(record) else None
+
+
+class SequenceTracker:
+    """Counts the records missing between two sequence numbers. The two cores number their records
+    before they enter the queue, so a record may arrive right after a later one. It was already
+    counted as lost then, the count is only exact when the records come in order."""
+
+    def __init__(self):
+        self.expected = None
+
+    def lost(self, sequence):
+        lost = 0
+        if self.expected is not None:
+            gap = (sequence - self.expected) & SEQUENCE_MASK
+            if gap > SEQUENCE_MASK // 2:
+                # Late record, it does not move the expected number back
+                return 0
+            lost = gap
+        self.expected = (sequence + 1) & SEQUENCE_MASK
+        return lost
+
+
+def decode_stream(strings, read_chunk, write):
+    buffer = bytearray()
+    sequences = SequenceTracker()
+    while True:
+        chunk = read_chunk()
+        if not chunk:
+            break
+        buffer += chunk
+        while True:
+            sync_idx = buffer.find(bytes([LOG_BIN_SYNC]))
+            if sync_idx < 0:
+                buffer.clear()
+                break
+            del buffer[:sync_idx]
+            if len(buffer) < LOG_BIN_HEADER_LEN:
+                break
+            length, level, arg_count = buffer[1], buffer[2], buffer[3]
+            if length < LOG_BIN_HEADER_LEN or level >= len(LEVEL_PREFIX):
+                # Not a record header, resynchronize on the next sync byte
+                del buffer[:1]
+                continue
+            if len(buffer) < length:
+                break
+            args = parse_args(bytes(buffer[:length]), arg_count)
+            if args is None:
+                del buffer[:1]
+                continue
+            _, _, _, _, core_id, sequence, fmt_adrs, func_adrs, timestamp_us = \
+                struct.unpack_from(LOG_BIN_HEADER_FORMAT, buffer, 0)
+            lost = sequences.lost(sequence)
+            if lost > 0:
+                write(LOST_FORMAT % lost)
+            write(render(strings, level, core_id, sequence, fmt_adrs, func_adrs, timestamp_us, args))
+            del buffer[:length]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode binary debug_logger records.")
+    parser.add_argument("elf", help="firmware ELF file the records were produced by")
+    parser.add_argument("capture", nargs="?", default="-", help="captured byte stream, '-' for stdin")
+    parser.add_argument("--port", help="read from a serial port instead of a capture")
+    parser.add_argument("--baud", type=int, default=256000)
+    options = parser.parse_args()
+
+    strings = ElfStrings(options.elf)
+    write = sys.stdout.write
+    if options.port:
+        import serial
+        with serial.Serial(options.port, options.baud, timeout=0.1) as port:
+            # An empty read is a timeout here, keep waiting for data
+            decode_stream(strings, lambda: port.read(256) or b"\0", lambda text: (write(text), sys.stdout.flush()))
+    elif options.capture == "-":
+        decode_stream(strings, lambda: sys.stdin.buffer.read1(4096), write)
+    else:
+        with open(options.capture, "rb") as capture_file:
+            decode_stream(strings, lambda: capture_file.read(4096), write)
+
+
+if __name__ == "__main__":
+    main()